@@ -21,6 +21,7 @@
 #include "scales.h"
 #include "global.h"
 #include "aeolus.h"
+#include "libmscore/trace.h"
 
 #define VERSION "0.0.0"
 
@@ -82,6 +83,18 @@ Model::Model (Aeolus* a,
       memset (_preset, 0, NBANK * NPRES * sizeof (Preset *));
       }
 
+//---------------------------------------------------------
+//   ~Model
+//---------------------------------------------------------
+
+Model::~Model()
+      {
+      for (int d = 0; d < _ndivis; d++) {
+            for (int r = 0; r < Divis::NRANK; r++)
+                  _divis[d]._ranks[r]._job.waitForFinished();
+            }
+      }
+
 //---------------------------------------------------------
 //   init
 //---------------------------------------------------------
@@ -106,7 +119,6 @@ void Model::init()
 
       init_iface();
       init_ranks(MT_LOAD_RANK);
-      init_ranks(MT_SAVE_RANK);
       }
 
 //---------------------------------------------------------
@@ -156,6 +168,13 @@ void Model::init_iface()
       set_mconf (0, _chconf[0]._bits);
       }
 
+//---------------------------------------------------------
+//   init_ranks
+//    the waveforms are loaded or generated in the global
+//    thread pool; the organ is ready to play right away,
+//    every rank sounds as soon as its waveforms are ready
+//---------------------------------------------------------
+
 void Model::init_ranks (int comm)
       {
       _count++;
@@ -178,6 +197,8 @@ void Model::proc_rank (int g, int i, int comm)
             int d = (I->_action0 >> 16) & 255;
             int r = (I->_action0 >>  8) & 255;
             Rank* R = _divis [d]._ranks + r;
+            // the previous waveforms are replaced or saved below
+            R->_job.waitForFinished();
             if (comm == MT_SAVE_RANK) {
                   if (R->_wave->modif ()) {
                         R->_wave->save(_waves, R->_sdef, _aeolus->_fsamp,
@@ -186,30 +207,45 @@ void Model::proc_rank (int g, int i, int comm)
                   }
             else if (R->_count != _count) {
                   R->_count = _count;
-                  M_def_rank M(comm);
-                  M._divis = d;
-                  M._rank  = r;
-                  M._group = g;
-                  M._ifelm = i;
-                  M._fsamp = _aeolus->_fsamp;
-                  M._fbase = _fbase;
-                  M._scale = scales [_itemp]._data;
-                  M._sdef  = R->_sdef;
-                  M._wave  = R->_wave;
-                  M._path  = _waves;
-
-//WS                  send_event(TO_IFACE, new M_ifc_ifelm (MT_IFC_ELATT, M._group, M._ifelm));
-
-                  M._wave = new Rankwave (M._sdef->_n0, M._sdef->_n1);
-                  if (M._wave->load (M._path, M._sdef, M._fsamp, M._fbase, M._scale))
-                        M._wave->gen_waves (M._sdef, M._fsamp, M._fbase, M._scale);
-
-                  _aeolus->_divisp [M._divis]->set_rank (M._rank, M._wave,  M._sdef->_pan, M._sdef->_del);
-                  _divis [M._divis]._ranks [M._rank]._wave = M._wave;
+
+//WS                  send_event(TO_IFACE, new M_ifc_ifelm (MT_IFC_ELATT, g, i));
+
+                  Addsynth* D = R->_sdef;
+                  Rankwave* W = new Rankwave (D->_n0, D->_n1);
+                  _aeolus->_divisp [d]->set_rank (r, W, D->_pan, D->_del);
+                  R->_wave = W;
+
+                  const char* path = _waves;
+                  float fsamp      = _aeolus->_fsamp;
+                  float fbase      = _fbase;
+                  float* scale     = scales [_itemp]._data;
+                  bool save        = comm == MT_LOAD_RANK;
+                  R->_job = QtConcurrent::run([W, D, path, fsamp, fbase, scale, save]() {
+                        load_rank(W, D, path, fsamp, fbase, scale, save);
+                        });
                   }
             }
       }
 
+//---------------------------------------------------------
+//   load_rank
+//    load the waveforms of a rank from its .ae1 file or
+//    generate them; runs in a worker thread. Only the
+//    ranks generated on the initial load are saved, not
+//    the retuned or recalculated ones.
+//---------------------------------------------------------
+
+void Model::load_rank(Rankwave* W, Addsynth* D, const char* path, float fsamp, float fbase, float* scale, bool save)
+      {
+      TRACE_SPAN("aeolusRank", "synth");
+      if (W->load (path, D, fsamp, fbase, scale)) {
+            W->gen_waves (D, fsamp, fbase, scale);
+            if (save)
+                  W->save (path, D, fsamp, fbase, scale);
+            }
+      W->set_ready ();
+      }
+
 //---------------------------------------------------------
 //   set_ifelm
 //    Set, reset or toggle a stop.
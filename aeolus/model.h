@@ -45,6 +45,7 @@ public:
     int         _count;
     Addsynth   *_sdef;
     Rankwave   *_wave;
+    QFuture<void> _job;     // loads or generates _wave
 };
 
 
@@ -170,6 +171,7 @@ class Model
       void init_iface();
       void init_ranks(int comm);
       void proc_rank(int g, int i, int comm);
+      static void load_rank(Rankwave* W, Addsynth* D, const char* path, float fsamp, float fbase, float* scale, bool save);
       void set_mconf(int i, uint16_t *d);
       void get_state(uint32_t *bits);
       void set_state(int bank, int pres);
@@ -191,7 +193,7 @@ class Model
       Model (Aeolus* aeolus, uint16_t* midimap, const char* stops,
          const char* instr, const char* waves);
 
-      virtual ~Model() {}
+      virtual ~Model();
 
       void set_ifelm (int g, int i, int m);
       void clr_group (int g);
@@ -24,18 +24,6 @@ extern float exp2ap (float);
 
 
 Rngen   Pipewave::_rgen;
-float  *Pipewave::_arg = 0;
-float  *Pipewave::_att = 0;
-
-void Pipewave::initstatic(float fsamp)
-      {
-      if (_arg)
-            return;
-      int k = (int)(fsamp);
-      _arg  = new float [k];
-      k     = (int)(0.5f * fsamp);
-      _att  = new float [k];
-      }
 
 //---------------------------------------------------------
 //   play
@@ -183,7 +171,14 @@ void Pipewave::play()
 }
 
 
-void Pipewave::genwave (Addsynth *D, int n, float fsamp, float fpipe)
+//---------------------------------------------------------
+//   genwave
+//    arg and att are scratch buffers of fsamp and fsamp/2
+//    samples; rgen, arg and att are owned by the calling
+//    thread, so ranks can be generated in parallel
+//---------------------------------------------------------
+
+void Pipewave::genwave (Addsynth *D, int n, float fsamp, float fpipe, Rngen& rgen, float *arg, float *att)
 {
     int    h, i, k, nc;
     float  f0, f1, f, m, t, v, v0;
@@ -197,7 +192,7 @@ void Pipewave::genwave (Addsynth *D, int n, float fsamp, float fpipe)
     _l0 = (int)(fsamp * m + 0.5);
     _l0 = (_l0 + PERIOD - 1) & ~(PERIOD - 1);
 
-    f1 = (fpipe + D->_n_off.vi (n) + D->_n_ran.vi (n) * (2 * _rgen.urand () - 1)) / fsamp;
+    f1 = (fpipe + D->_n_off.vi (n) + D->_n_ran.vi (n) * (2 * rgen.urand () - 1)) / fsamp;
     f0 = f1 * exp2ap (D->_n_atd.vi (n) / 1200.0f);
 
     for (h = N_HARM - 1; h >= 0; h--)
@@ -234,14 +229,14 @@ void Pipewave::genwave (Addsynth *D, int n, float fsamp, float fpipe)
     k = (int)(fsamp * D->_n_att.vi (n) + 0.5);
     for (i = 0; i <= _l0; i++)
     {
-        _arg [i] = t - floorf (t + 0.5);
+        arg [i] = t - floorf (t + 0.5);
 	t += (i < k) ? (((k - i) * f0 + i * f1) / k) : f1;
     }
 
     for (i = 1; i < _l1; i++)
     {
-	t = _arg [_l0]+ (float) i * nc / _l1;
-        _arg [i + _l0] = t - floorf (t + 0.5);
+	t = arg [_l0]+ (float) i * nc / _l1;
+        arg [i + _l0] = t - floorf (t + 0.5);
     }
 
     v0 = exp2ap (0.1661 * D->_n_vol.vi (n));
@@ -251,16 +246,16 @@ void Pipewave::genwave (Addsynth *D, int n, float fsamp, float fpipe)
         v = D->_h_lev.vi (h, n);
         if (v < -80.0) continue;
 
-        v = v0 * exp2ap (0.1661 * (v + D->_h_ran.vi (h, n) * (2 * _rgen.urand () - 1)));
+        v = v0 * exp2ap (0.1661 * (v + D->_h_ran.vi (h, n) * (2 * rgen.urand () - 1)));
         k = (int)(fsamp * D->_h_att.vi (h, n) + 0.5);
-        attgain (k, D->_h_atp.vi (h, n));
+        attgain (k, D->_h_atp.vi (h, n), att);
 
         for (i = 0; i < _l0 + _l1; i++)
         {
-	    t = _arg [i] * (h + 1);
+	    t = arg [i] * (h + 1);
             t -= floorf (t);
             m = v * sinf (2 * M_PI * t);
-            if (i < k) m *= _att [i];
+            if (i < k) m *= att [i];
             _p0 [i] += m;
         }
     }
@@ -311,7 +306,7 @@ void Pipewave::looplen (float f, float fsamp, int lmax, int *aa, int *bb)
 }
 
 
-void Pipewave::attgain (int n, float p)
+void Pipewave::attgain (int n, float p, float *att)
 {
     int    i, j, k;
     float  d, m, w, x, y, z;
@@ -331,14 +326,14 @@ void Pipewave::attgain (int n, float p)
         while (j < k)
 	{
             m = (double) j / n;
-            _att [j++] = (1.0 - m) * z + m;
+            att [j++] = (1.0 - m) * z + m;
             z += d;
 	}
     }
 }
 
 
-void Pipewave::save (FILE *F)
+void Pipewave::save (QIODevice *F)
 {
     int  k;
     union
@@ -353,17 +348,24 @@ void Pipewave::save (FILE *F)
     d.i16 [4] = _k_s;
     d.i16 [5] = _k_r;
     d.flt [3] = _m_r;
-    d.i32 [4] = 0;
-    d.i32 [5] = 0;
+    d.flt [4] = _d_r;
+    d.flt [5] = _d_p;
     d.i32 [6] = 0;
     d.i32 [7] = 0;
-    fwrite (&d, 1, 32, F);
+    F->write ((const char *) &d, 32);
     k = _l0 +_l1 + _k_s * (PERIOD + 4);
-    fwrite (_p0, k, sizeof (float), F);
+    F->write ((const char *) _p0, k * sizeof (float));
 }
 
 
-void Pipewave::load (FILE *F)
+//---------------------------------------------------------
+//   load
+//    point the pipe into the mapped file at p and advance
+//    p; the wave data is only read by play(). Files written
+//    before _d_r and _d_p were saved have 0 there.
+//---------------------------------------------------------
+
+bool Pipewave::load (const char *&p, const char *end)
 {
     int  k;
     union
@@ -373,24 +375,32 @@ void Pipewave::load (FILE *F)
 	float   flt [8];
     } d;
 
-    fread (&d, 1, 32, F);
+    if (end - p < 32) return false;
+    memcpy (&d, p, 32);
+    p += 32;
     _l0  = d.i32 [0];
     _l1  = d.i32 [1];
     _k_s = d.i16 [4];
     _k_r = d.i16 [5];
     _m_r = d.flt [3];
+    _d_r = d.flt [4];
+    _d_p = d.flt [5];
+    if (_l0 < 0 || _l1 <= 0 || _k_s <= 0) return false;
     k = _l0 +_l1 + _k_s * (PERIOD + 4);
-    delete[] _p0;
-    _p0 = new float [k];
+    if ((end - p) / (qint64) sizeof (float) < k) return false;
+    if (! _mapped) delete[] _p0;
+    _p0 = (float *) p;
+    _mapped = true;
     _p1 = _p0 + _l0;
     _p2 = _p1 + _l1;
-    fread (_p0, k, sizeof (float), F);
+    p += k * sizeof (float);
+    return true;
 }
 
 
 
 
-Rankwave::Rankwave (int n0, int n1) : _n0 (n0), _n1 (n1), _list (0), _modif (false)
+Rankwave::Rankwave (int n0, int n1) : _n0 (n0), _n1 (n1), _list (0), _modif (false), _ready (false), _file (0)
 {
     _pipes = new Pipewave [n1 - n0 + 1];
 }
@@ -399,18 +409,29 @@ Rankwave::Rankwave (int n0, int n1) : _n0 (n0), _n1 (n1), _list (0), _modif (fal
 Rankwave::~Rankwave (void)
 {
     delete[] _pipes;
+    delete _file;
 }
 
 
 void Rankwave::gen_waves (Addsynth *D, float fsamp, float fbase, float *scale)
 {
-    Pipewave::initstatic (fsamp);
+    // seeded from the rank only (FNV-1a of its file name), so
+    // every synthesis of a rank gives the same waves
+    uint32_t seed = 2166136261u;
+    for (const char *p = D->_filename; p < D->_filename + sizeof (D->_filename) && *p; p++)
+	seed = (seed ^ (unsigned char)(*p)) * 16777619u;
+    Rngen rgen;
+    rgen.init (seed);
+    float *arg = new float [(int)(fsamp)];
+    float *att = new float [(int)(0.5f * fsamp)];
 
     fbase *=  D->_fn / (D->_fd * scale [9]);
     for (int i = _n0; i <= _n1; i++)
     {
-	_pipes [i - _n0].genwave (D, i - _n0, fsamp, ldexpf (fbase * scale [i % 12], i / 12 - 5));
+	_pipes [i - _n0].genwave (D, i - _n0, fsamp, ldexpf (fbase * scale [i % 12], i / 12 - 5), rgen, arg, att);
     }
+    delete[] arg;
+    delete[] att;
     _modif = true;
 }
 
@@ -436,6 +457,8 @@ void Rankwave::play (int shift)
 {
     Pipewave *P, *Q;
 
+    if (! ready ()) return;
+
     for (P = 0, Q = _list; Q; Q = Q->_link)
     {
 	Q->play ();
@@ -450,9 +473,15 @@ void Rankwave::play (int shift)
 }
 
 
+//---------------------------------------------------------
+//   save
+//    written to a temporary file which replaces the .ae1
+//    file on commit, so a concurrent or interrupted save
+//    never leaves a truncated file
+//---------------------------------------------------------
+
 int Rankwave::save (const char *path, Addsynth *D, float fsamp, float fbase, float *scale)
 {
-    FILE      *F;
     Pipewave  *P;
     int        i;
     char       name [1024];
@@ -463,8 +492,8 @@ int Rankwave::save (const char *path, Addsynth *D, float fsamp, float fbase, flo
     if ((p = strrchr (name, '.'))) strcpy (p, ".ae1");
     else strcat (name, ".ae1");
 
-    F = fopen (name, "wb");
-    if (F == NULL)
+    QSaveFile F (QString::fromLocal8Bit (name));
+    if (! F.open (QIODevice::WriteOnly))
     {
 	fprintf (stderr, "Can't open waveform file '%s' for writing\n", name);
         return 1;
@@ -473,7 +502,7 @@ int Rankwave::save (const char *path, Addsynth *D, float fsamp, float fbase, flo
     memset (data, 0, 16);
     strcpy (data, "ae1");
     data [4] = 1;
-    fwrite (data, 1, 16, F);
+    F.write (data, 16);
 
     memset (data, 0, 64);
     data [0] = 0;
@@ -487,20 +516,31 @@ int Rankwave::save (const char *path, Addsynth *D, float fsamp, float fbase, flo
     *((float *)(data +  8)) = fsamp;
     *((float *)(data + 12)) = fbase;
     memcpy (data + 16, scale, 12 * sizeof (float));
-    fwrite (data, 1, 64, F);
+    F.write (data, 64);
 
-    for (i = _n0, P = _pipes; i <= _n1; i++, P++) P->save (F);
+    for (i = _n0, P = _pipes; i <= _n1; i++, P++) P->save (&F);
 
-    fclose (F);
+    if (! F.commit ())
+    {
+	fprintf (stderr, "Can't write waveform file '%s'\n", name);
+        return 1;
+    }
 
     _modif = false;
     return 0;
 }
 
 
+//---------------------------------------------------------
+//   load
+//    map the .ae1 file; the pipes play directly from the
+//    mapping, which is shared with the page cache. All
+//    pages are touched here, so the audio thread does
+//    not fault them in.
+//---------------------------------------------------------
+
 int Rankwave::load (const char *path, Addsynth *D, float fsamp, float fbase, float *scale)
 {
-    FILE      *F;
     Pipewave  *P;
     int        i;
     char       name [1024];
@@ -512,22 +552,34 @@ int Rankwave::load (const char *path, Addsynth *D, float fsamp, float fbase, flo
     if ((p = strrchr (name, '.'))) strcpy (p, ".ae1");
     else strcat (name, ".ae1");
 
-    F = fopen (name, "rb");
-    if (F == NULL)
+    QFile *F = new QFile (QString::fromLocal8Bit (name));
+    if (! F->open (QIODevice::ReadOnly))
     {
 #ifdef DEBUG
 	fprintf (stderr, "Can't open waveform file '%s' for reading\n", name);
 #endif
+        delete F;
+        return 1;
+    }
+    qint64 size = F->size ();
+    const char *map = size >= 80 ? (const char *) F->map (0, size) : 0;
+    if (map == 0)
+    {
+#ifdef DEBUG
+	fprintf (stderr, "File '%s' can not be mapped\n", name);
+#endif
+        delete F;
         return 1;
     }
 
-    fread (data, 1, 16, F);
+    memcpy (data, map, 16);
+    data [15] = 0;
     if (strcmp (data, "ae1"))
     {
 #ifdef DEBUG
 	fprintf (stderr, "File '%s' is not an Aeolus waveform file\n", name);
 #endif
-        fclose (F);
+        delete F;
         return 1;
     }
 
@@ -536,17 +588,17 @@ int Rankwave::load (const char *path, Addsynth *D, float fsamp, float fbase, flo
 #ifdef DEBUG
 	fprintf (stderr, "File '%s' has an incompatible version tag (%d)\n", name, data [4]);
 #endif
-        fclose (F);
+        delete F;
         return 1;
     }
 
-    fread (data, 1, 64, F);
+    memcpy (data, map + 16, 64);
     if (_n0 != data [4] || _n1 != data [5])
     {
 #ifdef DEBUG
 	fprintf (stderr, "File '%s' has an incompatible note range (%d %d), (%d %d)\n", name, _n0, _n1, data [4], data [5]);
 #endif
-        fclose (F);
+        delete F;
         return 1;
     }
 
@@ -556,7 +608,7 @@ int Rankwave::load (const char *path, Addsynth *D, float fsamp, float fbase, flo
 #ifdef DEBUG
 	fprintf (stderr, "File '%s' has a different sample frequency (%3.1lf)\n", name, f);
 #endif
-        fclose (F);
+        delete F;
         return 1;
     }
 
@@ -566,7 +618,7 @@ int Rankwave::load (const char *path, Addsynth *D, float fsamp, float fbase, flo
 #ifdef DEBUG
 	fprintf (stderr, "File '%s' has a different tuning (%3.1lf)\n", name, f);
 #endif
-        fclose (F);
+        delete F;
         return 1;
     }
 
@@ -578,15 +630,34 @@ int Rankwave::load (const char *path, Addsynth *D, float fsamp, float fbase, flo
 #ifdef DEBUG
 	    fprintf (stderr, "File '%s' has a different temperament\n", name);
 #endif
-            fclose (F);
+            delete F;
             return 1;
         }
     }
 
-    for (i = _n0, P = _pipes; i <= _n1; i++, P++) P->load (F);
+    const char *q   = map + 80;
+    const char *end = map + size;
+    for (i = _n0, P = _pipes; i <= _n1; i++, P++)
+    {
+        if (! P->load (q, end))
+        {
+#ifdef DEBUG
+	    fprintf (stderr, "File '%s' is truncated\n", name);
+#endif
+            for (P = _pipes; P <= _pipes + (_n1 - _n0); P++)
+            {
+                if (P->_mapped) { P->_p0 = 0; P->_mapped = false; }
+            }
+            delete F;
+            return 1;
+        }
+    }
 
-    fclose (F);
+    volatile char touch = 0;
+    for (qint64 k = 0; k < size; k += 4096) touch += map [k];
 
+    delete _file;
+    _file = F;
     _modif = false;
     return 0;
 }
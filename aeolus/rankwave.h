@@ -24,6 +24,8 @@
 #include "addsynth.h"
 #include "rngen.h"
 
+#include <atomic>
+
 
 #define PERIOD 64
 
@@ -34,21 +36,22 @@ private:
 
     Pipewave () :
         _p0 (0), _p1 (0), _p2 (0), _l1 (0), _k_s (0),  _k_r (0), _m_r (0),
+        _d_r (0), _d_p (0), _mapped (false),
         _link (0), _sbit (0), _sdel (0),
         _p_p (0), _y_p (0), _z_p (0), _p_r (0), _y_r (0), _g_r (0), _i_r (0)
     {}
 
-    ~Pipewave (void) { delete[] _p0; }
+    ~Pipewave (void) { if (! _mapped) delete[] _p0; }
 
     friend class Rankwave;
 
-    void genwave (Addsynth *D, int n, float fsamp, float fpipe);
-    void save (FILE *F);
-    void load (FILE *F);
+    void genwave (Addsynth *D, int n, float fsamp, float fpipe, Rngen& rgen, float *arg, float *att);
+    void save (QIODevice *F);
+    bool load (const char *&p, const char *end);
     void play (void);
 
     static void looplen (float f, float fsamp, int lmax, int *aa, int *bb);
-    static void attgain (int n, float p);
+    static void attgain (int n, float p, float *att);
 
     float     *_p0;    // attack start
     float     *_p1;    // loop start
@@ -60,6 +63,7 @@ private:
     float      _m_r;   // release multiplier
     float      _d_r;   // release detune
     float      _d_p;   // instability
+    bool       _mapped; // _p0 points into the mapped .ae1 file
 
     Pipewave  *_link;  // link to next in active chain
     uint32_t   _sbit;  // on state bit
@@ -74,15 +78,14 @@ private:
     int16_t    _i_r;   // release count
 
 
-    static void initstatic (float fsamp);
-
-    static   Rngen   _rgen;
-    static   float  *_arg;
-    static   float  *_att;
+    static   Rngen   _rgen;   // used by play() in the audio thread only
 };
 
 //---------------------------------------------------------
 //   Rankwave
+//    The waveforms are loaded or generated by a worker
+//    thread after the rank is installed in its division;
+//    until then the rank is silent and ignores notes.
 //---------------------------------------------------------
 
 class Rankwave
@@ -96,6 +99,8 @@ class Rankwave
       Pipewave   *_list;
       Pipewave   *_pipes;
       bool        _modif;
+      std::atomic<bool> _ready;
+      QFile      *_file;            // mapped .ae1 file
 
 public:
 
@@ -103,6 +108,8 @@ public:
       ~Rankwave ();
 
       void note_on (int n) {
+            if (! ready ())
+                  return;
             if ((n < _n0) || (n > _n1)) {
                   qDebug("Rankwave: bad key");
                   return;
@@ -138,6 +145,8 @@ public:
     int  save (const char *path, Addsynth *D, float fsamp, float fbase, float *scale);
     int  load (const char *path, Addsynth *D, float fsamp, float fbase, float *scale);
     bool modif (void) const { return _modif; }
+    bool ready (void) const { return _ready.load (std::memory_order_acquire); }
+    void set_ready (void) { _ready.store (true, std::memory_order_release); }
 
     int  _cmask;  // used by division logic
     int  _nmask;  // used by division logic
@@ -21,9 +21,13 @@
 #include "fluid.h"
 #include "voice.h"
 #include "sfont.h"
+#include "dspkernels.h"
 
 namespace FluidS {
 
+// shortest run of samples for the vector kernels
+static const unsigned MIN_RUN = 8;
+
 /* Purpose:
  *
  * Interpolates audio data (obtains values between the samples of the original
@@ -72,6 +76,31 @@ inline bool Voice::updateAmpInc(unsigned int &nextNewAmpInc, std::map<int, qreal
       }
 
 
+//---------------------------------------------------------
+//   runLength
+//    number of samples from dsp_i which can be rendered
+//    by the kernels in one go: updateAmpInc() does
+//    nothing for them and the phase index stays at or
+//    below lastIndex
+//---------------------------------------------------------
+
+static unsigned runLength(unsigned dsp_i, unsigned n, unsigned nextNewAmpInc, int positionToTurnOff,
+   Phase phase, Phase incr, unsigned lastIndex)
+      {
+      unsigned last = qMin(n, nextNewAmpInc);
+      if (positionToTurnOff > 0)
+            last = qMin(last, unsigned(positionToTurnOff));
+      int lastIdx = int(lastIndex);
+      if (last <= dsp_i || lastIdx < phase.index())
+            return 0;
+      qint64 count = last - dsp_i;
+      if (incr.data > 0) {
+            qint64 limit = (qint64(lastIdx) + 1) << 32;
+            count = qMin(count, (limit - phase.data + incr.data - 1) / incr.data);
+            }
+      return unsigned(count);
+      }
+
 /* Interpolation (find a value between two samples of the original waveform) */
 
 /* Linear interpolation table (2 coefficients centered on 1st) */
@@ -130,6 +159,7 @@ void Voice::dsp_float_config()
                   }
             }
       fluid_check_fpe("interpolation table calculation");
+      DspKernels::best();     // select the kernels before the audio thread needs them
       }
 
 //-------------------------------------------------------------------
@@ -305,6 +335,7 @@ int Voice::dsp_float_interpolate_linear(unsigned n)
 
 int Voice::dsp_float_interpolate_4th_order(unsigned n)
       {
+      const DspKernels& kernels = DspKernels::best();
       Phase dsp_phase_incr; // end_phase;
       short int* dsp_data = sample->data;
       auto curSample2AmpInc = Sample2AmpInc.begin();
@@ -366,7 +397,22 @@ int Voice::dsp_float_interpolate_4th_order(unsigned n)
                   }
 
             /* interpolate the sequence of sample points */
-            for ( ; dsp_i < n && dsp_phase_index <= end_index; dsp_i++) {
+            while (dsp_i < n && dsp_phase_index <= end_index) {
+                  /* runs without amplitude segment change go to the vector kernels;
+                   * they read one point more than the loop below */
+                  unsigned run = (amp != 0.0 || dsp_amp_incr != 0.0)
+                     ? runLength(dsp_i, n, nextNewAmpInc, positionToTurnOff, phase, dsp_phase_incr, end_index - 1)
+                     : 0;
+                  if (run >= MIN_RUN) {
+                        kernels.interpolate4(dsp_buf + dsp_i, run, dsp_data, phase.data, dsp_phase_incr.data,
+                           amp, dsp_amp_incr, interp_coeff);
+                        phase.data     += run * dsp_phase_incr.data;
+                        amp            += run * dsp_amp_incr;
+                        dsp_i          += run;
+                        dsp_phase_index = phase.index();
+                        continue;
+                        }
+
                   coeffs = interp_coeff[fluid_phase_fract_to_tablerow (phase)];
                   dsp_buf[dsp_i] = amp * (coeffs[0] * dsp_data[dsp_phase_index-1]
 				  + coeffs[1] * dsp_data[dsp_phase_index]
@@ -379,6 +425,7 @@ int Voice::dsp_float_interpolate_4th_order(unsigned n)
                   if (!updateAmpInc(nextNewAmpInc, curSample2AmpInc, dsp_amp_incr, dsp_i))
                         return dsp_i;
                   amp += dsp_amp_incr;
+                  dsp_i++;
                   }
 
             /* break out if buffer filled */
@@ -450,6 +497,7 @@ int Voice::dsp_float_interpolate_4th_order(unsigned n)
 
 int Voice::dsp_float_interpolate_7th_order(unsigned n)
       {
+      const DspKernels& kernels = DspKernels::best();
       Voice* voice = this;
 
       Phase dsp_phase = voice->phase;
@@ -577,7 +625,22 @@ int Voice::dsp_float_interpolate_7th_order(unsigned n)
             start_index -= 2;	/* set back to original start index */
 
             /* interpolate the sequence of sample points */
-            for ( ; dsp_i < n && dsp_phase_index <= end_index; dsp_i++) {
+            while (dsp_i < n && dsp_phase_index <= end_index) {
+                  /* runs without amplitude segment change go to the vector kernels;
+                   * they read one point more than the loop below */
+                  unsigned run = (amp != 0.0 || dsp_amp_incr != 0.0)
+                     ? runLength(dsp_i, n, nextNewAmpInc, positionToTurnOff, dsp_phase, dsp_phase_incr, end_index - 1)
+                     : 0;
+                  if (run >= MIN_RUN) {
+                        kernels.interpolate7(dsp_buf + dsp_i, run, dsp_data, dsp_phase.data, dsp_phase_incr.data,
+                           amp, dsp_amp_incr, sinc_table7);
+                        dsp_phase.data += run * dsp_phase_incr.data;
+                        amp            += run * dsp_amp_incr;
+                        dsp_i          += run;
+                        dsp_phase_index = dsp_phase.index();
+                        continue;
+                        }
+
                   coeffs = sinc_table7[fluid_phase_fract_to_tablerow (dsp_phase)];
 
                   dsp_buf[dsp_i] = amp * (coeffs[0] * (float)dsp_data[dsp_phase_index-3]
@@ -594,6 +657,7 @@ int Voice::dsp_float_interpolate_7th_order(unsigned n)
                   if (!updateAmpInc(nextNewAmpInc, curSample2AmpInc, dsp_amp_incr, dsp_i))
                         return dsp_i;
                   amp += dsp_amp_incr;
+                  dsp_i++;
                   }
 
             /* break out if buffer filled */
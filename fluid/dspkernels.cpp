@@ -0,0 +1,362 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2016 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include "dspkernels.h"
+
+#if defined(__i386__) || defined(__x86_64__)
+#define FLUID_X86
+#include <immintrin.h>
+#endif
+
+namespace FluidS {
+
+//---------------------------------------------------------
+//   interpolate4Scalar
+//    the loop of Voice::dsp_float_interpolate_4th_order
+//---------------------------------------------------------
+
+static void interpolate4Scalar(float* buf, unsigned count, const short* data, qint64 phase, qint64 phaseIncr,
+   double amp, double ampIncr, const float (*coeffs)[4])
+      {
+      for (unsigned k = 0; k < count; ++k) {
+            int idx        = int(phase >> 32);
+            const float* c = coeffs[quint32(phase) >> 24];
+            buf[k] = amp * (c[0] * data[idx-1]
+               + c[1] * data[idx]
+               + c[2] * data[idx+1]
+               + c[3] * data[idx+2]);
+            phase += phaseIncr;
+            amp   += ampIncr;
+            }
+      }
+
+//---------------------------------------------------------
+//   interpolate7Scalar
+//    the loop of Voice::dsp_float_interpolate_7th_order
+//---------------------------------------------------------
+
+static void interpolate7Scalar(float* buf, unsigned count, const short* data, qint64 phase, qint64 phaseIncr,
+   double amp, double ampIncr, const float (*coeffs)[7])
+      {
+      for (unsigned k = 0; k < count; ++k) {
+            int idx        = int(phase >> 32);
+            const float* c = coeffs[quint32(phase) >> 24];
+            buf[k] = amp * (c[0] * (float)data[idx-3]
+               + c[1] * (float)data[idx-2]
+               + c[2] * (float)data[idx-1]
+               + c[3] * (float)data[idx]
+               + c[4] * (float)data[idx+1]
+               + c[5] * (float)data[idx+2]
+               + c[6] * (float)data[idx+3]);
+            phase += phaseIncr;
+            amp   += ampIncr;
+            }
+      }
+
+//---------------------------------------------------------
+//   mixScalar
+//    the output loop of Voice::effects
+//---------------------------------------------------------
+
+static void mixScalar(const float* buf, unsigned count, float* out, float* reverb, float* chorus,
+   float left, float right, float reverbSend, float chorusSend)
+      {
+      for (unsigned i = 0; i < count; i++) {
+            float v    = buf[i];
+
+            float vv   = v  * left;
+            *out++    += vv;
+            *reverb++ += vv * reverbSend;
+            *chorus++ += vv * chorusSend;
+
+            vv         = v  * right;
+            *out++    += vv;
+            *reverb++ += vv * reverbSend;
+            *chorus++ += vv * chorusSend;
+            }
+      }
+
+#ifdef FLUID_X86
+
+//---------------------------------------------------------
+//   SSE2
+//    four samples at a time; the tap products of four
+//    samples are transposed, so the taps are added in
+//    the order of the scalar code
+//---------------------------------------------------------
+
+__attribute__((target("sse2")))
+static inline __m128 loadSamples4(const short* p)
+      {
+      __m128i s = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(p));
+      return _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(s, s), 16));
+      }
+
+// (amp + k * ampIncr) * sum for the four samples from k, computed in double like the scalar code
+
+__attribute__((target("sse2")))
+static inline __m128 applyGainSse2(__m128 sum, unsigned k, double amp, double ampIncr)
+      {
+      __m128d a    = _mm_set1_pd(amp);
+      __m128d incr = _mm_set1_pd(ampIncr);
+      __m128d lo   = _mm_mul_pd(_mm_cvtps_pd(sum), _mm_add_pd(a, _mm_mul_pd(_mm_set_pd(k + 1, k), incr)));
+      __m128d hi   = _mm_mul_pd(_mm_cvtps_pd(_mm_movehl_ps(sum, sum)), _mm_add_pd(a, _mm_mul_pd(_mm_set_pd(k + 3, k + 2), incr)));
+      return _mm_movelh_ps(_mm_cvtpd_ps(lo), _mm_cvtpd_ps(hi));
+      }
+
+__attribute__((target("sse2")))
+static void interpolate4Sse2(float* buf, unsigned count, const short* data, qint64 phase, qint64 phaseIncr,
+   double amp, double ampIncr, const float (*coeffs)[4])
+      {
+      unsigned k = 0;
+      for (; k + 4 <= count; k += 4) {
+            __m128 p[4];
+            for (int j = 0; j < 4; ++j) {
+                  p[j] = _mm_mul_ps(_mm_loadu_ps(coeffs[quint32(phase) >> 24]),
+                     loadSamples4(data + int(phase >> 32) - 1));
+                  phase += phaseIncr;
+                  }
+            _MM_TRANSPOSE4_PS(p[0], p[1], p[2], p[3]);
+            __m128 sum = _mm_add_ps(_mm_add_ps(_mm_add_ps(p[0], p[1]), p[2]), p[3]);
+            _mm_storeu_ps(buf + k, applyGainSse2(sum, k, amp, ampIncr));
+            }
+      interpolate4Scalar(buf + k, count - k, data, phase, phaseIncr, amp + k * ampIncr, ampIncr, coeffs);
+      }
+
+__attribute__((target("sse2")))
+static void interpolate7Sse2(float* buf, unsigned count, const short* data, qint64 phase, qint64 phaseIncr,
+   double amp, double ampIncr, const float (*coeffs)[7])
+      {
+      unsigned k = 0;
+      for (; k + 4 <= count; k += 4) {
+            __m128 lo[4];           // taps 0 - 3
+            __m128 hi[4];           // taps 3 - 6
+            for (int j = 0; j < 4; ++j) {
+                  const float* c = coeffs[quint32(phase) >> 24];
+                  const short* d = data + int(phase >> 32);
+                  lo[j] = _mm_mul_ps(_mm_loadu_ps(c), loadSamples4(d - 3));
+                  hi[j] = _mm_mul_ps(_mm_loadu_ps(c + 3), loadSamples4(d));
+                  phase += phaseIncr;
+                  }
+            _MM_TRANSPOSE4_PS(lo[0], lo[1], lo[2], lo[3]);
+            _MM_TRANSPOSE4_PS(hi[0], hi[1], hi[2], hi[3]);
+            __m128 sum = _mm_add_ps(_mm_add_ps(_mm_add_ps(lo[0], lo[1]), lo[2]), lo[3]);
+            sum = _mm_add_ps(_mm_add_ps(_mm_add_ps(sum, hi[1]), hi[2]), hi[3]);
+            _mm_storeu_ps(buf + k, applyGainSse2(sum, k, amp, ampIncr));
+            }
+      interpolate7Scalar(buf + k, count - k, data, phase, phaseIncr, amp + k * ampIncr, ampIncr, coeffs);
+      }
+
+__attribute__((target("sse2")))
+static void mixSse2(const float* buf, unsigned count, float* out, float* reverb, float* chorus,
+   float left, float right, float reverbSend, float chorusSend)
+      {
+      const __m128 l  = _mm_set1_ps(left);
+      const __m128 r  = _mm_set1_ps(right);
+      const __m128 rs = _mm_set1_ps(reverbSend);
+      const __m128 cs = _mm_set1_ps(chorusSend);
+      unsigned i = 0;
+      for (; i + 4 <= count; i += 4) {
+            __m128 v  = _mm_loadu_ps(buf + i);
+            __m128 vl = _mm_mul_ps(v, l);
+            __m128 vr = _mm_mul_ps(v, r);
+            __m128 s0 = _mm_unpacklo_ps(vl, vr);
+            __m128 s1 = _mm_unpackhi_ps(vl, vr);
+            float* o  = out + 2 * i;
+            float* rv = reverb + 2 * i;
+            float* ch = chorus + 2 * i;
+            _mm_storeu_ps(o,      _mm_add_ps(_mm_loadu_ps(o), s0));
+            _mm_storeu_ps(o + 4,  _mm_add_ps(_mm_loadu_ps(o + 4), s1));
+            _mm_storeu_ps(rv,     _mm_add_ps(_mm_loadu_ps(rv), _mm_mul_ps(s0, rs)));
+            _mm_storeu_ps(rv + 4, _mm_add_ps(_mm_loadu_ps(rv + 4), _mm_mul_ps(s1, rs)));
+            _mm_storeu_ps(ch,     _mm_add_ps(_mm_loadu_ps(ch), _mm_mul_ps(s0, cs)));
+            _mm_storeu_ps(ch + 4, _mm_add_ps(_mm_loadu_ps(ch + 4), _mm_mul_ps(s1, cs)));
+            }
+      mixScalar(buf + i, count - i, out + 2 * i, reverb + 2 * i, chorus + 2 * i, left, right, reverbSend, chorusSend);
+      }
+
+//---------------------------------------------------------
+//   AVX2
+//    eight samples at a time, sample j and j + 4 share
+//    a register; transposed per 128 bit lane like SSE2
+//---------------------------------------------------------
+
+__attribute__((target("avx2")))
+static inline __m256 loadSamples8(const short* p0, const short* p1)
+      {
+      __m128i s = _mm_unpacklo_epi64(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(p0)),
+         _mm_loadl_epi64(reinterpret_cast<const __m128i*>(p1)));
+      return _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(s));
+      }
+
+__attribute__((target("avx2")))
+static inline __m256 loadCoeffs8(const float* c0, const float* c1)
+      {
+      return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(c0)), _mm_loadu_ps(c1), 1);
+      }
+
+__attribute__((target("avx2")))
+static inline void transpose8(__m256* r)
+      {
+      __m256 t0 = _mm256_unpacklo_ps(r[0], r[1]);
+      __m256 t1 = _mm256_unpackhi_ps(r[0], r[1]);
+      __m256 t2 = _mm256_unpacklo_ps(r[2], r[3]);
+      __m256 t3 = _mm256_unpackhi_ps(r[2], r[3]);
+      r[0] = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+      r[1] = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+      r[2] = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+      r[3] = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+      }
+
+// (amp + k * ampIncr) * sum for the eight samples from k
+
+__attribute__((target("avx2")))
+static inline __m256 applyGainAvx2(__m256 sum, unsigned k, double amp, double ampIncr)
+      {
+      __m256d a    = _mm256_set1_pd(amp);
+      __m256d incr = _mm256_set1_pd(ampIncr);
+      __m256d lo   = _mm256_mul_pd(_mm256_cvtps_pd(_mm256_castps256_ps128(sum)),
+         _mm256_add_pd(a, _mm256_mul_pd(_mm256_setr_pd(k, k + 1, k + 2, k + 3), incr)));
+      __m256d hi   = _mm256_mul_pd(_mm256_cvtps_pd(_mm256_extractf128_ps(sum, 1)),
+         _mm256_add_pd(a, _mm256_mul_pd(_mm256_setr_pd(k + 4, k + 5, k + 6, k + 7), incr)));
+      return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm256_cvtpd_ps(lo)), _mm256_cvtpd_ps(hi), 1);
+      }
+
+__attribute__((target("avx2")))
+static void interpolate4Avx2(float* buf, unsigned count, const short* data, qint64 phase, qint64 phaseIncr,
+   double amp, double ampIncr, const float (*coeffs)[4])
+      {
+      unsigned k = 0;
+      for (; k + 8 <= count; k += 8) {
+            __m256 p[4];
+            for (int j = 0; j < 4; ++j) {
+                  qint64 phase1 = phase + 4 * phaseIncr;
+                  p[j] = _mm256_mul_ps(loadCoeffs8(coeffs[quint32(phase) >> 24], coeffs[quint32(phase1) >> 24]),
+                     loadSamples8(data + int(phase >> 32) - 1, data + int(phase1 >> 32) - 1));
+                  phase += phaseIncr;
+                  }
+            phase += 4 * phaseIncr;
+            transpose8(p);
+            __m256 sum = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(p[0], p[1]), p[2]), p[3]);
+            _mm256_storeu_ps(buf + k, applyGainAvx2(sum, k, amp, ampIncr));
+            }
+      interpolate4Scalar(buf + k, count - k, data, phase, phaseIncr, amp + k * ampIncr, ampIncr, coeffs);
+      }
+
+__attribute__((target("avx2")))
+static void interpolate7Avx2(float* buf, unsigned count, const short* data, qint64 phase, qint64 phaseIncr,
+   double amp, double ampIncr, const float (*coeffs)[7])
+      {
+      unsigned k = 0;
+      for (; k + 8 <= count; k += 8) {
+            __m256 lo[4];           // taps 0 - 3
+            __m256 hi[4];           // taps 3 - 6
+            for (int j = 0; j < 4; ++j) {
+                  qint64 phase1   = phase + 4 * phaseIncr;
+                  const float* c0 = coeffs[quint32(phase) >> 24];
+                  const float* c1 = coeffs[quint32(phase1) >> 24];
+                  const short* d0 = data + int(phase >> 32);
+                  const short* d1 = data + int(phase1 >> 32);
+                  lo[j] = _mm256_mul_ps(loadCoeffs8(c0, c1), loadSamples8(d0 - 3, d1 - 3));
+                  hi[j] = _mm256_mul_ps(loadCoeffs8(c0 + 3, c1 + 3), loadSamples8(d0, d1));
+                  phase += phaseIncr;
+                  }
+            phase += 4 * phaseIncr;
+            transpose8(lo);
+            transpose8(hi);
+            __m256 sum = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(lo[0], lo[1]), lo[2]), lo[3]);
+            sum = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(sum, hi[1]), hi[2]), hi[3]);
+            _mm256_storeu_ps(buf + k, applyGainAvx2(sum, k, amp, ampIncr));
+            }
+      interpolate7Scalar(buf + k, count - k, data, phase, phaseIncr, amp + k * ampIncr, ampIncr, coeffs);
+      }
+
+__attribute__((target("avx2")))
+static void mixAvx2(const float* buf, unsigned count, float* out, float* reverb, float* chorus,
+   float left, float right, float reverbSend, float chorusSend)
+      {
+      const __m256 l  = _mm256_set1_ps(left);
+      const __m256 r  = _mm256_set1_ps(right);
+      const __m256 rs = _mm256_set1_ps(reverbSend);
+      const __m256 cs = _mm256_set1_ps(chorusSend);
+      unsigned i = 0;
+      for (; i + 8 <= count; i += 8) {
+            __m256 v  = _mm256_loadu_ps(buf + i);
+            __m256 vl = _mm256_mul_ps(v, l);
+            __m256 vr = _mm256_mul_ps(v, r);
+            __m256 u0 = _mm256_unpacklo_ps(vl, vr);         // l0 r0 l1 r1 | l4 r4 l5 r5
+            __m256 u1 = _mm256_unpackhi_ps(vl, vr);         // l2 r2 l3 r3 | l6 r6 l7 r7
+            __m256 s0 = _mm256_permute2f128_ps(u0, u1, 0x20);
+            __m256 s1 = _mm256_permute2f128_ps(u0, u1, 0x31);
+            float* o  = out + 2 * i;
+            float* rv = reverb + 2 * i;
+            float* ch = chorus + 2 * i;
+            _mm256_storeu_ps(o,      _mm256_add_ps(_mm256_loadu_ps(o), s0));
+            _mm256_storeu_ps(o + 8,  _mm256_add_ps(_mm256_loadu_ps(o + 8), s1));
+            _mm256_storeu_ps(rv,     _mm256_add_ps(_mm256_loadu_ps(rv), _mm256_mul_ps(s0, rs)));
+            _mm256_storeu_ps(rv + 8, _mm256_add_ps(_mm256_loadu_ps(rv + 8), _mm256_mul_ps(s1, rs)));
+            _mm256_storeu_ps(ch,     _mm256_add_ps(_mm256_loadu_ps(ch), _mm256_mul_ps(s0, cs)));
+            _mm256_storeu_ps(ch + 8, _mm256_add_ps(_mm256_loadu_ps(ch + 8), _mm256_mul_ps(s1, cs)));
+            }
+      mixScalar(buf + i, count - i, out + 2 * i, reverb + 2 * i, chorus + 2 * i, left, right, reverbSend, chorusSend);
+      }
+
+static const DspKernels sse2Kernels   = { DspIsa::SSE2, interpolate4Sse2, interpolate7Sse2, mixSse2 };
+static const DspKernels avx2Kernels   = { DspIsa::AVX2, interpolate4Avx2, interpolate7Avx2, mixAvx2 };
+#endif
+
+static const DspKernels scalarKernels = { DspIsa::SCALAR, interpolate4Scalar, interpolate7Scalar, mixScalar };
+
+//---------------------------------------------------------
+//   get
+//---------------------------------------------------------
+
+const DspKernels* DspKernels::get(DspIsa isa)
+      {
+      switch (isa) {
+            case DspIsa::SCALAR:
+                  return &scalarKernels;
+#ifdef FLUID_X86
+            case DspIsa::SSE2:
+                  __builtin_cpu_init();
+                  return __builtin_cpu_supports("sse2") ? &sse2Kernels : 0;
+            case DspIsa::AVX2:
+                  __builtin_cpu_init();
+                  return __builtin_cpu_supports("avx2") ? &avx2Kernels : 0;
+#else
+            default:
+                  break;
+#endif
+            }
+      return 0;
+      }
+
+//---------------------------------------------------------
+//   best
+//---------------------------------------------------------
+
+static const DspKernels* select()
+      {
+      for (DspIsa isa : { DspIsa::AVX2, DspIsa::SSE2 }) {
+            if (const DspKernels* k = DspKernels::get(isa))
+                  return k;
+            }
+      return &scalarKernels;
+      }
+
+const DspKernels& DspKernels::best()
+      {
+      static const DspKernels* kernels = select();
+      return *kernels;
+      }
+
+}
@@ -0,0 +1,55 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2016 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#ifndef __DSPKERNELS_H__
+#define __DSPKERNELS_H__
+
+namespace FluidS {
+
+enum class DspIsa : char {
+      SCALAR, SSE2, AVX2
+      };
+
+//---------------------------------------------------------
+//   DspKernels
+//    inner loops of Voice::write
+//
+//    The interpolators fill buf[0..count) for a run of
+//    samples in which the amplitude increment does not
+//    change and the phase stays inside the sample (they
+//    read data[index - 3] .. data[index + 4]):
+//       buf[k] = (amp + k * ampIncr) * interpolation at
+//                (phase + k * phaseIncr)
+//    mix adds a mono voice buffer to the interleaved
+//    stereo dry and effect buffers.
+//
+//    The scalar kernels are the reference; the SSE2 and
+//    AVX2 kernels differ from them by rounding only (sum
+//    order, float gain ramp). The best kernels for the cpu
+//    are selected at run time.
+//---------------------------------------------------------
+
+struct DspKernels {
+      DspIsa isa;
+      void (*interpolate4)(float* buf, unsigned count, const short* data, qint64 phase, qint64 phaseIncr,
+         double amp, double ampIncr, const float (*coeffs)[4]);
+      void (*interpolate7)(float* buf, unsigned count, const short* data, qint64 phase, qint64 phaseIncr,
+         double amp, double ampIncr, const float (*coeffs)[7]);
+      void (*mix)(const float* buf, unsigned count, float* out, float* reverb, float* chorus,
+         float left, float right, float reverbSend, float chorusSend);
+
+      static const DspKernels& best();
+      static const DspKernels* get(DspIsa);     // 0 if not supported by the cpu
+      };
+
+}
+#endif
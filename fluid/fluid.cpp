@@ -27,6 +27,7 @@
 #include "conv.h"
 #include "gen.h"
 #include "voice.h"
+#include "renderpool.h"
 
 namespace FluidS {
 
@@ -107,6 +108,7 @@ void Fluid::init(float sampleRate)
 Fluid::~Fluid()
       {
       _state = FLUID_SYNTH_STOPPED;
+      delete _renderPool;
       qDeleteAll(activeVoices);
       qDeleteAll(freeVoices);
       qDeleteAll(sfonts);
@@ -120,6 +122,8 @@ Fluid::~Fluid()
 
 void Fluid::freeVoice(Voice* v)
       {
+      if (_deferFree)
+            return;
       if (activeVoices.removeOne(v))
             freeVoices.append(v);
       }
@@ -393,12 +397,49 @@ void Fluid::update_presets()
 void Fluid::process(unsigned len, float* out, float* effect1, float* effect2)
       {
       if (mutex.tryLock()) {
-            foreach (Voice* v, activeVoices)
-                  v->write(len, out, effect1, effect2);
+            if (_renderPool && activeVoices.size() >= RenderPool::MIN_VOICES && len <= RenderPool::MAX_FRAMES) {
+                  const QList<Voice*> voices = activeVoices;
+                  _deferFree = true;
+                  _renderPool->render(voices, len, out, effect1, effect2);
+                  _deferFree = false;
+                  for (Voice* v : voices) {
+                        if (!v->PLAYING())
+                              freeVoice(v);
+                        }
+                  }
+            else {
+                  foreach (Voice* v, activeVoices)
+                        v->write(len, out, effect1, effect2);
+                  }
             mutex.unlock();
             }
       }
 
+//---------------------------------------------------------
+//   setRenderThreads
+//    render the voices on n worker threads and the audio
+//    thread; 0 renders them on the audio thread only
+//---------------------------------------------------------
+
+void Fluid::setRenderThreads(int n)
+      {
+      if (n == renderThreads())
+            return;
+      mutex.lock();
+      delete _renderPool;
+      _renderPool = n > 0 ? new RenderPool(n) : 0;
+      mutex.unlock();
+      }
+
+//---------------------------------------------------------
+//   renderThreads
+//---------------------------------------------------------
+
+int Fluid::renderThreads() const
+      {
+      return _renderPool ? _renderPool->threads() : 0;
+      }
+
 /*
  * fluid_synth_free_voice_by_kill
  *
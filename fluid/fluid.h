@@ -30,6 +30,7 @@ namespace FluidS {
 using namespace Ms;
 
 class Voice;
+class RenderPool;
 class SFont;
 class Preset;
 class Sample;
@@ -309,6 +310,8 @@ class Fluid : public Synthesizer {
       double _tuning[128];                // the pitch of every key, in cents
 
       QMutex mutex;
+      RenderPool* _renderPool = 0;        // render voices on worker threads if set
+      bool _deferFree = false;            // voices are rendered in parallel, freeVoice() later
       void updatePatchList();
 
    protected:
@@ -378,6 +381,9 @@ class Fluid : public Synthesizer {
       void free_voice_by_kill();
 
       virtual void process(unsigned len, float* out, float* effect1, float* effect2);
+      void setRenderThreads(int n);
+      int renderThreads() const;
+      int activeVoiceCount() const        { return activeVoices.size(); }
 
       bool program_select(int chan, unsigned sfont_id, unsigned bank_num, unsigned preset_num);
       void get_program(int chan, unsigned* sfont_id, unsigned* bank_num, unsigned* preset_num);
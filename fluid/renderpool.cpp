@@ -0,0 +1,238 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2016 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include "renderpool.h"
+#include "voice.h"
+#include "libmscore/trace.h"
+
+#if defined(Q_OS_WIN)
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace FluidS {
+
+// about 0.5 - 2 ms with pause; longer than the render
+// time of one block, shorter than the usual period
+static const int SPIN_ROUNDS = 1 << 14;
+
+//---------------------------------------------------------
+//   cpuRelax
+//---------------------------------------------------------
+
+static inline void cpuRelax()
+      {
+#if defined(__i386__) || defined(__x86_64__)
+      __builtin_ia32_pause();
+#endif
+      }
+
+//---------------------------------------------------------
+//   RenderPool
+//---------------------------------------------------------
+
+RenderPool::RenderPool(int threads)
+      {
+      const size_t laneSize = 3 * 2 * MAX_FRAMES;
+      _buffer.reset(new float[LANES * laneSize]);
+      for (int i = 0; i < LANES; ++i) {
+            float* p          = _buffer.get() + i * laneSize;
+            _lanes[i].out    = p;
+            _lanes[i].reverb = p + 2 * MAX_FRAMES;
+            _lanes[i].chorus = p + 4 * MAX_FRAMES;
+            _lanes[i].used   = false;
+            }
+      for (int i = 0; i < threads; ++i)
+            _workers.emplace_back(&RenderPool::worker, this);
+      }
+
+//---------------------------------------------------------
+//   ~RenderPool
+//---------------------------------------------------------
+
+RenderPool::~RenderPool()
+      {
+      _quit.store(true);
+      {
+      std::lock_guard<std::mutex> lock(_parkMutex);
+      _wake.notify_all();
+      }
+      for (std::thread& t : _workers)
+            t.join();
+      }
+
+//---------------------------------------------------------
+//   publishSchedule
+//    read the scheduling of the calling (audio) thread
+//    for the workers
+//---------------------------------------------------------
+
+void RenderPool::publishSchedule()
+      {
+#if defined(Q_OS_WIN)
+      _policy   = 0;
+      _priority = GetThreadPriority(GetCurrentThread());
+#else
+      sched_param param;
+      if (pthread_getschedparam(pthread_self(), &_policy, &param) != 0)
+            return;
+      _priority = param.sched_priority;
+#endif
+      _scheduleSerial.fetch_add(1, std::memory_order_release);
+      }
+
+//---------------------------------------------------------
+//   applySchedule
+//    give the calling worker the published scheduling;
+//    failing that (no permission), it keeps its own
+//---------------------------------------------------------
+
+void RenderPool::applySchedule()
+      {
+#if defined(Q_OS_WIN)
+      if (!SetThreadPriority(GetCurrentThread(), _priority))
+            qDebug("RenderPool: cannot set worker priority %d", _priority);
+#else
+      sched_param param;
+      param.sched_priority = _priority;
+      int rv = pthread_setschedparam(pthread_self(), _policy, &param);
+      if (rv != 0)
+            qDebug("RenderPool: cannot set worker scheduling %d/%d: %s", _policy, _priority, strerror(rv));
+#endif
+      }
+
+//---------------------------------------------------------
+//   worker
+//---------------------------------------------------------
+
+void RenderPool::worker()
+      {
+      Ms::Trace::setThreadName("Fluid worker");
+      unsigned seen = _generation.load();
+      int schedule  = 0;
+      for (;;) {
+            int spins = 0;
+            while (_generation.load(std::memory_order_acquire) == seen && !_quit.load()) {
+                  if (++spins < SPIN_ROUNDS) {
+                        cpuRelax();
+                        continue;
+                        }
+                  // _parked is incremented before the generation is checked
+                  // again, render() reads it after incrementing the generation:
+                  // one of both sees the other
+                  std::unique_lock<std::mutex> lock(_parkMutex);
+                  ++_parked;
+                  _wake.wait(lock, [this, seen] { return _generation.load() != seen || _quit.load(); });
+                  --_parked;
+                  spins = 0;
+                  }
+            if (_quit.load())
+                  return;
+            seen = _generation.load(std::memory_order_acquire);
+            int serial = _scheduleSerial.load(std::memory_order_acquire);
+            if (serial != schedule) {
+                  schedule = serial;
+                  applySchedule();
+                  }
+            renderLanes();
+            }
+      }
+
+//---------------------------------------------------------
+//   renderLanes
+//    render lanes until all are claimed
+//---------------------------------------------------------
+
+void RenderPool::renderLanes()
+      {
+      for (;;) {
+            int lane = _nextLane.fetch_add(1, std::memory_order_acq_rel);
+            if (lane >= LANES)
+                  return;
+            renderLane(lane);
+            _doneLanes.fetch_add(1, std::memory_order_release);
+            }
+      }
+
+//---------------------------------------------------------
+//   renderLane
+//---------------------------------------------------------
+
+void RenderPool::renderLane(int lane)
+      {
+      const QList<Voice*>& voices = *_voices;
+      int n     = voices.size();
+      int begin = lane * n / LANES;
+      int end   = (lane + 1) * n / LANES;
+      Lane& l   = _lanes[lane];
+      l.used    = begin < end;
+      if (!l.used)
+            return;
+
+      TRACE_SPAN_ARG("Fluid::renderLane", "audio", "voices", end - begin);
+      size_t size = 2 * _frames * sizeof(float);
+      memset(l.out, 0, size);
+      memset(l.reverb, 0, size);
+      memset(l.chorus, 0, size);
+      for (int i = begin; i < end; ++i)
+            voices.at(i)->write(_frames, l.out, l.reverb, l.chorus);
+      }
+
+//---------------------------------------------------------
+//   render
+//    mix voices into out, reverb and chorus; voices are
+//    not removed from the list while it is rendered, the
+//    caller frees the voices turned off
+//---------------------------------------------------------
+
+void RenderPool::render(const QList<Voice*>& voices, unsigned frames, float* out, float* reverb, float* chorus)
+      {
+      Q_ASSERT(frames <= MAX_FRAMES);
+      if (!_scheduleKnown) {
+            publishSchedule();
+            _scheduleKnown = true;
+            }
+      _voices = &voices;
+      _frames = frames;
+      _doneLanes.store(0, std::memory_order_relaxed);
+      _nextLane.store(0, std::memory_order_release);
+      _generation.fetch_add(1);
+      if (_parked.load() > 0) {
+            std::lock_guard<std::mutex> lock(_parkMutex);
+            _wake.notify_all();
+            }
+
+      renderLanes();
+      // a worker still renders its last lane; yield if it
+      // was preempted
+      for (int spins = 0; _doneLanes.load(std::memory_order_acquire) < LANES; ++spins) {
+            if (spins < SPIN_ROUNDS)
+                  cpuRelax();
+            else
+                  std::this_thread::yield();
+            }
+
+      unsigned n = 2 * frames;
+      for (const Lane& l : _lanes) {
+            if (!l.used)
+                  continue;
+            for (unsigned i = 0; i < n; ++i) {
+                  out[i]    += l.out[i];
+                  reverb[i] += l.reverb[i];
+                  chorus[i] += l.chorus[i];
+                  }
+            }
+      }
+
+}
@@ -0,0 +1,104 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2016 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#ifndef __RENDERPOOL_H__
+#define __RENDERPOOL_H__
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace FluidS {
+
+class Voice;
+
+//---------------------------------------------------------
+//   RenderPool
+//    renders the active voices of one block on a few
+//    worker threads
+//
+//    The voice list is split into LANES contiguous groups.
+//    Every lane mixes its voices into private dry, reverb
+//    and chorus buffers, and the lanes are added to the
+//    output in lane order at the end of the block. As the
+//    lane of a voice only depends on its position in the
+//    list, the output does not depend on the number of
+//    threads or on scheduling.
+//
+//    Lanes are claimed with an atomic counter and the
+//    audio thread renders lanes too, so it only waits for
+//    lanes a worker has already started. Workers spin for
+//    a while after a block and then park. render() does
+//    not allocate or lock unless a worker is parked.
+//
+//    The workers run with the scheduling policy and
+//    priority of the thread calling render(), as read on
+//    its first call. A worker preempted by a thread of
+//    lower priority would otherwise stall the audio thread
+//    waiting for its lane.
+//---------------------------------------------------------
+
+class RenderPool {
+   public:
+      static const int LANES      = 8;
+      static const int MIN_VOICES = 16;         // below this, render() is not worth it
+      static const unsigned MAX_FRAMES = 4096;
+
+   private:
+      struct Lane {
+            float* out;                         // 2 * MAX_FRAMES each, interleaved stereo
+            float* reverb;
+            float* chorus;
+            bool used;
+            };
+
+      std::vector<std::thread> _workers;
+      std::unique_ptr<float[]> _buffer;
+      Lane _lanes[LANES];
+
+      // the current block, valid while lanes are claimed
+      const QList<Voice*>* _voices = 0;
+      unsigned _frames             = 0;
+
+      std::atomic<unsigned> _generation { 0 };  // incremented for every block
+      std::atomic<int> _nextLane        { LANES };
+      std::atomic<int> _doneLanes       { LANES };
+      std::atomic<int> _parked          { 0 };
+      std::atomic<bool> _quit           { false };
+      std::mutex _parkMutex;
+      std::condition_variable _wake;
+
+      // scheduling of the audio thread, published by render()
+      bool _scheduleKnown = false;              // audio thread only
+      int _policy         = 0;
+      int _priority       = 0;
+      std::atomic<int> _scheduleSerial  { 0 };
+
+      void publishSchedule();
+      void applySchedule();
+      void worker();
+      void renderLanes();
+      void renderLane(int lane);
+
+   public:
+      RenderPool(int threads);
+      ~RenderPool();
+
+      int threads() const { return int(_workers.size()); }
+      void render(const QList<Voice*>& voices, unsigned frames, float* out, float* reverb, float* chorus);
+      };
+
+}
+#endif
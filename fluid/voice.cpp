@@ -23,6 +23,7 @@
 #include "sfont.h"
 #include "gen.h"
 #include "voice.h"
+#include "dspkernels.h"
 
 namespace FluidS {
 
@@ -1827,19 +1828,7 @@ void Voice::effects(int count, float* out, float* reverb, float* chorus)
                   }
             }
 
-      for (int i = 0; i < count; i++) {
-            float v    = dsp_buf[i];
-
-            float vv   = v  * amp_left;
-            *out++    += vv;
-            *reverb++ += vv * amp_reverb;
-            *chorus++ += vv * amp_chorus;
-
-            vv         = v  * amp_right;
-            *out++    += vv;
-            *reverb++ += vv * amp_reverb;
-            *chorus++ += vv * amp_chorus;
-            }
+      DspKernels::best().mix(dsp_buf, count, out, reverb, chorus, amp_left, amp_right, amp_reverb, amp_chorus);
       }
 }
 
@@ -141,6 +141,8 @@ class Accidental : public Element {
    private:
 #endif
 
+      POOLED_ELEMENT(Accidental)
+
       QList<SymElement> el;
       AccidentalType _accidentalType;
       bool _hasBracket;
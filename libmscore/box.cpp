@@ -604,7 +604,7 @@ QRectF HBox::drag(EditData* data)
                   x1 = x2;
             }
       setUserOff(QPointF(x1, 0.0));
-      setStartDragPosition(data->delta);
+      data->startDragPositions[this] = data->delta;
       return canvasBoundingRect() | r;
       }
 
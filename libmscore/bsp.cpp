@@ -113,10 +113,20 @@ void BspTree::clear()
 //---------------------------------------------------------
 
 void BspTree::insert(Element* element)
+      {
+      insert(element, element->pageBoundingRect());
+      }
+
+//---------------------------------------------------------
+//   insert
+//    insert element into all leaves intersecting r
+//---------------------------------------------------------
+
+void BspTree::insert(Element* element, const QRectF& r)
       {
       InsertItemBspTreeVisitor insertVisitor;
       insertVisitor.item = element;
-      climbTree(&insertVisitor, element->pageBoundingRect());
+      climbTree(&insertVisitor, r);
       }
 
 //---------------------------------------------------------
@@ -124,10 +134,23 @@ void BspTree::insert(Element* element)
 //---------------------------------------------------------
 
 void BspTree::remove(Element* element)
+      {
+      remove(element, element->pageBoundingRect());
+      }
+
+//---------------------------------------------------------
+//   remove
+//    remove element from all leaves intersecting r;
+//    r must be the rectangle used on insertion. The
+//    element is only compared by address and may
+//    already be deleted.
+//---------------------------------------------------------
+
+void BspTree::remove(Element* element, const QRectF& r)
       {
       RemoveItemBspTreeVisitor removeVisitor;
       removeVisitor.item = element;
-      climbTree(&removeVisitor, element->pageBoundingRect());
+      climbTree(&removeVisitor, r);
       }
 
 //---------------------------------------------------------
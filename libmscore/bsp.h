@@ -64,11 +64,14 @@ class BspTree
 
       void insert(Element* item);
       void remove(Element* item);
+      void insert(Element* item, const QRectF& r);
+      void remove(Element* item, const QRectF& r);
 
       QList<Element*> items(const QRectF& rect);
       QList<Element*> items(const QPointF& pos);
 
       int leafCount() const                       { return leafCnt; }
+      const QRectF& boundingRect() const          { return rect;    }
       inline int firstChildIndex(int index) const { return index * 2 + 1; }
 
       inline int parentIndex(int index) const {
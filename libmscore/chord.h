@@ -79,6 +79,8 @@ class Chord : public ChordRest {
       Q_PROPERTY(Ms::StemSlash* stemSlash    READ stemSlash)
       Q_PROPERTY(int stemDirection    READ stemDirection)
 
+      POOLED_ELEMENT(Chord)
+
       std::vector<Note*>   _notes;       // sorted to decreasing line step
       LedgerLine*          _ledgerLines; // single linked list
 
@@ -38,6 +38,7 @@
 #include "tuplet.h"
 #include "xml.h"
 #include "ottava.h"
+#include "trace.h"
 #include "trill.h"
 #include "pedal.h"
 #include "hairpin.h"
@@ -95,7 +96,7 @@ void CmdState::reset()
 
 void CmdState::setTick(int t)
       {
-      if (_updateMode == UpdateMode::LayoutAll)
+      if (_locked || _updateMode == UpdateMode::LayoutAll)
             return;
       if (_startTick == -1 || t < _startTick)
             _startTick = t;
@@ -110,7 +111,7 @@ void CmdState::setTick(int t)
 
 void CmdState::setUpdateMode(UpdateMode m)
       {
-      if (int(m) > int(_updateMode))
+      if (!_locked && int(m) > int(_updateMode))
             _updateMode = m;
       }
 
@@ -122,6 +123,7 @@ void CmdState::setUpdateMode(UpdateMode m)
 
 void Score::startCmd()
       {
+      TRACE_SPAN("Score::startCmd", "cmd");
       if (MScore::debugMode)
             qDebug("===startCmd()");
 
@@ -161,6 +163,7 @@ void Score::undoRedo(bool undo)
 
 void Score::endCmd(bool rollback)
       {
+      TRACE_SPAN("Score::endCmd", "cmd");
       if (!undoStack()->active()) {
             qDebug("Score::endCmd(): no cmd active");
             update();
@@ -205,7 +205,8 @@ DropData::DropData()
 void Element::spatiumChanged(qreal oldValue, qreal newValue)
       {
       _userOff *= (newValue / oldValue);
-      _readPos *= (newValue / oldValue);
+      if (_hasReadPos)
+            setReadPos(readPos() * (newValue / oldValue));
       }
 
 //---------------------------------------------------------
@@ -300,11 +301,22 @@ Element::Element(const Element& e)
       _mag        = e._mag;
       _pos        = e._pos;
       _userOff    = e._userOff;
-      _readPos    = e._readPos;
       _bbox       = e._bbox;
       _tag        = e._tag;
       itemDiscovered = false;
       _autoplace  = e._autoplace;
+      if (e._hasReadPos)
+            setReadPos(e.readPos());
+      }
+
+//---------------------------------------------------------
+//   ~Element
+//---------------------------------------------------------
+
+Element::~Element()
+      {
+      if (_hasReadPos)
+            setReadPos(QPointF());
       }
 
 //---------------------------------------------------------
@@ -324,12 +336,53 @@ Element* Element::linkedClone()
 
 void Element::adjustReadPos()
       {
-      if (!_readPos.isNull()) {
-            _userOff = _readPos - _pos;
-            _readPos = QPointF();
+      if (_hasReadPos) {
+            _userOff = readPos() - _pos;
+            setReadPos(QPointF());
             }
       }
 
+//---------------------------------------------------------
+//   readPositions
+//    absolute positions read from old files, until the
+//    first layout turns them into a user offset; few
+//    elements have one, so they are not stored in the
+//    element. The layout of different staves can run
+//    in parallel.
+//---------------------------------------------------------
+
+static QMutex readPositionsMutex;
+static QHash<const Element*, QPointF> readPositions;
+
+//---------------------------------------------------------
+//   readPos
+//---------------------------------------------------------
+
+QPointF Element::readPos() const
+      {
+      if (!_hasReadPos)
+            return QPointF();
+      QMutexLocker lock(&readPositionsMutex);
+      return readPositions.value(this);
+      }
+
+//---------------------------------------------------------
+//   setReadPos
+//    a null position removes the read position
+//---------------------------------------------------------
+
+void Element::setReadPos(const QPointF& p)
+      {
+      if (p.isNull() && !_hasReadPos)
+            return;
+      QMutexLocker lock(&readPositionsMutex);
+      if (p.isNull())
+            readPositions.remove(this);
+      else
+            readPositions.insert(this, p);
+      _hasReadPos = !p.isNull();
+      }
+
 //---------------------------------------------------------
 //   scanElements
 //---------------------------------------------------------
@@ -743,7 +796,7 @@ bool Element::readProperties(XmlReader& e)
             }
       else if (tag == "pos") {
             QPointF pt = e.readPoint();
-            _readPos = pt * score()->spatium();
+            setReadPos(pt * score()->spatium());
             _autoplace = false;
             }
       else if (tag == "voice")
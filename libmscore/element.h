@@ -19,6 +19,7 @@
 #include "scoreElement.h"
 #include "shape.h"
 #include "property.h"
+#include "elementpool.h"
 
 class QPainter;
 
@@ -161,6 +162,7 @@ struct EditData {
       QPointF delta;
       bool hRaster;
       bool vRaster;
+      QHash<Element*, QPointF> startDragPositions;    ///< userOff of the dragged elements at drag start
       };
 
 //---------------------------------------------------------
@@ -213,17 +215,6 @@ class Element : public QObject, public ScoreElement {
       Q_PROPERTY(QPointF                  userOff     READ scriptUserOff WRITE scriptSetUserOff)
       Q_PROPERTY(bool                     visible     READ visible      WRITE undoSetVisible)
 
-      Element* _parent { 0 };
-
-      bool _generated;            ///< automatically generated Element
-      bool _autoplace;
-
-  protected:
-      bool _selected;             ///< set if element is selected
-      bool _visible;              ///< visibility attribute
-      mutable int _z;
-      QColor _color;              ///< element color attribute
-
   public:
       //-------------------------------------------------------------------
       //    The value of this enum determines the "stacking order"
@@ -335,30 +326,43 @@ class Element : public QObject, public ScoreElement {
             ABOVE, BELOW
             };
 
+      // the members are ordered by size to avoid padding
+
   private:
+      Element* _parent { 0 };
+
+      bool _generated;            ///< automatically generated Element
+      bool _autoplace;
+      bool _hasReadPos { false }; ///< position read from an old file, see readPos()
       Placement _placement;
 
-      mutable ElementFlags _flags;
+  protected:
+      bool _selected;             ///< set if element is selected
+      bool _visible;              ///< visibility attribute
 
+  public:
+      mutable bool itemDiscovered;     ///< helper flag for bsp
+
+  protected:
+      mutable int _z;
+      QColor _color;              ///< element color attribute
+
+  private:
+      mutable ElementFlags _flags;
       int _track;                 ///< staffIdx * VOICES + voice
+      uint _tag;                  ///< tag bitmask
       qreal _mag;                 ///< standard magnification (derived value)
 
       QPointF _pos;               ///< Reference position, relative to _parent.
       QPointF _userOff;           ///< offset from normal layout position:
                                   ///< user dragged object this amount.
-      QPointF _readPos;
-
       mutable QRectF _bbox;       ///< Bounding box relative to _pos + _userOff
                                   ///< valid after call to layout()
-      uint _tag;                  ///< tag bitmask
-
-   protected:
-      QPointF _startDragPosition;   ///< used during drag
 
    public:
       Element(Score* s = 0);
       Element(const Element&);
-      virtual ~Element() {}
+      virtual ~Element();
 
       Element &operator=(const Element&) = delete;
       //@ create a copy of the element
@@ -418,9 +422,9 @@ class Element : public QObject, public ScoreElement {
       QPointF scriptUserOff() const;
       void scriptSetUserOff(const QPointF& o);
 
-      bool isNudged() const                   { return !(_readPos.isNull() && _userOff.isNull()); }
-      const QPointF& readPos() const          { return _readPos;   }
-      void setReadPos(const QPointF& p)       { _readPos = p;      }
+      bool isNudged() const                   { return _hasReadPos || !_userOff.isNull(); }
+      QPointF readPos() const;
+      void setReadPos(const QPointF& p);
       virtual void adjustReadPos();
 
       virtual const QRectF& bbox() const      { return _bbox;              }
@@ -537,8 +541,6 @@ class Element : public QObject, public ScoreElement {
  */
       virtual bool mousePress(const QPointF&, QMouseEvent*) { return false; }
 
-      mutable bool itemDiscovered;     ///< helper flag for bsp
-
       virtual void scanElements(void* data, void (*func)(void*, Element*), bool all=true);
 
       virtual void reset();         // reset all properties & position to default
@@ -563,9 +565,6 @@ class Element : public QObject, public ScoreElement {
       //
       virtual bool check() const { return true; }
 
-      QPointF startDragPosition() const           { return _startDragPosition; }
-      void setStartDragPosition(const QPointF& v) { _startDragPosition = v; }
-
       static const char* name(Element::Type type);
       static Ms::Element* create(Ms::Element::Type type, Score*);
       static Element::Type name2type(const QStringRef&);
@@ -0,0 +1,196 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2016 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include "elementpool.h"
+
+namespace Ms {
+
+static const size_t CHUNK_SIZE = 64 * 1024;
+static const size_t ALIGNMENT  = alignof(std::max_align_t);
+
+//---------------------------------------------------------
+//   pools
+//    all pools, for the statistics
+//---------------------------------------------------------
+
+static QMutex poolsMutex;
+
+static std::vector<ElementPool*>& pools()
+      {
+      static std::vector<ElementPool*> p;
+      return p;
+      }
+
+//---------------------------------------------------------
+//   ElementPool
+//---------------------------------------------------------
+
+ElementPool::ElementPool(const char* name, size_t size)
+   : _name(name), _size((size + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT)
+      {
+      QMutexLocker locker(&poolsMutex);
+      pools().push_back(this);
+      }
+
+//---------------------------------------------------------
+//   chunkSize
+//---------------------------------------------------------
+
+size_t ElementPool::chunkSize() const
+      {
+      return qMax(size_t(1), CHUNK_SIZE / _size) * _size;
+      }
+
+//---------------------------------------------------------
+//   linkAvail
+//   unlinkAvail
+//---------------------------------------------------------
+
+void ElementPool::linkAvail(Chunk* c)
+      {
+      c->prev = 0;
+      c->next = _avail;
+      if (_avail)
+            _avail->prev = c;
+      _avail = c;
+      }
+
+void ElementPool::unlinkAvail(Chunk* c)
+      {
+      if (c->prev)
+            c->prev->next = c->next;
+      else
+            _avail = c->next;
+      if (c->next)
+            c->next->prev = c->prev;
+      c->prev = 0;
+      c->next = 0;
+      }
+
+//---------------------------------------------------------
+//   newChunk
+//---------------------------------------------------------
+
+ElementPool::Chunk* ElementPool::newChunk()
+      {
+      Chunk* c = new Chunk;
+      c->begin = static_cast<char*>(::operator new(chunkSize()));
+      c->bump  = c->begin;
+      c->end   = c->begin + chunkSize();
+      _chunks[c->begin] = c;
+      linkAvail(c);
+      return c;
+      }
+
+//---------------------------------------------------------
+//   releaseChunk
+//    c is empty and in the list of chunks with space
+//---------------------------------------------------------
+
+void ElementPool::releaseChunk(Chunk* c)
+      {
+      unlinkAvail(c);
+      _chunks.erase(c->begin);
+      ::operator delete(c->begin);
+      delete c;
+      }
+
+//---------------------------------------------------------
+//   allocate
+//---------------------------------------------------------
+
+void* ElementPool::allocate(size_t size)
+      {
+      if (size > _size)                   // a larger subclass
+            return ::operator new(size);
+      QMutexLocker locker(&_mutex);
+      Chunk* c = _avail;
+      if (c && c == _spare && c->next)
+            c = c->next;            // fill used chunks first
+      if (!c)
+            c = newChunk();
+      if (c == _spare)
+            _spare = 0;
+      void* p;
+      if (c->free) {
+            p       = c->free;
+            c->free = c->free->next;
+            }
+      else {
+            p        = c->bump;
+            c->bump += _size;
+            }
+      ++c->live;
+      if (c->full())
+            unlinkAvail(c);
+      ++_allocations;
+      ++_live;
+      return p;
+      }
+
+//---------------------------------------------------------
+//   free
+//---------------------------------------------------------
+
+void ElementPool::free(void* p, size_t size)
+      {
+      if (!p)
+            return;
+      if (size > _size) {
+            ::operator delete(p);
+            return;
+            }
+      QMutexLocker locker(&_mutex);
+      auto i = _chunks.upper_bound(static_cast<char*>(p));
+      Q_ASSERT(i != _chunks.begin());
+      Chunk* c = (--i)->second;
+      if (c->full())
+            linkAvail(c);
+      Block* b = static_cast<Block*>(p);
+      b->next  = c->free;
+      c->free  = b;
+      --c->live;
+      --_live;
+      if (c->live == 0) {
+            // start over with an unfragmented chunk
+            c->free = 0;
+            c->bump = c->begin;
+            if (_spare)
+                  releaseChunk(_spare);
+            _spare = c;
+            }
+      }
+
+//---------------------------------------------------------
+//   stats
+//---------------------------------------------------------
+
+ElementPool::Stats ElementPool::stats()
+      {
+      QMutexLocker locker(&_mutex);
+      return Stats { _name, _size, _allocations, _live, _chunks.size() * chunkSize() };
+      }
+
+//---------------------------------------------------------
+//   allStats
+//---------------------------------------------------------
+
+std::vector<ElementPool::Stats> ElementPool::allStats()
+      {
+      QMutexLocker locker(&poolsMutex);
+      std::vector<Stats> stats;
+      for (ElementPool* p : pools())
+            stats.push_back(p->stats());
+      return stats;
+      }
+
+}
@@ -0,0 +1,109 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2016 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#ifndef __ELEMENTPOOL_H__
+#define __ELEMENTPOOL_H__
+
+#include <cstddef>
+#include <map>
+#include <vector>
+
+namespace Ms {
+
+//---------------------------------------------------------
+//   ElementPool
+//    free list allocator for one element type
+//
+//    A score creates and deletes the notes, chords,
+//    segments, stems etc. by the hundred thousand while
+//    loading, cloning parts, pasting and laying out. The
+//    pooled types allocate from 64k chunks holding only
+//    objects of their type; every chunk has its own free
+//    list, freed objects are reused first. A chunk whose
+//    objects are all freed is given back, except for one
+//    spare chunk, so closing a score returns its memory.
+//    The pools themselves are never destroyed, as
+//    elements can be deleted by static destructors.
+//
+//    Subclasses larger than the pooled type use the
+//    global operator new. The pool is locked with a
+//    mutex, as staves are laid out and parts are cloned
+//    on several threads.
+//---------------------------------------------------------
+
+class ElementPool {
+      struct Block {
+            Block* next;
+            };
+      struct Chunk {
+            char* begin;
+            char* bump;                   // next never used object
+            char* end;
+            Block* free     { 0 };
+            int live        { 0 };
+            Chunk* prev     { 0 };        // in the list of chunks with space
+            Chunk* next     { 0 };
+            bool full() const { return !free && bump == end; }
+            };
+
+      const char* _name;
+      size_t _size;                       // object size, rounded up to the alignment
+
+      // guarded by _mutex
+      QMutex _mutex;
+      std::map<char*, Chunk*> _chunks;    // by start address
+      Chunk* _avail       { 0 };          // chunks with space
+      Chunk* _spare       { 0 };          // one empty chunk kept
+      qint64 _allocations { 0 };
+      qint64 _live        { 0 };
+
+      size_t chunkSize() const;
+      Chunk* newChunk();
+      void releaseChunk(Chunk*);
+      void linkAvail(Chunk*);
+      void unlinkAvail(Chunk*);
+
+   public:
+      struct Stats {
+            const char* name;
+            size_t size;
+            qint64 allocations;           // since the start of the program
+            qint64 live;
+            size_t chunkBytes;
+            };
+
+      ElementPool(const char* name, size_t size);
+      ElementPool(const ElementPool&) = delete;
+      ElementPool& operator=(const ElementPool&) = delete;
+
+      void* allocate(size_t size);
+      void free(void* p, size_t size);
+      Stats stats();
+
+      static std::vector<Stats> allStats();
+      };
+
+}     // namespace Ms
+
+//---------------------------------------------------------
+//   POOLED_ELEMENT
+//    allocate the objects of a class from its own pool
+//---------------------------------------------------------
+
+#define POOLED_ELEMENT(T) \
+   public: \
+      static Ms::ElementPool& pool()                    { static Ms::ElementPool* p = new Ms::ElementPool(#T, sizeof(T)); return *p; } \
+      static void* operator new(size_t size)            { return pool().allocate(size); } \
+      static void operator delete(void* p, size_t size) { pool().free(p, size); } \
+   private:
+
+#endif
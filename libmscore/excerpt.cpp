@@ -41,6 +41,9 @@
 #include "tremolo.h"
 #include "barline.h"
 #include "undo.h"
+#include "arpeggio.h"
+#include "articulation.h"
+#include "chordline.h"
 
 namespace Ms {
 
@@ -110,10 +113,110 @@ static void localSetScore(void* score, Element* element)
       }
 
 //---------------------------------------------------------
-//   createExcerpt
+//   ExcerptClone
+//    the state of cloning the staves of one part score
+//
+//    While cloning, the links to the original elements
+//    are only collected, in the order in which the linked
+//    copy constructors would create them, and are done
+//    afterwards by finishClone(). The cloning then does
+//    not touch the original elements or the undo stack
+//    and the staves of several parts can be cloned at the
+//    same time.
 //---------------------------------------------------------
 
-void createExcerpt(Excerpt* excerpt)
+struct ExcerptClone {
+      struct LinkData {
+            ScoreElement* e;
+            ScoreElement* le;
+            bool undoable;          // false: linked without undo command
+            };
+      std::vector<LinkData> links;
+      QHash<ChordRest*, ChordRest*> chordRests; // original -> clone
+      QHash<Note*, Note*> notes;
+      QList<Spanner*> noteSpanners;             // added to the score by finishClone()
+      QList<Harmony*> harmonies;                // rendered by finishClone()
+
+      void link(ScoreElement* e, ScoreElement* le, bool undoable = true) {
+            links.push_back(LinkData { e, le, undoable });
+            }
+      };
+
+//---------------------------------------------------------
+//   linkChordRest
+//    collect the links Chord(const Chord&, true) and
+//    Rest(const Rest&, true) create
+//---------------------------------------------------------
+
+static void linkChordRest(ChordRest* ocr, ChordRest* ncr, ExcerptClone* c)
+      {
+      c->chordRests.insert(ocr, ncr);
+      for (int i = 0; i < ocr->articulations().size(); ++i)
+            c->link(ncr->articulations().at(i), ocr->articulations().at(i), false);
+      for (size_t i = 0; i < ocr->lyrics().size(); ++i)
+            c->link(ncr->lyrics()[i], ocr->lyrics()[i], false);
+      c->link(ocr, ncr);
+      if (ocr->type() != Element::Type::CHORD)
+            return;
+
+      Chord* och = static_cast<Chord*>(ocr);
+      Chord* nch = static_cast<Chord*>(ncr);
+      for (size_t i = 0; i < och->notes().size(); ++i) {
+            Note* on = och->notes()[i];
+            Note* nn = nch->notes()[i];
+            c->notes.insert(on, nn);
+            c->link(on, nn);
+            const ElementList oel = on->el();
+            const ElementList nel = nn->el();
+            for (size_t k = 0; k < oel.size(); ++k)
+                  c->link(oel[k], nel[k]);
+            }
+      for (int i = 0; i < och->graceNotes().size(); ++i)
+            linkChordRest(och->graceNotes().at(i), nch->graceNotes().at(i), c);
+      if (och->arpeggio())
+            c->link(och->arpeggio(), nch->arpeggio());
+      if (och->tremolo() && !och->tremolo()->twoNotes())
+            c->link(och->tremolo(), nch->tremolo());
+      QList<Element*> ocl;
+      QList<Element*> ncl;
+      for (Element* e : och->el()) {
+            if (e->type() == Element::Type::CHORDLINE)
+                  ocl.append(e);
+            }
+      for (Element* e : nch->el()) {
+            if (e->type() == Element::Type::CHORDLINE)
+                  ncl.append(e);
+            }
+      for (int i = 0; i < ocl.size(); ++i)
+            c->link(ncl[i], ocl[i]);
+      }
+
+//---------------------------------------------------------
+//   cloneLinked
+//    linkedClone(), with the links collected in c if
+//    given
+//---------------------------------------------------------
+
+static Element* cloneLinked(Element* e, ExcerptClone* c)
+      {
+      if (!c)
+            return e->linkedClone();
+      Element* ne = e->clone();
+      if (e->type() == Element::Type::CHORD || e->type() == Element::Type::REST)
+            linkChordRest(static_cast<ChordRest*>(e), static_cast<ChordRest*>(ne), c);
+      else
+            c->link(ne, e);
+      return ne;
+      }
+
+//---------------------------------------------------------
+//   createParts
+//    create the parts and staves of the excerpt, linked
+//    to the staves of the original score; returns the
+//    original staff index of every new staff
+//---------------------------------------------------------
+
+static QList<int> createParts(Excerpt* excerpt)
       {
       MasterScore* oscore = excerpt->oscore();
       Score* score        = excerpt->partScore();
@@ -150,7 +253,19 @@ void createExcerpt(Excerpt* excerpt)
                   }
             score->appendPart(p);
             }
-      cloneStaves(oscore, score, srcStaves);
+      return srcStaves;
+      }
+
+//---------------------------------------------------------
+//   layoutExcerpt
+//    title, transposition and layout of the cloned
+//    excerpt
+//---------------------------------------------------------
+
+static void layoutExcerpt(Excerpt* excerpt)
+      {
+      MasterScore* oscore = excerpt->oscore();
+      Score* score        = excerpt->partScore();
 
       //
       // create excerpt title
@@ -239,6 +354,17 @@ void createExcerpt(Excerpt* excerpt)
       score->doLayout();
       }
 
+//---------------------------------------------------------
+//   createExcerpt
+//---------------------------------------------------------
+
+void createExcerpt(Excerpt* excerpt)
+      {
+      QList<int> srcStaves = createParts(excerpt);
+      cloneStaves(excerpt->oscore(), excerpt->partScore(), srcStaves);
+      layoutExcerpt(excerpt);
+      }
+
 void deleteExcerpt(Excerpt* excerpt)
       {
       MasterScore* oscore = excerpt->oscore();
@@ -293,7 +419,7 @@ void deleteExcerpt(Excerpt* excerpt)
 //   cloneSpanner
 //---------------------------------------------------------
 
-static void cloneSpanner(Spanner* s, Score* score, int dstTrack, int dstTrack2)
+static void cloneSpanner(Spanner* s, Score* score, int dstTrack, int dstTrack2, const ExcerptClone& c)
       {
       // dont clone voltas for track != 0
       if (s->type() == Element::Type::VOLTA && s->track() != 0)
@@ -307,33 +433,15 @@ static void cloneSpanner(Spanner* s, Score* score, int dstTrack, int dstTrack2)
             //
             // set start/end element for slur
             //
-            ChordRest* cr1 = s->startCR();
-            ChordRest* cr2 = s->endCR();
+            ChordRest* cr1 = c.chordRests.value(s->startCR());
+            ChordRest* cr2 = c.chordRests.value(s->endCR());
 
             ns->setStartElement(0);
             ns->setEndElement(0);
-            if (cr1 && cr1->links()) {
-                  for (ScoreElement* e : *cr1->links()) {
-                        ChordRest* cr = static_cast<ChordRest*>(e);
-                        if (cr == cr1)
-                              continue;
-                        if ((cr->score() == score) && (cr->tick() == ns->tick()) && cr->track() == dstTrack) {
-                              ns->setStartElement(cr);
-                              break;
-                              }
-                        }
-                  }
-            if (cr2 && cr2->links()) {
-                  for (ScoreElement* e : *cr2->links()) {
-                        ChordRest* cr = static_cast<ChordRest*>(e);
-                        if (cr == cr2)
-                              continue;
-                        if ((cr->score() == score) && (cr->tick() == ns->tick2()) && cr->track() == dstTrack2) {
-                              ns->setEndElement(cr);
-                              break;
-                              }
-                        }
-                  }
+            if (cr1 && cr1->tick() == ns->tick() && cr1->track() == dstTrack)
+                  ns->setStartElement(cr1);
+            if (cr2 && cr2->tick() == ns->tick2() && cr2->track() == dstTrack2)
+                  ns->setEndElement(cr2);
             if (!ns->startElement())
                   qDebug("clone Slur: no start element");
             if (!ns->endElement())
@@ -346,12 +454,13 @@ static void cloneSpanner(Spanner* s, Score* score, int dstTrack, int dstTrack2)
 //   cloneTuplets
 //---------------------------------------------------------
 
-static void cloneTuplets(ChordRest* ocr, ChordRest* ncr, Tuplet* ot, TupletMap& tupletMap, Measure* m, int track)
+static void cloneTuplets(ChordRest* ocr, ChordRest* ncr, Tuplet* ot, TupletMap& tupletMap, Measure* m, int track,
+   ExcerptClone* c = 0)
       {
       ot->setTrack(ocr->track());
       Tuplet* nt = tupletMap.findNew(ot);
       if (nt == 0) {
-            nt = static_cast<Tuplet*>(ot->linkedClone());
+            nt = static_cast<Tuplet*>(cloneLinked(ot, c));
             nt->setTrack(track);
             nt->setParent(m);
             tupletMap.add(ot, nt);
@@ -360,7 +469,7 @@ static void cloneTuplets(ChordRest* ocr, ChordRest* ncr, Tuplet* ot, TupletMap&
             while (ot->tuplet()) {
                   Tuplet* nt = tupletMap.findNew(ot->tuplet());
                   if (nt == 0) {
-                        nt = static_cast<Tuplet*>(ot->tuplet()->linkedClone());
+                        nt = static_cast<Tuplet*>(cloneLinked(ot->tuplet(), c));
                         nt->setTrack(track);
                         nt->setParent(m);
                         tupletMap.add(ot->tuplet(), nt);
@@ -396,24 +505,50 @@ static int mapTrack(int srcTrack, const QList<int>& map)
       }
 
 //---------------------------------------------------------
-//   cloneStaves
+//   cloneMeasures
+//    clone the measures of oscore with the staves in map
+//    into score; see ExcerptClone
+//
+//    Thread safe for different part scores as long as the
+//    CmdState of the master score is locked: oscore is only
+//    read, new elements are added to score and c only. The
+//    copy constructors and add() of the clones still ask the
+//    master score for a layout, which the lock suppresses.
+//    finishClone() changes oscore and the undo stack and is
+//    not thread safe.
 //---------------------------------------------------------
 
-void cloneStaves(Score* oscore, Score* score, const QList<int>& map)
+static void cloneMeasures(Score* oscore, Score* score, const QList<int>& map, ExcerptClone& c)
       {
       TieMap  tieMap;
 
+      int tracks = oscore->nstaves() * VOICES;
+      std::vector<int> trackMap(tracks);
+      for (int srcTrack = 0; srcTrack < tracks; ++srcTrack)
+            trackMap[srcTrack] = mapTrack(srcTrack, map);
+
+      // if the part score was added to the score before
+      // createExcerpts() inserted the title frame, insertMeasure()
+      // gave it an unlinked title frame of its own; it takes the
+      // place of the clone of the title frame of the score
+      MeasureBase* titleFrame = score->first();
+      if (titleFrame && (titleFrame->type() != Element::Type::VBOX
+         || !oscore->first() || oscore->first()->type() != Element::Type::VBOX))
+            titleFrame = 0;
+
       MeasureBaseList* nmbl = score->measures();
       for (MeasureBase* mb = oscore->measures()->first(); mb; mb = mb->next()) {
             MeasureBase* nmb = 0;
-            if (mb->type() == Element::Type::HBOX)
+            if (titleFrame && mb == oscore->first())
+                  nmb = titleFrame;
+            else if (mb->type() == Element::Type::HBOX)
                   nmb = new HBox(score);
             else if (mb->type() == Element::Type::VBOX)
                   nmb = new VBox(score);
             else if (mb->type() == Element::Type::TBOX) {
                   nmb = new TBox(score);
                   Text* text = static_cast<TBox*>(mb)->text();
-                  Element* ne = text->linkedClone();
+                  Element* ne = cloneLinked(text, &c);
                   ne->setScore(score);
                   nmb->add(ne);
                   }
@@ -442,11 +577,10 @@ void cloneStaves(Score* oscore, Score* score, const QList<int>& map)
 //                     m->endBarLineColor());
 
                   // Fraction ts = nm->len();
-                  int tracks = oscore->nstaves() * VOICES;
                   for (int srcTrack = 0; srcTrack < tracks; ++srcTrack) {
                         TupletMap tupletMap;    // tuplets cannot cross measure boundaries
 
-                        int track = mapTrack(srcTrack, map);
+                        int track = trackMap[srcTrack];
 
                         Tremolo* tremolo = 0;
                         for (Segment* oseg = m->first(); oseg; oseg = oseg->next()) {
@@ -457,7 +591,7 @@ void cloneStaves(Score* oscore, Score* score, const QList<int>& map)
                                     if ((e->track() == srcTrack && track != -1)
                                        || (e->systemFlag() && srcTrack == 0)
                                        ) {
-                                          Element* ne = e->linkedClone();
+                                          Element* ne = cloneLinked(e, &c);
                                           ne->setUserOff(QPointF());  // reset user offset as most likely
                                                                       // it will not fit
                                           ne->setReadPos(QPointF());
@@ -468,10 +602,8 @@ void cloneStaves(Score* oscore, Score* score, const QList<int>& map)
                                           ns->add(ne);
                                           // for chord symbols,
                                           // re-render with new style settings
-                                          if (ne->type() == Element::Type::HARMONY) {
-                                                Harmony* h = static_cast<Harmony*>(ne);
-                                                h->render();
-                                                }
+                                          if (ne->type() == Element::Type::HARMONY)
+                                                c.harmonies.append(static_cast<Harmony*>(ne));
                                           }
                                     }
 
@@ -516,7 +648,7 @@ void cloneStaves(Score* oscore, Score* score, const QList<int>& map)
                               if (oe->generated())
                                     continue;
                               else
-                                    ne = oe->linkedClone();
+                                    ne = cloneLinked(oe, &c);
                               ne->setTrack(track);
                               ne->scanElements(score, localSetScore);   //necessary?
                               ne->setScore(score);
@@ -540,7 +672,7 @@ void cloneStaves(Score* oscore, Score* score, const QList<int>& map)
                                     Tuplet* ot = ocr->tuplet();
 
                                     if (ot)
-                                          cloneTuplets(ocr, ncr, ot, tupletMap, m, track);
+                                          cloneTuplets(ocr, ncr, ot, tupletMap, m, track, &c);
 
                                     if (oe->type() == Element::Type::CHORD) {
                                           Chord* och = static_cast<Chord*>(ocr);
@@ -551,7 +683,7 @@ void cloneStaves(Score* oscore, Score* score, const QList<int>& map)
                                                 Note* on = och->notes().at(i);
                                                 Note* nn = nch->notes().at(i);
                                                 if (on->tieFor()) {
-                                                      Tie* tie = static_cast<Tie*>(on->tieFor()->linkedClone());
+                                                      Tie* tie = static_cast<Tie*>(cloneLinked(on->tieFor(), &c));
                                                       tie->setScore(score);
                                                       nn->setTieFor(tie);
                                                       tie->setStartNote(nn);
@@ -572,11 +704,13 @@ void cloneStaves(Score* oscore, Score* score, const QList<int>& map)
                                                 // makes sure the 'other' spanner anchor element is already set up)
                                                 // 'on' is the old spanner end note and 'nn' is the new spanner end note
                                                 for (Spanner* oldSp : on->spannerBack()) {
-                                                      Note* newStart = Spanner::startElementFromSpanner(oldSp, nn);
+                                                      Note* newStart = nullptr;
+                                                      if (oldSp->anchor() == Spanner::Anchor::NOTE)
+                                                            newStart = c.notes.value(static_cast<Note*>(oldSp->startElement()));
                                                       if (newStart != nullptr) {
-                                                            Spanner* newSp = static_cast<Spanner*>(oldSp->linkedClone());
+                                                            Spanner* newSp = static_cast<Spanner*>(cloneLinked(oldSp, &c));
                                                             newSp->setNoteSpan(newStart, nn);
-                                                            score->addElement(newSp);
+                                                            c.noteSpanners.append(newSp);
                                                             }
                                                       else {
                                                             qDebug("cloneStaves: cannot find spanner start note");
@@ -588,7 +722,7 @@ void cloneStaves(Score* oscore, Score* score, const QList<int>& map)
                                                if (och == och->tremolo()->chord1()) {
                                                       if (tremolo)
                                                             qDebug("unconnected two note tremolo");
-                                                      tremolo = static_cast<Tremolo*>(och->tremolo()->linkedClone());
+                                                      tremolo = static_cast<Tremolo*>(cloneLinked(och->tremolo(), &c));
                                                       tremolo->setScore(nch->score());
                                                       tremolo->setParent(nch);
                                                       tremolo->setTrack(nch->track());
@@ -615,7 +749,8 @@ void cloneStaves(Score* oscore, Score* score, const QList<int>& map)
                         }
                   }
 
-            nmb->linkTo(mb);
+            if (nmb != titleFrame || !titleFrame->links())
+                  c.link(nmb, mb, false);
             foreach (Element* e, mb->el()) {
                   if (e->type() == Element::Type::LAYOUT_BREAK) {
                         LayoutBreak::Type st = static_cast<LayoutBreak*>(e)->layoutBreakType();
@@ -642,15 +777,36 @@ void cloneStaves(Score* oscore, Score* score, const QList<int>& map)
                   // but section breaks do need to be cloned & linked
                   // other measure-attached elements (?) are cloned but not linked
                   if (e->isText() || e->type() == Element::Type::LAYOUT_BREAK)
-                        ne = e->linkedClone();
+                        ne = cloneLinked(e, &c);
                   else
                         ne = e->clone();
                   ne->setScore(score);
                   ne->setTrack(track);
                   nmb->add(ne);
                   }
-            nmbl->add(nmb);
+            if (nmb != titleFrame)
+                  nmbl->add(nmb);
             }
+      }
+
+//---------------------------------------------------------
+//   finishClone
+//    link the clones, add the note spanners, bar line
+//    spans, brackets and the other spanners
+//---------------------------------------------------------
+
+static void finishClone(Score* oscore, Score* score, const QList<int>& map, ExcerptClone& c)
+      {
+      for (const ExcerptClone::LinkData& l : c.links) {
+            if (l.undoable)
+                  score->undo(new Link(l.e, l.le));
+            else
+                  l.e->linkTo(l.le);
+            }
+      for (Spanner* sp : c.noteSpanners)
+            score->addElement(sp);
+      for (Harmony* h : c.harmonies)
+            h->render();
 
       int n = map.size();
       for (int dstStaffIdx = 0; dstStaffIdx < n; ++dstStaffIdx) {
@@ -711,7 +867,81 @@ void cloneStaves(Score* oscore, Score* score, const QList<int>& map)
             if (dstTrack == -1)
                   continue;
 
-            cloneSpanner(s, score, dstTrack, dstTrack2);
+            cloneSpanner(s, score, dstTrack, dstTrack2, c);
+            }
+      }
+
+//---------------------------------------------------------
+//   cloneStaves
+//---------------------------------------------------------
+
+void cloneStaves(Score* oscore, Score* score, const QList<int>& map)
+      {
+      ExcerptClone c;
+      cloneMeasures(oscore, score, map, c);
+      finishClone(oscore, score, map, c);
+      }
+
+//---------------------------------------------------------
+//   createExcerpts
+//    create the excerpts of one score, all part scores
+//    set and empty
+//
+//    The staves of the excerpts are cloned on the global
+//    thread pool if no two excerpts share a staff; the
+//    linking and the layout are done one excerpt after
+//    the other.
+//---------------------------------------------------------
+
+void createExcerpts(const QList<Excerpt*>& excerpts)
+      {
+      if (excerpts.isEmpty())
+            return;
+      MasterScore* oscore = excerpts.front()->oscore();
+
+      // create the title frame before cloning; insertMeasure()
+      // also adds it to the part scores already added to the score,
+      // cloneMeasures() then fills it instead of a new frame
+      MeasureBase* mb = oscore->first();
+      if (!mb || mb->type() != Element::Type::VBOX)
+            oscore->insertMeasure(Element::Type::VBOX, mb);
+
+      struct Job {
+            Excerpt* excerpt;
+            QList<int> map;
+            ExcerptClone clone;
+            };
+      std::vector<Job> jobs(excerpts.size());
+      QSet<int> staves;
+      bool independent = true;
+      for (int i = 0; i < excerpts.size(); ++i) {
+            jobs[i].excerpt = excerpts[i];
+            jobs[i].map     = createParts(excerpts[i]);
+            for (int staffIdx : jobs[i].map) {
+                  if (staves.contains(staffIdx))
+                        independent = false;
+                  staves.insert(staffIdx);
+                  }
+            }
+
+      // the clones do not change the master score; its layout
+      // and update state is locked so that their layout requests
+      // do not write to it from the worker threads
+      auto cloneJob = [oscore](Job& job) {
+            cloneMeasures(oscore, job.excerpt->partScore(), job.map, job.clone);
+            };
+      oscore->cmdState().lock();
+      if (independent && jobs.size() > 1)
+            QtConcurrent::blockingMap(jobs, cloneJob);
+      else {
+            for (Job& job : jobs)
+                  cloneJob(job);
+            }
+      oscore->cmdState().unlock();
+
+      for (Job& job : jobs) {
+            finishClone(oscore, job.excerpt->partScore(), job.map, job.clone);
+            layoutExcerpt(job.excerpt);
             }
       }
 
@@ -61,6 +61,7 @@ class Excerpt : public QObject {
       };
 
 extern void createExcerpt(Excerpt*);
+extern void createExcerpts(const QList<Excerpt*>&);
 extern void deleteExcerpt(Excerpt*);
 extern void cloneStaves(Score* oscore, Score* score, const QList<int>& map);
 extern void cloneStaff(Staff* ostaff, Staff* nstaff);
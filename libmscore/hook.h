@@ -26,6 +26,8 @@ class Chord;
 class Hook : public Symbol {
       Q_OBJECT
 
+      POOLED_ELEMENT(Hook)
+
       int _hookType;
 
    public:
@@ -266,9 +266,10 @@ void Image::draw(QPainter* painter) const
                   else
                         s = _size * DPMM;
                   if (score()->printing()) {
-                        // use original image size for printing
+                        // use original image size for printing; no QPixmap,
+                        // pages can be printed outside the gui thread
                         painter->scale(s.width() / rasterDoc->width(), s.height() / rasterDoc->height());
-                        painter->drawPixmap(QPointF(0, 0), QPixmap::fromImage(*rasterDoc));
+                        painter->drawImage(QPointF(0, 0), *rasterDoc);
                         }
                   else {
                         QTransform t = painter->transform();
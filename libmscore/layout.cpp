@@ -11,6 +11,7 @@
 //=============================================================================
 
 #include "accidental.h"
+#include "arpeggio.h"
 #include "barline.h"
 #include "beam.h"
 #include "box.h"
@@ -57,6 +58,7 @@
 #include "hook.h"
 #include "ambitus.h"
 #include "hairpin.h"
+#include "trace.h"
 
 namespace Ms {
 
@@ -78,6 +80,42 @@ void Score::rebuildBspTree()
             page->rebuildBspTree();
       }
 
+//---------------------------------------------------------
+//   invalidateBspTree
+//    element bounding boxes changed but the systems did
+//    not move; update the bsp trees incrementally
+//---------------------------------------------------------
+
+void Score::invalidateBspTree()
+      {
+      for (Page* page : _pages)
+            page->invalidateBspTree();
+      }
+
+//---------------------------------------------------------
+//   invalidateBspTree
+//    e is removed from the score; mark the systems it is
+//    laid out in, so that the bsp trees drop it on the next
+//    query even if these systems are not laid out again
+//---------------------------------------------------------
+
+void Score::invalidateBspTree(Element* e)
+      {
+      if (e->isSpanner()) {
+            for (SpannerSegment* ss : static_cast<Spanner*>(e)->spannerSegments())
+                  invalidateBspTree(ss);
+            return;
+            }
+      for (Element* p = e; p; p = p->parent()) {
+            if (p->isSystem()) {
+                  System* s = toSystem(p);
+                  if (s->page())
+                        s->page()->invalidateBspTree(s);
+                  return;
+                  }
+            }
+      }
+
 //---------------------------------------------------------
 //   searchNote
 //    search for note or rest before or at tick position tick
@@ -1192,34 +1230,135 @@ void Score::beamGraceNotes(Chord* mainNote, bool after)
 
 //---------------------------------------------------------
 //   layoutSpanner
-//    called after dragging a staff
+//    relayout stems, ties, note anchored spanners and
+//    annotations of all measures; called after dragging
+//    a staff
 //---------------------------------------------------------
 
 void Score::layoutSpanner()
       {
-      int tracks = ntracks();
-      for (int track = 0; track < tracks; ++track) {
-            for (Segment* segment = firstSegment(); segment; segment = segment->next1()) {
-                  if (track == tracks-1) {
-                        int n = segment->annotations().size();
-                        for (int i = 0; i < n; ++i)
-                              segment->annotations().at(i)->layout();
-                        }
-                  Element* e = segment->element(track);
-                  if (e && e->isChord()) {
-                        Chord* c = toChord(segment->element(track));
+      Measure* lm = lastMeasure();
+      if (lm)
+            layoutSpanner(0, lm->endTick());
+      }
+
+//---------------------------------------------------------
+//   addSpannerSystems
+//    remember the systems and area of the segments of sp
+//---------------------------------------------------------
+
+static void addSpannerSystems(Spanner* sp, QSet<System*>& systems, QRectF& refresh)
+      {
+      for (SpannerSegment* ss : sp->spannerSegments()) {
+            refresh |= ss->canvasBoundingRect();
+            if (ss->system())
+                  systems.insert(ss->system());
+            }
+      }
+
+//---------------------------------------------------------
+//   layoutNoteSpanners
+//    relayout the ties and note anchored spanners starting
+//    at the notes of c; layout can move spanner segments to
+//    other systems or remove them, so the systems before and
+//    after the layout are remembered
+//---------------------------------------------------------
+
+static void layoutNoteSpanners(Chord* c, QSet<System*>& systems, QRectF& refresh)
+      {
+      for (Note* n : c->notes()) {
+            Tie* tie = n->tieFor();
+            if (tie) {
+                  addSpannerSystems(tie, systems, refresh);
+                  tie->layout();
+                  addSpannerSystems(tie, systems, refresh);
+                  }
+            for (Spanner* sp : n->spannerFor()) {
+                  addSpannerSystems(sp, systems, refresh);
+                  sp->layout();
+                  addSpannerSystems(sp, systems, refresh);
+                  }
+            }
+      }
+
+//---------------------------------------------------------
+//   layoutSpanner
+//    relayout stems, ties, note anchored spanners and
+//    annotations of the measures overlapping [stick, etick)
+//    in one pass over the segments; annotations are laid
+//    out after the chords as they may depend on them.
+//    Only bsp trees of the affected systems are updated:
+//    the systems of the measures and the systems a tie or
+//    spanner was in before and after its layout.
+//---------------------------------------------------------
+
+void Score::layoutSpanner(int stick, int etick)
+      {
+      const int tracks = ntracks();
+      QList<Element*> annotations;
+      QSet<System*> systems;
+      QRectF refresh;
+
+      for (Measure* m = firstMeasure(); m; m = m->nextMeasure()) {
+            if (m->endTick() <= stick)
+                  continue;
+            if (m->tick() >= etick)
+                  break;
+            if (m->system())
+                  systems.insert(m->system());
+            refresh |= m->canvasBoundingRect();
+            for (Segment* segment = m->first(); segment; segment = segment->next()) {
+                  for (Element* e : segment->annotations())
+                        annotations.append(e);
+                  if (!segment->isChordRestType())
+                        continue;
+                  for (int track = 0; track < tracks; ++track) {
+                        Element* e = segment->element(track);
+                        if (!e || !e->isChord())
+                              continue;
+                        Chord* c = toChord(e);
                         c->layoutStem();
-                        for (Note* n : c->notes()) {
-                              Tie* tie = n->tieFor();
-                              if (tie)
-                                    tie->layout();
-                              for (Spanner* sp : n->spannerFor())
-                                    sp->layout();
-                              }
+                        layoutNoteSpanners(c, systems, refresh);
                         }
                   }
             }
-      rebuildBspTree();
+      for (Element* e : annotations) {
+            refresh |= e->canvasBoundingRect();
+            e->layout();
+            refresh |= e->canvasBoundingRect();
+            }
+
+      for (System* s : systems) {
+            if (s->page())
+                  s->page()->invalidateBspTree(s);
+            }
+      addRefresh(refresh);
+      }
+
+//---------------------------------------------------------
+//   layoutSpanner
+//    relayout the ties and note anchored spanners of the
+//    chords of a dragged beam. The stems are set by the
+//    beam layout; other chords are not touched and nothing
+//    is added to the undo stack, as Chord::layoutStem()
+//    would do for hooks.
+//---------------------------------------------------------
+
+void Score::layoutSpanner(Beam* beam)
+      {
+      QSet<System*> systems;
+      QRectF refresh;
+      for (ChordRest* cr : beam->elements()) {
+            if (cr->isChord())
+                  layoutNoteSpanners(toChord(cr), systems, refresh);
+            }
+      if (beam->system())
+            systems.insert(beam->system());
+      for (System* s : systems) {
+            if (s->page())
+                  s->page()->invalidateBspTree(s);
+            }
+      addRefresh(refresh);
       }
 
 //-------------------------------------------------------------------
@@ -2145,6 +2284,14 @@ System* Score::getNextSystem(LayoutContext& lc)
       else {
             system = lc.systemList.takeFirst();
             lc.systemOldMeasure = system->measures().empty() ? 0 : system->measures().back();
+            if (lc.lineWindow) {
+                  // spanners outside of the window are not laid out
+                  // again, collectSystem() puts their segments back
+                  for (SpannerSegment* ss : system->spannerSegments()) {
+                        if (ss->system() == system && lc.frozen(ss->spanner()))
+                              lc.frozenSegments.append(ss);
+                        }
+                  }
             system->clear();   // remove measures from system
             }
       _systems.append(system);
@@ -2566,6 +2713,58 @@ int LayoutContext::adjustMeasureNo(MeasureBase* m)
       return measureNo;
       }
 
+//---------------------------------------------------------
+//   frozen
+//---------------------------------------------------------
+
+bool LayoutContext::frozen(const MeasureBase* m) const
+      {
+      return lineWindow && (m->endTick() <= lineStartTick || m->tick() >= lineEndTick);
+      }
+
+//---------------------------------------------------------
+//   spannerStartTick
+//    ties and note anchored spanners are laid out with
+//    their start note in collectPage(), all others by
+//    tick range in collectSystem()
+//---------------------------------------------------------
+
+static int spannerStartTick(const Spanner* sp, bool* noteAnchored)
+      {
+      Element* e = sp->startElement();
+      *noteAnchored = e && e->isNote();
+      return *noteAnchored ? toNote(e)->chord()->tick() : sp->tick();
+      }
+
+//---------------------------------------------------------
+//   frozen
+//    true if the spanner is not laid out again in a
+//    line window; its segments are kept as they are
+//---------------------------------------------------------
+
+bool LayoutContext::frozen(const Spanner* sp) const
+      {
+      if (!lineWindow)
+            return false;
+      bool noteAnchored;
+      int tick = spannerStartTick(sp, &noteAnchored);
+      if (noteAnchored)
+            return tick < lineStartTick || tick >= lineEndTick;
+      return sp->tick2() <= lineStartTick || tick >= lineEndTick;
+      }
+
+//---------------------------------------------------------
+//   frozenAfter
+//    frozen spanner right of the window, moves with the
+//    measures after the window
+//---------------------------------------------------------
+
+bool LayoutContext::frozenAfter(const Spanner* sp) const
+      {
+      bool noteAnchored;
+      return frozen(sp) && spannerStartTick(sp, &noteAnchored) >= lineEndTick;
+      }
+
 //---------------------------------------------------------
 //   createBeams
 //    helper function
@@ -2732,6 +2931,82 @@ void Score::createBeams(Measure* measure)
             }
       }
 
+//---------------------------------------------------------
+//   stavesIndependent
+//    true if the chords of a measure can be laid out
+//    staff by staff: no chord is moved to another staff
+//    and no arpeggio spans several staves
+//---------------------------------------------------------
+
+static bool stavesIndependent(Measure* measure)
+      {
+      for (Segment* s = measure->first(Segment::Type::ChordRest); s; s = s->next(Segment::Type::ChordRest)) {
+            for (Element* e : s->elist()) {
+                  if (!e)
+                        continue;
+                  ChordRest* cr = toChordRest(e);
+                  if (cr->staffMove() || (cr->beam() && cr->beam()->cross()))
+                        return false;
+                  if (cr->isChord() && toChord(cr)->arpeggio() && toChord(cr)->arpeggio()->span() > 1)
+                        return false;
+                  }
+            }
+      return true;
+      }
+
+//---------------------------------------------------------
+//   staffChords
+//    the chords of a staff in a measure including grace
+//    notes
+//---------------------------------------------------------
+
+static std::vector<Chord*> staffChords(Measure* measure, int staffIdx)
+      {
+      std::vector<Chord*> chords;
+      int strack = staffIdx * VOICES;
+      int etrack = strack + VOICES;
+      for (Segment* s = measure->first(Segment::Type::ChordRest); s; s = s->next(Segment::Type::ChordRest)) {
+            for (int track = strack; track < etrack; ++track) {
+                  Element* e = s->element(track);
+                  if (!e || !e->isChord())
+                        continue;
+                  Chord* chord = toChord(e);
+                  for (Chord* c : chord->graceNotes())
+                        chords.push_back(c);
+                  chords.push_back(chord);
+                  }
+            }
+      return chords;
+      }
+
+//---------------------------------------------------------
+//   layoutStaffChords
+//    layout the chords of one staff and create the
+//    segment shapes of the staff
+//---------------------------------------------------------
+
+static void layoutStaffChords(Measure* measure, int staffIdx)
+      {
+      int strack = staffIdx * VOICES;
+      int etrack = strack + VOICES;
+      for (Segment& s : measure->segments()) {
+            if (s.isChordRestType()) {
+                  for (int track = strack; track < etrack; ++track) {
+                        Element* e = s.element(track);
+                        if (e && e->isChord()) {
+                              Chord* chord = toChord(e);
+                              chord->layout();
+                              if (chord->tremolo())
+                                    chord->tremolo()->layout();
+                              }
+                        }
+                  }
+            else if (s.isEndBarLineType())
+                  continue;
+            s.createShape(staffIdx);
+            }
+      }
+
 //---------------------------------------------------------
 //   getNextMeasure
 //---------------------------------------------------------
@@ -2808,6 +3083,11 @@ void Score::getNextMeasure(LayoutContext& lc)
 
       Measure* measure = toMeasure(lc.curMeasure);
       measure->moveTicks(lc.tick - measure->tick());
+      if (lc.frozen(measure)) {
+            lc.sig   = measure->len();
+            lc.tick += measure->ticks();
+            return;
+            }
       if (isMaster() && !lc.prevMeasure) {
             // this is the first measure of a score
             lc.sig = measure->len();
@@ -2861,10 +3141,47 @@ void Score::getNextMeasure(LayoutContext& lc)
 
       createBeams(measure);
 
-      for (int staffIdx = 0; staffIdx < score()->nstaves(); ++staffIdx) {
-            for (Segment& segment : measure->segments()) {
-                  if (segment.isChordRestType())
-                        layoutChords1(&segment, staffIdx);
+      //
+      // chords and segment shapes of a staff only depend on
+      // the staff; in parallel mode the staves are laid out
+      // on the global thread pool. Tablature layout adds and
+      // removes stems with undo commands and stays serial.
+      //
+      std::vector<int> staves;
+      std::vector<int> tabStaves;
+      if (MScore::parallelLayout && nstaves() > 1 && stavesIndependent(measure)) {
+            for (int staffIdx = 0; staffIdx < nstaves(); ++staffIdx) {
+                  if (staff(staffIdx)->isTabStaff())
+                        tabStaves.push_back(staffIdx);
+                  else
+                        staves.push_back(staffIdx);
+                  }
+            }
+      bool parallel = staves.size() > 1;
+
+      if (parallel) {
+            TRACE_SPAN_ARG("Score::layoutChords1", "layout", "staves", int(staves.size()));
+            // the dots are created and removed with undo commands
+            // by layoutChords3(); push them here
+            for (int staffIdx : staves) {
+                  for (Chord* c : staffChords(measure, staffIdx)) {
+                        for (Note* note : c->notes())
+                              note->updateDotCount();
+                        }
+                  }
+            QtConcurrent::blockingMap(staves, [this, measure](int staffIdx) {
+                  for (Segment& segment : measure->segments()) {
+                        if (segment.isChordRestType())
+                              layoutChords1(&segment, staffIdx);
+                        }
+                  });
+            }
+      else {
+            for (int staffIdx = 0; staffIdx < score()->nstaves(); ++staffIdx) {
+                  for (Segment& segment : measure->segments()) {
+                        if (segment.isChordRestType())
+                              layoutChords1(&segment, staffIdx);
+                        }
                   }
             }
 
@@ -2932,21 +3249,37 @@ void Score::getNextMeasure(LayoutContext& lc)
             sigmap()->add(lc.tick, SigEvent(lc.sig, measure->timesig(), measure->no()));
             }
 
-      for (Segment& s : measure->segments()) {
-            // DEBUG: relayout grace notes as beaming/flags may have changed
-            if (s.isChordRestType()) {
-                  for (Element* e : s.elist()) {
-                        if (e && e->isChord()) {
-                              Chord* chord = toChord(e);
-                              chord->layout();
-                              if (chord->tremolo())            // debug
-                                    chord->tremolo()->layout();
+      if (parallel) {
+            TRACE_SPAN_ARG("Score::layoutStaffChords", "layout", "staves", int(staves.size()));
+            // Chord::layout() removes the hook of a beamed chord
+            // with an undo command
+            for (int staffIdx : staves) {
+                  for (Chord* c : staffChords(measure, staffIdx)) {
+                        if (c->hook() && c->beam())
+                              undoRemoveElement(c->hook());
+                        }
+                  }
+            QtConcurrent::blockingMap(staves, [measure](int staffIdx) { layoutStaffChords(measure, staffIdx); });
+            for (int staffIdx : tabStaves)
+                  layoutStaffChords(measure, staffIdx);
+            }
+      else {
+            for (Segment& s : measure->segments()) {
+                  // DEBUG: relayout grace notes as beaming/flags may have changed
+                  if (s.isChordRestType()) {
+                        for (Element* e : s.elist()) {
+                              if (e && e->isChord()) {
+                                    Chord* chord = toChord(e);
+                                    chord->layout();
+                                    if (chord->tremolo())            // debug
+                                          chord->tremolo()->layout();
+                                    }
                               }
                         }
+                  else if (s.isEndBarLineType())
+                        continue;
+                  s.createShapes();
                   }
-            else if (s.isEndBarLineType())
-                  continue;
-            s.createShapes();
             }
 
       lc.tick += measure->ticks();
@@ -2996,6 +3329,31 @@ static bool notTopBeam(ChordRest* cr)
       return false;
       }
 
+//---------------------------------------------------------
+//   layoutBeams
+//    layout the beams starting in a measure which was
+//    moved but not laid out again
+//---------------------------------------------------------
+
+static void layoutBeams(Measure* m)
+      {
+      for (Segment* s = m->first(Segment::Type::ChordRest); s; s = s->next(Segment::Type::ChordRest)) {
+            for (Element* e : s->elist()) {
+                  if (!e || !e->isChordRest())
+                        continue;
+                  ChordRest* cr = toChordRest(e);
+                  if (isTopBeam(cr) || notTopBeam(cr))
+                        cr->beam()->layout();
+                  if (cr->isChord()) {
+                        for (Chord* cc : toChord(cr)->graceNotes()) {
+                              if (cc->beam() && cc->beam()->elements().front() == cc)
+                                    cc->beam()->layout();
+                              }
+                        }
+                  }
+            }
+      }
+
 //---------------------------------------------------------
 //   findLyricsMaxY
 //---------------------------------------------------------
@@ -3142,6 +3500,7 @@ static void applyLyricsMin(Measure* m, int staffIdx, qreal yMax)
 
 System* Score::collectSystem(LayoutContext& lc)
       {
+      TRACE_SPAN("Score::collectSystem", "layout");
       if (!lc.curMeasure) {
             lc.curSystem = 0;
             return 0;
@@ -3174,6 +3533,10 @@ System* Score::collectSystem(LayoutContext& lc)
 
             if (lc.curMeasure->isHBox())
                   ww = point(toHBox(lc.curMeasure)->boxWidth());
+            else if (lc.curMeasure->isMeasure() && lc.frozen(lc.curMeasure)) {
+                  firstMeasure = false;
+                  ww = toMeasure(lc.curMeasure)->width();
+                  }
             else if (lc.curMeasure->isMeasure()) {
                   Measure* m = toMeasure(lc.curMeasure);
 
@@ -3216,7 +3579,8 @@ System* Score::collectSystem(LayoutContext& lc)
                   break;
                   }
 
-            if (lc.prevMeasure && lc.prevMeasure->isMeasure() && lc.prevMeasure->system() == system) {
+            if (lc.prevMeasure && lc.prevMeasure->isMeasure() && lc.prevMeasure->system() == system
+               && !lc.frozen(lc.prevMeasure)) {
                   Measure* m = toMeasure(lc.prevMeasure);
                   qreal v    = m->createEndBarLines(false);
                   qreal stretch = m->userStretch() * measureSpacing;
@@ -3416,9 +3780,16 @@ System* Score::collectSystem(LayoutContext& lc)
             }
 
       QPointF pos(system->leftMargin(), 0.0);
+      qreal lineShift = 0.0;        // move of the frozen measures after the window
       for (MeasureBase* mb : system->measures()) {
             qreal ww = 0.0;
-            if (mb->isMeasure()) {
+            if (mb->isMeasure() && lc.frozen(mb)) {
+                  if (mb->tick() >= lc.lineStartTick)
+                        lineShift = pos.x() - mb->x();
+                  mb->setPos(pos);
+                  ww = mb->width();
+                  }
+            else if (mb->isMeasure()) {
                   mb->setPos(pos);
                   Measure* m = toMeasure(mb);
                   qreal stretch = m->userStretch();
@@ -3447,6 +3818,14 @@ System* Score::collectSystem(LayoutContext& lc)
             }
       if (lineMode)
             system->setWidth(pos.x());
+      system->updateMeasureOffsets();
+
+      for (SpannerSegment* ss : lc.frozenSegments) {
+            ss->setSystem(system);
+            if (lc.frozenAfter(ss->spanner()))
+                  ss->rxpos() += lineShift;
+            }
+      lc.frozenSegments.clear();
 
       //
       // layout
@@ -3465,6 +3844,13 @@ System* Score::collectSystem(LayoutContext& lc)
             if (stick == -1)
                   stick = mb->tick();
             etick = mb->endTick();
+            if (lc.frozen(mb)) {
+                  // segment shapes are complete, only beams are laid
+                  // out in system coordinates
+                  if (lineShift != 0.0 && mb->tick() >= lc.lineEndTick)
+                        layoutBeams(toMeasure(mb));
+                  continue;
+                  }
             for (Segment* s = toMeasure(mb)->first(Segment::Type::ChordRest); s; s = s->next(Segment::Type::ChordRest)) {
                   for (Element* e : s->elist()) {
                         if (e && e->isChordRest()) {
@@ -3527,7 +3913,7 @@ System* Score::collectSystem(LayoutContext& lc)
       switch (ar) {
             case VerticalAlignRange::MEASURE:
                   for (MeasureBase* mb : system->measures()) {
-                        if (!mb->isMeasure())
+                        if (!mb->isMeasure() || lc.frozen(mb))
                               continue;
                         Measure* m = toMeasure(mb);
                         for (int staffIdx = 0; staffIdx < nstaves(); ++staffIdx) {
@@ -3556,7 +3942,7 @@ System* Score::collectSystem(LayoutContext& lc)
                   break;
             case VerticalAlignRange::SEGMENT:
                   for (MeasureBase* mb : system->measures()) {
-                        if (!mb->isMeasure())
+                        if (!mb->isMeasure() || lc.frozen(mb))
                               continue;
                         Measure* m = toMeasure(mb);
                         for (int staffIdx = 0; staffIdx < nstaves(); ++staffIdx) {
@@ -3575,7 +3961,7 @@ System* Score::collectSystem(LayoutContext& lc)
 
       for (int si = 0; si < score()->nstaves(); ++si) {
             for (MeasureBase* mb : system->measures()) {
-                  if (!mb->isMeasure())
+                  if (!mb->isMeasure() || lc.frozen(mb))
                         continue;
                   Measure* m = toMeasure(mb);
                   m->staffShape(si).clear();
@@ -3590,17 +3976,27 @@ System* Score::collectSystem(LayoutContext& lc)
       //
 
       if (etick > stick) {    // ignore vbox
-            auto spanners = score()->spannerMap().findOverlapping(stick, etick);
+            int lstick = lc.lineWindow ? qMax(stick, lc.lineStartTick) : stick;
+            int letick = lc.lineWindow ? qMin(etick, lc.lineEndTick) : etick;
             std::vector<SpannerSegment*> voltaSegments;
-            for (auto interval : spanners) {
-                  Spanner* sp = interval.value;
-                  if (sp->tick() < etick && sp->tick2() > stick) {
-                        if (sp->isOttava() && sp->ticks() == 0) {       // sanity check?
-                              sp->setTick2(lastMeasure()->endTick());
-                              sp->staff()->updateOttava();
-                              }
-                        SpannerSegment* ss = sp->layoutSystem(system);     // create/layout spanner segment for this system
-                        if (ss->isVoltaSegment() && ss->autoplace())
+            if (letick > lstick) {
+                  auto spanners = score()->spannerMap().findOverlapping(lstick, letick);
+                  for (auto interval : spanners) {
+                        Spanner* sp = interval.value;
+                        if (sp->tick() < etick && sp->tick2() > stick && !lc.frozen(sp)) {
+                              if (sp->isOttava() && sp->ticks() == 0) {       // sanity check?
+                                    sp->setTick2(lastMeasure()->endTick());
+                                    sp->staff()->updateOttava();
+                                    }
+                              SpannerSegment* ss = sp->layoutSystem(system);     // create/layout spanner segment for this system
+                              if (ss->isVoltaSegment() && ss->autoplace())
+                                    voltaSegments.push_back(ss);
+                              }
+                        }
+                  }
+            if (lc.lineWindow) {
+                  for (SpannerSegment* ss : system->spannerSegments()) {
+                        if (ss->isVoltaSegment() && ss->autoplace() && lc.frozen(ss->spanner()))
                               voltaSegments.push_back(ss);
                         }
                   }
@@ -3615,7 +4011,7 @@ System* Score::collectSystem(LayoutContext& lc)
                         ss->setUserYoffset(y);
                   }
             for (Spanner* sp : _unmanagedSpanner) {
-                  if (sp->tick() >= etick || sp->tick2() < stick)
+                  if (sp->tick() >= etick || sp->tick2() < stick || lc.frozen(sp))
                         continue;
                   sp->layout();
                   }
@@ -3625,7 +4021,7 @@ System* Score::collectSystem(LayoutContext& lc)
             //
 
             for (MeasureBase* mb : system->measures()) {
-                  if (!mb->isMeasure())
+                  if (!mb->isMeasure() || lc.frozen(mb))
                         continue;
                   Measure* m = toMeasure(mb);
                   for (SpannerSegment* ss : system->spannerSegments()) {
@@ -3642,7 +4038,16 @@ System* Score::collectSystem(LayoutContext& lc)
                         }
                   }
             }
+      QVector<qreal> staffY;
+      if (lc.lineWindow) {
+            for (SysStaff* ss : *system->staves())
+                  staffY.append(ss->y());
+            }
       system->layout2();   // compute staff distances
+      for (int i = 0; i < staffY.size(); ++i) {
+            if (staffY[i] != system->staff(i)->y())
+                  lc.lineStavesMoved = true;    // frozen measures and spanners are out of date
+            }
 
       Measure* lm  = system->lastMeasure();
       if (lm) {
@@ -3650,6 +4055,7 @@ System* Score::collectSystem(LayoutContext& lc)
             lc.startWithLongNames = lc.firstSystem && lm->sectionBreak()->startWithLongNames();
             }
       lc.systemChanged      = lc.systemOldMeasure != (system->measures().empty() ? 0 : system->measures().back());
+      lc.curSystemLaidOut   = true;
       return system;
       }
 
@@ -3659,6 +4065,7 @@ System* Score::collectSystem(LayoutContext& lc)
 
 bool Score::collectPage(LayoutContext& lc)
       {
+      TRACE_SPAN("Score::collectPage", "layout");
       if (!lc.curSystem)
             return false;
 
@@ -3671,6 +4078,7 @@ bool Score::collectPage(LayoutContext& lc)
       qreal ey   = page->height() - page->bm();
       System* s1 = 0;               // previous system
       System* s2 = lc.curSystem;
+      QList<System*> dirtySystems;  // systems to update in the bsp tree
 
       for (;;) {
             //
@@ -3692,6 +4100,10 @@ bool Score::collectPage(LayoutContext& lc)
             s2->setPos(page->lm(), y);
             page->appendSystem(s2);
             y += s2->height();
+            // ties of the previous system can end in s2
+            if (lc.curSystemLaidOut || lc.prevSystemLaidOut)
+                  dirtySystems.append(s2);
+            lc.prevSystemLaidOut = lc.curSystemLaidOut;
 
             //
             //  check for page break or if next system will fit on page
@@ -3700,6 +4112,7 @@ bool Score::collectPage(LayoutContext& lc)
                   // take next system unchanged
                   System* s    = lc.systemList.empty() ? 0 : lc.systemList.takeFirst();
                   lc.curSystem = s;
+                  lc.curSystemLaidOut = false;
                   if (s)
                         _systems.append(lc.curSystem);
                   }
@@ -3738,6 +4151,8 @@ bool Score::collectPage(LayoutContext& lc)
                   Measure* m = toMeasure(mb);
                   if (stick == -1)
                         stick = m->tick();
+                  if (lc.frozen(m))
+                        continue;         // ties and spanners kept by collectSystem()
 
                   for (int track = 0; track < tracks; ++track) {
                         for (Segment* segment = m->first(); segment; segment = segment->next()) {
@@ -3785,7 +4200,8 @@ bool Score::collectPage(LayoutContext& lc)
                   m->layout2();
                   }
             }
-      page->rebuildBspTree();
+      for (System* s : dirtySystems)      // rebuilds fully if the page was reflowed
+            page->invalidateBspTree(s);
       lc.pageChanged = lc.systemChanged || (lc.pageOldSystem != (page->systems().empty() ? 0 : page->systems().back()));
       return true;
       }
@@ -3799,6 +4215,7 @@ bool Score::collectPage(LayoutContext& lc)
 
 void Score::doLayout()
       {
+      TRACE_SPAN("Score::doLayout", "layout");
 //      qDebug();
 
       if (_staves.empty() || first() == 0) {
@@ -3869,12 +4286,86 @@ void Score::doLayout()
 #endif
       }
 
+//---------------------------------------------------------
+//   layoutLinear
+//    Range layout in LayoutMode::LINE. The continuous view
+//    is one system; it is collected again, but only the
+//    measures of the range and one measure on either side
+//    are laid out. The other measures keep their layout
+//    and width and are moved, together with beams; the
+//    segments of ties and spanners outside of the range
+//    are kept and moved too.
+//    Returns false if the score has to be laid out
+//    completely, e.g. after measures were inserted or if
+//    the staff distances changed.
+//---------------------------------------------------------
+
+bool Score::layoutLinear(int stick, int etick)
+      {
+      if (_systems.size() != 1 || _pages.size() != 1)
+            return false;
+      System* system = _systems.front();
+
+      // the system must contain the measures the layout
+      // would collect, in the same order
+      const std::vector<MeasureBase*>& ml = system->measures();
+      size_t idx = 0;
+      for (MeasureBase* mb = _showVBox ? first() : firstMeasure(); mb; mb = _showVBox ? mb->next() : mb->nextMeasure()) {
+            if (mb->isVBox())
+                  continue;
+            if (idx >= ml.size() || ml[idx] != mb)
+                  return false;
+            ++idx;
+            }
+      if (idx != ml.size())
+            return false;
+
+      Measure* m1 = tick2measure(stick);
+      Measure* m2 = tick2measure(etick);
+      if (!m1 || !m2)
+            return false;
+      m1 = m1->prevMeasure();
+      m2 = m2->nextMeasure() ? m2->nextMeasure() : m2;
+      if (!m1 || m1 == firstMeasure())
+            return false;           // system header, tempo and time signature maps
+
+      TRACE_SPAN_ARG("Score::layoutLinear", "layout", "ticks", m2->endTick() - m1->tick());
+      _scoreFont     = ScoreFont::fontFactory(_style.value(StyleIdx::MusicalSymbolFont).toString());
+      _noteHeadWidth = _scoreFont->width(SymId::noteheadBlack, spatium() / SPATIUM20);
+
+      if (cmdState().layoutFlags & LayoutFlag::FIX_PITCH_VELO)
+            updateVelo();
+      if (cmdState().layoutFlags & LayoutFlag::PLAY_EVENTS)
+            createPlayEvents();
+
+      LayoutContext lc;
+      lc.lineWindow    = true;
+      lc.lineStartTick = m1->tick();
+      lc.lineEndTick   = m2->endTick();
+      _systems.swap(lc.systemList);
+      getNextMeasure(lc);
+      getNextMeasure(lc);
+
+      collectSystem(lc);
+      while (collectPage(lc))
+            ;
+      if (lc.lineStavesMoved)
+            return false;
+      Page* page = _pages[0];
+      page->setWidth(page->system(0)->width());
+
+      for (MuseScoreView* v : viewer)
+            v->layoutChanged();
+      return true;
+      }
+
 //---------------------------------------------------------
 //   doLayoutRange
 //---------------------------------------------------------
 
 void Score::doLayoutRange(int stick, int etick)
       {
+      TRACE_SPAN_ARG("Score::doLayoutRange", "layout", "ticks", etick - stick);
 //      qDebug("%d-%d", stick, etick);
       if (stick == -1 || etick == -1) {
             doLayout();
@@ -3882,17 +4373,12 @@ void Score::doLayoutRange(int stick, int etick)
             }
       if (stick < 0)
             stick = 0;
-      LayoutContext lc;
-
-#if 0
       if (_layoutMode == LayoutMode::LINE) {
-            _systems.swap(lc.systemList);
-            getNextMeasure(lc);
-            getNextMeasure(lc);
-            layoutLinear(lc);
+            if (!layoutLinear(stick, etick))
+                  doLayout();
             return;
             }
-#endif
+      LayoutContext lc;
 
       lc.rangeLayout = true;
       lc.rangeDone   = false;
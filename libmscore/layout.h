@@ -16,6 +16,8 @@
 namespace Ms {
 
 class Segment;
+class Spanner;
+class SpannerSegment;
 
 //---------------------------------------------------------
 //   LayoutContext
@@ -31,6 +33,8 @@ struct LayoutContext {
 
       QList<System*> systemList;          // reusable systems
       System* curSystem        { 0 };
+      bool curSystemLaidOut    { false };  // curSystem was collected, not taken unchanged
+      bool prevSystemLaidOut   { false };
       MeasureBase* systemOldMeasure;
       bool rangeDone           { false };
       System* pageOldSystem    { 0 };
@@ -44,7 +48,19 @@ struct LayoutContext {
       bool rangeLayout         { false };
       int endTick;
 
+      // LayoutMode::LINE range layout: measures outside of
+      // [lineStartTick, lineEndTick) keep their layout and
+      // are only moved, see Score::layoutLinear()
+      bool lineWindow          { false };
+      int lineStartTick        { 0 };
+      int lineEndTick          { 0 };
+      bool lineStavesMoved     { false };
+      QList<SpannerSegment*> frozenSegments;    // kept by getNextSystem()
+
       int adjustMeasureNo(MeasureBase*);
+      bool frozen(const MeasureBase*) const;
+      bool frozen(const Spanner*) const;
+      bool frozenAfter(const Spanner*) const;
       };
 
 //---------------------------------------------------------
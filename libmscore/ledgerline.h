@@ -31,6 +31,8 @@ class Chord;
 class LedgerLine : public Line {
       Q_OBJECT
 
+      POOLED_ELEMENT(LedgerLine)
+
       LedgerLine* _next;
 
    public:
@@ -62,6 +62,7 @@ namespace Ms {
 
 bool MScore::debugMode;
 bool MScore::testMode = false;
+bool MScore::parallelLayout = false;
 
 // #ifndef NDEBUG
 bool MScore::showSegmentShapes   = false;
@@ -109,6 +110,7 @@ int     MScore::mtcType;
 bool    MScore::noExcerpts = false;
 bool    MScore::noImages = false;
 bool    MScore::pdfPrinting = false;
+bool    MScore::printGlyphPaths = false;
 
 #ifdef SCRIPT_INTERFACE
 QQmlEngine* MScore::_qml = 0;
@@ -490,6 +490,7 @@ class MScore : public QObject {
       static qreal nudgeStep50;
       static int defaultPlayDuration;
       static QString lastError;
+      static bool parallelLayout;         // lay out the staves of a measure on the global thread pool
 
 // #ifndef NDEBUG
       static bool noHorizontalStretch;
@@ -514,6 +515,7 @@ class MScore : public QObject {
       static bool noImages;
 
       static bool pdfPrinting;
+      static bool printGlyphPaths;        // print score font symbols as cached outlines
 
       static qreal verticalPageGap;
       static qreal horizontalPageGapEven;
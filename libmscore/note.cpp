@@ -1646,10 +1646,21 @@ void Note::setDotY(Direction pos)
 
       // apply to dots
 
-      int cdots = chord()->dots();
-      int ndots = _dots.size();
+      updateDotCount();
+      for (NoteDot* dot : _dots) {
+            dot->layout();
+            dot->rypos() = y;
+            }
+      }
 
-      int n = cdots - ndots;
+//---------------------------------------------------------
+//   updateDotCount
+//    add or remove dots to match the chord duration
+//---------------------------------------------------------
+
+void Note::updateDotCount()
+      {
+      int n = chord()->dots() - _dots.size();
       for (int i = 0; i < n; ++i) {
             NoteDot* dot = new NoteDot(score());
             dot->setParent(this);
@@ -1661,10 +1672,6 @@ void Note::setDotY(Direction pos)
             for (int i = 0; i < -n; ++i)
                   score()->undoRemoveElement(_dots.back());
             }
-      for (NoteDot* dot : _dots) {
-            dot->layout();
-            dot->rypos() = y;
-            }
       }
 
 //---------------------------------------------------------
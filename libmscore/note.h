@@ -183,6 +183,8 @@ class Note : public Element {
 //TODO-WS      Q_ENUMS(Ms::MScore::Direction)
       Q_ENUMS(Ms::MScore::DirectionH)
 
+      POOLED_ELEMENT(Note)
+
    public:
       enum class ValueType : char { OFFSET_VAL, USER_VAL };
       int qmlAccidentalType() const { return int(accidentalType()); }
@@ -441,6 +443,7 @@ class Note : public Element {
       void setMark(bool v) const      { _mark = v;   }
       virtual void setScore(Score* s) override;
       void setDotY(Direction);
+      void updateDotCount();
 
       void addBracket();
 
@@ -26,6 +26,8 @@ class Note;
 class NoteDot : public Element {
       Q_OBJECT
 
+      POOLED_ELEMENT(NoteDot)
+
    public:
       NoteDot(Score* = 0);
       virtual NoteDot* clone() const override     { return new NoteDot(*this); }
@@ -140,8 +140,7 @@ Page::~Page()
 QList<Element*> Page::items(const QRectF& r)
       {
 #ifdef USE_BSP
-      if (!bspTreeValid)
-            doRebuildBspTree();
+      updateBspTree();
       QList<Element*> el = bspTree.items(r);
       return el;
 #else
@@ -153,8 +152,7 @@ QList<Element*> Page::items(const QRectF& r)
 QList<Element*> Page::items(const QPointF& p)
       {
 #ifdef USE_BSP
-      if (!bspTreeValid)
-            doRebuildBspTree();
+      updateBspTree();
       return bspTree.items(p);
 #else
       Q_UNUSED(p)
@@ -449,30 +447,79 @@ void PageFormat::write(Xml& xml) const
       }
 
 #ifdef USE_BSP
+//---------------------------------------------------------
+//   BspScanData
+//---------------------------------------------------------
+
+struct BspScanData {
+      Page* page;
+      System* system;
+      QVector<Element*>* items;
+      };
+
 //---------------------------------------------------------
 //   bspInsert
+//    used for full rebuild
 //---------------------------------------------------------
 
-static void bspInsert(void* bspTree, Element* e)
+void Page::bspInsert(void* data, Element* e)
       {
-      ((BspTree*) bspTree)->insert(e);
+      BspScanData* d = static_cast<BspScanData*>(data);
+      Page* page     = d->page;
+      auto i = page->bspItems.find(e);
+      if (i != page->bspItems.end() && i->generation == page->bspGeneration)
+            return;
+      QRectF r = e->pageBoundingRect();
+      page->bspTree.insert(e, r);
+      page->bspItems.insert(e, BspItem { r, d->system, page->bspGeneration });
+      d->items->append(e);
       }
 
+//---------------------------------------------------------
+//   bspUpdate
+//    used for incremental update; only elements whose
+//    bounding box changed are re-inserted
+//---------------------------------------------------------
+
+void Page::bspUpdate(void* data, Element* e)
+      {
+      BspScanData* d = static_cast<BspScanData*>(data);
+      Page* page     = d->page;
+      QRectF r       = e->pageBoundingRect();
+      auto i = page->bspItems.find(e);
+      if (i == page->bspItems.end()) {
+            page->bspTree.insert(e, r);
+            page->bspItems.insert(e, BspItem { r, d->system, page->bspGeneration });
+            }
+      else {
+            if (i->generation == page->bspGeneration)
+                  return;
+            if (i->rect != r) {
+                  page->bspTree.remove(e, i->rect);
+                  page->bspTree.insert(e, r);
+                  i->rect = r;
+                  }
+            i->system     = d->system;
+            i->generation = page->bspGeneration;
+            }
+      d->items->append(e);
+      }
+
+//---------------------------------------------------------
+//   countElements
+//---------------------------------------------------------
+
 static void countElements(void* data, Element* /*e*/)
       {
       ++(*(int*)data);
       }
 
 //---------------------------------------------------------
-//   doRebuildBspTree
+//   bspTreeRect
 //---------------------------------------------------------
 
-void Page::doRebuildBspTree()
+QRectF Page::bspTreeRect() const
       {
-      int n = 0;
-      scanElements(&n, countElements, false);
-
-      QRectF r;
       if (score()->layoutMode() == LayoutMode::LINE) {
             qreal w = 0.0;
             qreal h = 0.0;
@@ -483,14 +530,130 @@ void Page::doRebuildBspTree()
                         w = mb->x() + mb->width();
                         }
                   }
-            r = QRectF(0.0, 0.0, w, h);
+            return QRectF(0.0, 0.0, w, h);
             }
-      else
-            r = abbox();
+      return abbox();
+      }
+
+//---------------------------------------------------------
+//   bspNeedsRebuild
+//    return true if the page was reflowed since the last
+//    full rebuild: systems were added, removed or moved,
+//    the page geometry changed or the tree is too
+//    unbalanced for the number of items
+//---------------------------------------------------------
+
+bool Page::bspNeedsRebuild() const
+      {
+      if (_systems != bspSystems)
+            return true;
+      for (int i = 0; i < _systems.size(); ++i) {
+            if (_systems[i]->pos() != bspSystemPos[i])
+                  return true;
+            }
+      if (bspTreeRect() != bspTree.boundingRect())
+            return true;
+      return bspItems.size() > 2 * bspBuildCount + 64;
+      }
 
-      bspTree.initialize(r, n);
-      scanElements(&bspTree, &bspInsert, false);
-      bspTreeValid = true;
+//---------------------------------------------------------
+//   invalidateBspTree
+//    mark system s (or all systems of the page if s is 0)
+//    as changed; on next query only elements of the marked
+//    systems are checked and re-inserted if their bounding
+//    box changed
+//---------------------------------------------------------
+
+void Page::invalidateBspTree(System* s)
+      {
+      if (!bspTreeValid)
+            return;
+      if (!s) {
+            bspDirtySystems = _systems;
+            return;
+            }
+      if (!bspDirtySystems.contains(s))
+            bspDirtySystems.append(s);
+      }
+
+//---------------------------------------------------------
+//   updateBspTree
+//---------------------------------------------------------
+
+void Page::updateBspTree()
+      {
+      if (bspTreeValid && bspNeedsRebuild())
+            bspTreeValid = false;
+      if (!bspTreeValid)
+            doRebuildBspTree();
+      else {
+            for (System* s : bspDirtySystems)
+                  doUpdateBspTree(s);
+            }
+      bspDirtySystems.clear();
+      }
+
+//---------------------------------------------------------
+//   doUpdateBspTree
+//---------------------------------------------------------
+
+void Page::doUpdateBspTree(System* s)
+      {
+      ++bspGeneration;
+      QVector<Element*> oldItems = bspSystemItems.take(s);
+      QVector<Element*> items;
+      items.reserve(oldItems.size());
+      BspScanData data { this, s, &items };
+      if (_systems.contains(s)) {
+            for (MeasureBase* m : s->measures())
+                  m->scanElements(&data, bspUpdate, false);
+            s->scanElements(&data, bspUpdate, false);
+            }
+      // remove elements which are gone; they may be deleted already
+      // and must not be dereferenced
+      for (Element* e : oldItems) {
+            auto i = bspItems.find(e);
+            if (i != bspItems.end() && i->system == s && i->generation != bspGeneration) {
+                  bspTree.remove(e, i->rect);
+                  bspItems.erase(i);
+                  }
+            }
+      bspSystemItems.insert(s, items);
+      }
+
+//---------------------------------------------------------
+//   doRebuildBspTree
+//---------------------------------------------------------
+
+void Page::doRebuildBspTree()
+      {
+      int n = 0;
+      scanElements(&n, countElements, false);
+      bspTree.initialize(bspTreeRect(), n);
+
+      ++bspGeneration;
+      bspItems.clear();
+      bspSystemItems.clear();
+      bspSystems = _systems;
+      bspSystemPos.clear();
+
+      for (System* s : _systems) {
+            BspScanData data { this, s, &bspSystemItems[s] };
+            for (MeasureBase* m : s->measures())
+                  m->scanElements(&data, bspInsert, false);
+            s->scanElements(&data, bspInsert, false);
+            bspSystemPos.append(s->pos());
+            }
+      QVector<Element*> pageItems;
+      BspScanData data { this, 0, &pageItems };
+      bspInsert(&data, this);
+
+      bspBuildCount = bspItems.size();
+      bspTreeValid  = true;
+      }
+#else
+void Page::invalidateBspTree(System*)
+      {
       }
 #endif
 
@@ -128,8 +128,27 @@ class Page : public Element {
       QList<System*> _systems;
       int _no;                      // page number
 #ifdef USE_BSP
+      struct BspItem {
+            QRectF rect;            // rectangle used for insertion
+            System* system;         // owning system, 0 for the page itself
+            int generation;         // last update this item was seen in
+            };
       BspTree bspTree;
+      QHash<Element*, BspItem> bspItems;
+      QHash<System*, QVector<Element*>> bspSystemItems;
+      QList<System*> bspDirtySystems;     // systems to re-scan on next query
+      QList<System*> bspSystems;          // page systems at last full rebuild
+      QList<QPointF> bspSystemPos;
+      int bspGeneration { 0 };
+      int bspBuildCount { 0 };            // number of items at last full rebuild
+
+      QRectF bspTreeRect() const;
+      bool bspNeedsRebuild() const;
       void doRebuildBspTree();
+      void doUpdateBspTree(System*);
+      void updateBspTree();
+      static void bspInsert(void* data, Element* e);
+      static void bspUpdate(void* data, Element* e);
 #endif
       bool bspTreeValid;
 
@@ -165,6 +184,7 @@ class Page : public Element {
       QList<Element*> items(const QRectF& r);
       QList<Element*> items(const QPointF& p);
       void rebuildBspTree()   { bspTreeValid = false; }
+      void invalidateBspTree(System* s = 0);
       QPointF pagePos() const { return QPointF(); }     ///< position in page coordinates
       QList<System*> searchSystem(const QPointF& pos) const;
       Measure* searchMeasure(const QPointF& p) const;
@@ -279,6 +279,20 @@ const char* propertyName(P_ID id)
       return propertyList[int(id)].name;
       }
 
+//---------------------------------------------------------
+//   propertyId
+//    P_ID::END if there is no property of that name
+//---------------------------------------------------------
+
+P_ID propertyId(const QString& name)
+      {
+      for (const PropertyData& pd : propertyList) {
+            if (name == pd.name)
+                  return pd.id;
+            }
+      return P_ID::END;
+      }
+
 //---------------------------------------------------------
 //    getProperty
 //---------------------------------------------------------
@@ -277,6 +277,7 @@ enum class P_TYPE : char {
 extern QVariant getProperty(P_ID type, XmlReader& e);
 extern P_TYPE propertyType(P_ID);
 extern const char* propertyName(P_ID);
+extern P_ID propertyId(const QString& name);
 extern bool propertyLink(P_ID id);
 
 }     // namespace Ms
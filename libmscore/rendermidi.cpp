@@ -49,6 +49,7 @@
 #include "segment.h"
 #include "undo.h"
 #include "utils.h"
+#include "trace.h"
 
 namespace Ms {
 
@@ -1695,6 +1696,7 @@ void Score::renderMetronome(EventMap* events, Measure* m, int tickOffset)
 
 void Score::renderMidi(EventMap* events)
       {
+      TRACE_SPAN("Score::renderMidi", "midi");
       updateSwing();
       createPlayEvents();
 
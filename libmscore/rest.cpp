@@ -29,6 +29,8 @@
 #include "stafftype.h"
 #include "icon.h"
 #include "image.h"
+#include "system.h"
+#include "page.h"
 
 namespace Ms {
 
@@ -175,7 +177,9 @@ QRectF Rest::drag(EditData* data)
             s.rx() = xDragRange * (s.x() < 0 ? -1.0 : 1.0);
       setUserOff(QPointF(s.x(), s.y()));
       layout();
-      score()->rebuildBspTree();
+      System* s = measure()->system();
+      if (s && s->page())
+            s->page()->invalidateBspTree(s);
       return abbox() | r;
       }
 
@@ -30,6 +30,8 @@ class Rest : public ChordRest {
       Q_OBJECT
       Q_PROPERTY(bool  isFullMeasure  READ isFullMeasureRest)
 
+      POOLED_ELEMENT(Rest)
+
       // values calculated by layout:
       SymId _sym;
       int dotline    { -1  };       // depends on rest symbol
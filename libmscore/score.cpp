@@ -1388,6 +1388,7 @@ void Score::removeElement(Element* element)
       {
       Element* parent = element->parent();
       setLayout(element->tick());
+      invalidateBspTree(element);         // before the element is unlinked
 
 //      qDebug("Score(%p) Element(%p)(%s) parent %p(%s)",
 //         this, element, element->name(), parent, parent ? parent->name() : "");
@@ -3348,6 +3349,26 @@ Cursor* Score::newCursor()
       {
       return new Cursor(this);
       }
+
+//---------------------------------------------------------
+//   changeProperty
+//---------------------------------------------------------
+
+void Score::changeProperty(const QVariantList& elements, const QString& name, const QVariant& value)
+      {
+      P_ID id = propertyId(name);
+      if (id == P_ID::END) {
+            qDebug("Score::changeProperty: unknown property <%s>", qPrintable(name));
+            return;
+            }
+      QList<Element*> el;
+      for (const QVariant& v : elements) {
+            Element* e = qobject_cast<Element*>(v.value<QObject*>());
+            if (e)
+                  el.append(e);
+            }
+      undoChangeProperty(el, id, value);
+      }
 #endif
 
 //---------------------------------------------------------
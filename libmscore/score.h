@@ -91,6 +91,7 @@ struct Channel;
 struct Interval;
 struct TEvent;
 struct LayoutContext;
+struct PropertyChange;
 
 enum class ClefType : signed char;
 enum class BeatType : char;
@@ -256,12 +257,17 @@ enum class UpdateMode {
 //    the following variables are reset on startCmd()
 //    modified during cmd processing and used in endCmd() to
 //    determine what to layout and what to repaint:
+//
+//    while locked, layout and update requests are ignored
+//    and the state is not written; used when elements are
+//    created on worker threads (see createExcerpts())
 //---------------------------------------------------------
 
 class CmdState {
       UpdateMode _updateMode { UpdateMode::DoNothing };
       int _startTick {-1};            // start tick for mode LayoutTick
       int _endTick   {-1};              // end tick for mode LayoutTick
+      bool _locked   { false };
 
    public:
       LayoutFlags layoutFlags;
@@ -280,6 +286,9 @@ class CmdState {
       void setTick(int t);
       int startTick() const    { return _startTick; }
       int endTick() const      { return _endTick; }
+      void lock()              { _locked = true;  }
+      void unlock()            { _locked = false; }
+      bool locked() const      { return _locked; }
       };
 
 class UpdateState {
@@ -535,6 +544,8 @@ class Score : public QObject, public ScoreElement {
       virtual const char* name() const override { return "Score"; }
 
       void rebuildBspTree();
+      void invalidateBspTree();
+      void invalidateBspTree(Element*);
       bool noStaves() const         { return _staves.empty(); }
       void insertPart(Part*, int);
       void removePart(Part*);
@@ -605,6 +616,8 @@ class Score : public QObject, public ScoreElement {
       void undoChangeKeySig(Staff* ostaff, int tick, KeySigEvent);
       void undoChangeClef(Staff* ostaff, Segment*, ClefType st);
       void undoChangeProperty(ScoreElement*, P_ID, const QVariant&, PropertyStyle ps = PropertyStyle::NOSTYLE);
+      void undoChangeProperty(const QList<Element*>&, P_ID, const QVariant&, PropertyStyle ps = PropertyStyle::NOSTYLE);
+      void undoChangeProperties(P_ID, const std::vector<PropertyChange>&);
       void undoPropertyChanged(Element*, P_ID, const QVariant& v);
       void undoPropertyChanged(ScoreElement*, P_ID, const QVariant& v);
       inline virtual UndoStack* undoStack() const;
@@ -935,7 +948,7 @@ class Score : public QObject, public ScoreElement {
 
       void doLayout();
       void doLayoutRange(int, int);
-      void layoutLinear(LayoutContext& lc);
+      bool layoutLinear(int stick, int etick);
 
       void layoutSystemsUndoRedo();
       void layoutPagesUndoRedo();
@@ -1020,6 +1033,8 @@ class Score : public QObject, public ScoreElement {
       Q_INVOKABLE void addText(const QString&, const QString&);
       //@ creates and returns a cursor to be used to navigate the score
       Q_INVOKABLE Ms::Cursor* newCursor();
+      //@ sets the property 'name' (as in the score file) of all elements to 'value' as one undo step
+      Q_INVOKABLE void changeProperty(const QVariantList& elements, const QString& name, const QVariant& value);
 #endif
       qreal computeMinWidth(Segment* fs, bool isFirstMeasureInSystem);
       void updateBarLineSpans(int idx, int linesOld, int linesNew);
@@ -1041,6 +1056,8 @@ class Score : public QObject, public ScoreElement {
       ChordRest* findCR(int tick, int track) const;
       ChordRest* findCRinStaff(int tick, int staffIdx) const;
       void layoutSpanner();
+      void layoutSpanner(int stick, int etick);
+      void layoutSpanner(Beam*);
       void insertTime(int tickPos, int tickLen);
 
       ScoreFont* scoreFont() const            { return _scoreFont;     }
@@ -1169,7 +1186,7 @@ class MasterScore : public Score {
       virtual void setLayoutAll() override                  { _cmdState.setUpdateMode(UpdateMode::LayoutAll);  }
       virtual void setLayout(int t) override                { _cmdState.setTick(t); }
       virtual CmdState& cmdState() override                 { return _cmdState; }
-      virtual void addLayoutFlags(LayoutFlags val) override { _cmdState.layoutFlags |= val; }
+      virtual void addLayoutFlags(LayoutFlags val) override { if (!_cmdState.locked()) _cmdState.layoutFlags |= val; }
       virtual void setInstrumentsChanged(bool val) override { _cmdState._instrumentsChanged = val; }
 
       void setExcerptsChanged(bool val)     { _cmdState._excerptsChanged = val; }
@@ -46,6 +46,7 @@
 #include "imageStore.h"
 #include "audio.h"
 #include "barline.h"
+#include "trace.h"
 #include "thirdparty/qzip/qzipreader_p.h"
 #include "thirdparty/qzip/qzipwriter_p.h"
 #ifdef Q_OS_WIN
@@ -503,6 +504,7 @@ QImage Score::createThumbnail()
 
 void Score::saveCompressedFile(QIODevice* f, QFileInfo& info, bool onlySelection)
       {
+      TRACE_SPAN("Score::saveCompressedFile", "file");
       MQZipWriter uz(f);
 
       QString fn = info.completeBaseName() + ".mscx";
@@ -659,6 +661,7 @@ extern bool enableTestMode;
 
 void Score::saveFile(QIODevice* f, bool msczFormat, bool onlySelection)
       {
+      TRACE_SPAN("Score::saveFile", "file");
       if(!MScore::testMode)
             MScore::testMode = enableTestMode;
       Xml xml(f);
@@ -804,6 +807,7 @@ Score::FileError MasterScore::loadCompressedMsc(QIODevice* io, bool ignoreVersio
 
 Score::FileError MasterScore::loadMsc(QString name, bool ignoreVersionError)
       {
+      TRACE_SPAN("MasterScore::loadMsc", "file");
       fileInfo()->setFile(name);
 
       QFile f(name);
@@ -822,6 +826,7 @@ Score::FileError MasterScore::loadMsc(QString name, bool ignoreVersionError)
 
 Score::FileError MasterScore::loadMsc(QString name, QIODevice* io, bool ignoreVersionError)
       {
+      TRACE_SPAN("MasterScore::loadMsc", "file");
       fileInfo()->setFile(name);
 
       if (name.endsWith(".mscz"))
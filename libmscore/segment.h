@@ -66,6 +66,8 @@ class Segment : public Element {
       Q_PROPERTY(int                tick              READ tick)
       Q_ENUMS(Type)
 
+      POOLED_ELEMENT(Segment)
+
    public:
       // Type need to be in the order in which they appear in a measure
       enum class Type {
@@ -393,44 +393,47 @@ bool SelectionFilter::canSelectVoice(int track) const
 //   appendFiltered
 //---------------------------------------------------------
 
-void Selection::appendFiltered(Element* e)
+void Selection::appendFiltered(Element* e, QList<Element*>& l)
       {
       if (selectionFilter().canSelect(e))
-            _el.append(e);
+            l.append(e);
       }
 
 //---------------------------------------------------------
 //   appendChord
+//    beams is the set of beams already in the selection
 //---------------------------------------------------------
 
-void Selection::appendChord(Chord* chord)
+void Selection::appendChord(Chord* chord, QList<Element*>& l, QSet<Element*>& beams)
       {
-      if (chord->beam() && !_el.contains(chord->beam()))
-            _el.append(chord->beam());
+      if (chord->beam() && !beams.contains(chord->beam())) {
+            beams.insert(chord->beam());
+            l.append(chord->beam());
+            }
       if (chord->stem())
-            _el.append(chord->stem());
+            l.append(chord->stem());
       if (chord->hook())
-            _el.append(chord->hook());
+            l.append(chord->hook());
       if (chord->arpeggio())
-            appendFiltered(chord->arpeggio());
+            appendFiltered(chord->arpeggio(), l);
       if (chord->stemSlash())
-            _el.append(chord->stemSlash());
+            l.append(chord->stemSlash());
       if (chord->tremolo())
-            appendFiltered(chord->tremolo());
+            appendFiltered(chord->tremolo(), l);
       for (Note* note : chord->notes()) {
-            _el.append(note);
-            if (note->accidental()) _el.append(note->accidental());
+            l.append(note);
+            if (note->accidental()) l.append(note->accidental());
             foreach(Element* el, note->el())
-                  appendFiltered(el);
+                  appendFiltered(el, l);
             for (NoteDot* dot : note->dots())
-                  _el.append(dot);
+                  l.append(dot);
 
             if (note->tieFor() && (note->tieFor()->endElement() != 0)) {
                   if (note->tieFor()->endElement()->type() == Element::Type::NOTE) {
                         Note* endNote = static_cast<Note*>(note->tieFor()->endElement());
                         Segment* s = endNote->chord()->segment();
                         if (_endSegment && (s->tick() < _endSegment->tick()))
-                              _el.append(note->tieFor());
+                              l.append(note->tieFor());
                         }
                   }
             }
@@ -438,6 +441,10 @@ void Selection::appendChord(Chord* chord)
 
 //---------------------------------------------------------
 //   updateSelectedElements
+//    The segments of the range are visited once; elements
+//    are collected per track and concatenated, so the list
+//    is ordered by track and then by segment. Spanners are
+//    found with an interval query.
 //---------------------------------------------------------
 
 void Selection::updateSelectedElements()
@@ -456,48 +463,74 @@ void Selection::updateSelectedElements()
             }
       int startTrack = _staffStart * VOICES;
       int endTrack   = _staffEnd * VOICES;
+      int tracks     = endTrack - startTrack;
+
+      std::vector<QList<Element*>> trackElements(tracks);
+      std::vector<bool> selectableTrack(tracks);
+      for (int i = 0; i < tracks; ++i)
+            selectableTrack[i] = canSelectVoice(startTrack + i);
+      QSet<Element*> beams;
 
-      for (int st = startTrack; st < endTrack; ++st) {
-            if (!canSelectVoice(st))
+      for (Segment* s = _startSegment; s && (s != _endSegment); s = s->next1MM()) {
+            if (s->isEndBarLineType())  // do not select end bar line
                   continue;
-            for (Segment* s = _startSegment; s && (s != _endSegment); s = s->next1MM()) {
-                  if (s->isEndBarLineType())  // do not select end bar line
+            for (Element* e : s->annotations()) {
+                  int i = e->track() - startTrack;
+                  if (i < 0 || i >= tracks || !selectableTrack[i])
                         continue;
-                  for (Element* e : s->annotations()) {
-                        if (e->track() != st)
-                              continue;
-                        // if (e->systemFlag()) //exclude system text  // ws: why?
-                        //      continue;
-                        appendFiltered(e);
-                        }
-                  Element* e = s->element(st);
+                  // if (e->systemFlag()) //exclude system text  // ws: why?
+                  //      continue;
+                  appendFiltered(e, trackElements[i]);
+                  }
+            for (int i = 0; i < tracks; ++i) {
+                  if (!selectableTrack[i])
+                        continue;
+                  Element* e = s->element(startTrack + i);
                   if (!e || e->generated() || e->type() == Element::Type::TIMESIG || e->type() == Element::Type::KEYSIG)
                         continue;
+                  QList<Element*>& l = trackElements[i];
                   if (e->isChordRest()) {
                         ChordRest* cr = toChordRest(e);
                         for (Element* e : cr->lyrics()) {
                               if (e)
-                                    appendFiltered(e);
+                                    appendFiltered(e, l);
                               }
                         for (Articulation* art : cr->articulations())
-                              appendFiltered(art);
+                              appendFiltered(art, l);
                         }
                   if (e->isChord()) {
                         Chord* chord = toChord(e);
                         for (Chord* graceNote : chord->graceNotes())
-                              if (canSelect(graceNote)) appendChord(graceNote);
-                        appendChord(chord);
+                              if (canSelect(graceNote)) appendChord(graceNote, l, beams);
+                        appendChord(chord, l, beams);
                         }
                   else {
-                        appendFiltered(e);
+                        appendFiltered(e, l);
                         }
                   }
             }
+      int n = 0;
+      for (const QList<Element*>& l : trackElements)
+            n += l.size();
+      _el.reserve(n);
+      for (const QList<Element*>& l : trackElements)
+            _el.append(l);
+
+      if (!_startSegment) {
+            update();
+            return;
+            }
       int stick = startSegment()->tick();
       int etick = tickEnd();
 
-      for (auto i = _score->spanner().begin(); i != _score->spanner().end(); ++i) {
-            Spanner* sp = (*i).second;
+      // the interval query returns the spanners in tree order,
+      // sort them by start tick like the spanner map
+      std::vector<Spanner*> spanners;
+      for (const ::Interval<Spanner*>& i : _score->spannerMap().findOverlapping(stick, etick))
+            spanners.push_back(i.value);
+      std::stable_sort(spanners.begin(), spanners.end(), [](Spanner* a, Spanner* b) { return a->tick() < b->tick(); });
+
+      for (Spanner* sp : spanners) {
             // ignore spanners belonging to other tracks
             if (sp->track() < startTrack || sp->track() >= endTrack)
                   continue;
@@ -510,10 +543,10 @@ void Selection::updateSelectedElements()
                         continue;
                   if ((sp->tick() >= stick && sp->tick() < etick) || (sp->tick2() >= stick && sp->tick2() < etick))
                         if (canSelect(sp->startCR()) && canSelect(sp->endCR()))
-                              appendFiltered(sp);     // slur with start or end in range selection
+                              appendFiltered(sp, _el);     // slur with start or end in range selection
             }
             else if ((sp->tick() >= stick && sp->tick() < etick) && (sp->tick2() >= stick && sp->tick2() <= etick))
-                  appendFiltered(sp); // spanner with start and end in range selection
+                  appendFiltered(sp, _el); // spanner with start and end in range selection
             }
       update();
       }
@@ -1124,17 +1157,17 @@ bool Selection::measureRange(Measure** m1, Measure** m2) const
 const QList<Element*> Selection::uniqueElements() const
       {
       QList<Element*> l;
+      QSet<Element*> seen;    // elements in l and their linked elements
 
       for (Element* e : elements()) {
-            bool alreadyThere = false;
-            for (Element* ee : l) {
-                  if ((ee->links() && ee->links()->contains(e)) || e == ee) {
-                        alreadyThere = true;
-                        break;
-                        }
+            if (seen.contains(e))
+                  continue;
+            l.append(e);
+            seen.insert(e);
+            if (e->links()) {
+                  for (ScoreElement* se : *e->links())
+                        seen.insert(static_cast<Element*>(se));
                   }
-            if (!alreadyThere)
-                  l.append(e);
             }
       return l;
       }
@@ -1149,18 +1182,18 @@ const QList<Element*> Selection::uniqueElements() const
 QList<Note*> Selection::uniqueNotes(int track) const
       {
       QList<Note*> l;
+      QSet<Element*> seen;
 
       for (Note* nn : noteList(track)) {
             for (Note* note : nn->tiedNotes()) {
-                  bool alreadyThere = false;
-                  for (Note* n : l) {
-                        if ((n->links() && n->links()->contains(note)) || n == note) {
-                              alreadyThere = true;
-                              break;
-                              }
+                  if (seen.contains(note))
+                        continue;
+                  l.append(note);
+                  seen.insert(note);
+                  if (note->links()) {
+                        for (ScoreElement* se : *note->links())
+                              seen.insert(static_cast<Element*>(se));
                         }
-                  if (!alreadyThere)
-                        l.append(note);
                   }
             }
       return l;
@@ -115,8 +115,8 @@ class Selection {
       SelectionFilter selectionFilter() const;
       bool canSelect(Element* e) const { return selectionFilter().canSelect(e); }
       bool canSelectVoice(int track) const { return selectionFilter().canSelectVoice(track); }
-      void appendFiltered(Element* e);
-      void appendChord(Chord* chord);
+      void appendFiltered(Element* e, QList<Element*>& l);
+      void appendChord(Chord* chord, QList<Element*>& l, QSet<Element*>& beams);
 
    public:
       Selection()                      { _score = 0; _state = SelState::NONE; }
@@ -438,7 +438,7 @@ void Spanner::endEdit()
             }
 
       if (rebuild)
-            score()->rebuildBspTree();
+            score()->invalidateBspTree();
 
       if (spannerSegments().size() != userOffsets2.size()) {
             qDebug("Spanner::endEdit(): segment size changed");
@@ -29,6 +29,8 @@ class Chord;
 class Stem : public Element {
       Q_OBJECT
 
+      POOLED_ELEMENT(Stem)
+
       QLineF line;            // p1 is attached to notehead
       qreal _userLen;
       qreal _len;             // allways positive
@@ -16,6 +16,7 @@
 #include "score.h"
 #include "xml.h"
 #include "mscore.h"
+#include "trace.h"
 
 #include FT_GLYPH_H
 #include FT_IMAGE_H
@@ -5568,6 +5569,19 @@ SymId Sym::userName2id(const QString& s)
       return (val == -1) ? SymId::noSym : (SymId)(val);
       }
 
+//---------------------------------------------------------
+//   GlyphPaths
+//    outlines of the symbols at the size of the print
+//    font, for painters without native text
+//---------------------------------------------------------
+
+struct GlyphPaths {
+      QMutex mutex;
+      QHash<int, QPainterPath> paths;
+      qint64 hits   { 0 };
+      qint64 misses { 0 };
+      };
+
 //---------------------------------------------------------
 //   GlyphKey operator==
 //---------------------------------------------------------
@@ -5598,36 +5612,36 @@ void ScoreFont::draw(SymId id, QPainter* painter, qreal mag, const QPointF& pos,
             qDebug("ScoreFont::draw: invalid sym %d\n", int(id));
             return;
             }
-      int rv = FT_Load_Glyph(face, sym(id).index(), FT_LOAD_DEFAULT);
-      if (rv) {
-            qDebug("load glyph id %d, failed: 0x%x", int(id), rv);
-            return;
-            }
 
+      // printing does not use freetype, so once printFont() exists
+      // pages can be printed from several threads
       if (MScore::pdfPrinting) {
-            if (font == 0) {
-                  QString s(_fontPath+_filename);
-                  if (-1 == QFontDatabase::addApplicationFont(s)) {
-                        qDebug("Mscore: fatal error: cannot load internal font <%s>", qPrintable(s));
-                        return;
-                        }
-                  font = new QFont;
-                  font->setWeight(QFont::Normal);
-                  font->setItalic(false);
-                  font->setFamily(_family);
-                  font->setStyleStrategy(QFont::NoFontMerging);
-                  font->setHintingPreference(QFont::PreferVerticalHinting);
-                  qreal size = 20.0;
-                  font->setPixelSize(lrint(size));
+            const QFont* f = printFont();
+            if (!f)
+                  return;
+            if (MScore::printGlyphPaths) {
+                  QPainterPath path = glyphPath(id);
+                  QTransform t = painter->transform();
+                  painter->translate(pos);
+                  painter->scale(mag, mag);
+                  painter->fillPath(path, painter->pen().brush());
+                  painter->setTransform(t);
+                  return;
                   }
             qreal imag = 1.0 / mag;
             painter->scale(mag, mag);
-            painter->setFont(*font);
+            painter->setFont(*f);
             painter->drawText(pos * imag, toString(id));
             painter->scale(imag, imag);
             return;
             }
 
+      int rv = FT_Load_Glyph(face, sym(id).index(), FT_LOAD_DEFAULT);
+      if (rv) {
+            qDebug("load glyph id %d, failed: 0x%x", int(id), rv);
+            return;
+            }
+
       QColor color(painter->pen().color());
 
       int pr           = painter->device()->devicePixelRatio();
@@ -5684,6 +5698,94 @@ void ScoreFont::draw(SymId id, QPainter* painter, qreal mag, const QPointF& pos,
       painter->drawPixmap(pos + pm->offset, pm->pm);
       }
 
+//---------------------------------------------------------
+//   printFont
+//    font to draw symbols when printing (pdf, svg);
+//    created on first use, which must happen in the
+//    gui thread
+//---------------------------------------------------------
+
+const QFont* ScoreFont::printFont() const
+      {
+      if (font == 0) {
+            QString s(_fontPath+_filename);
+            if (-1 == QFontDatabase::addApplicationFont(s)) {
+                  qDebug("Mscore: fatal error: cannot load internal font <%s>", qPrintable(s));
+                  return 0;
+                  }
+            font = new QFont;
+            font->setWeight(QFont::Normal);
+            font->setItalic(false);
+            font->setFamily(_family);
+            font->setStyleStrategy(QFont::NoFontMerging);
+            font->setHintingPreference(QFont::PreferVerticalHinting);
+            qreal size = 20.0;
+            font->setPixelSize(lrint(size));
+            paths = new GlyphPaths;
+            }
+      return font;
+      }
+
+//---------------------------------------------------------
+//   glyphPath
+//    outline of the symbol at the origin, at the size of
+//    the print font. Painters which have no native text
+//    (svg without symbols) would otherwise convert the
+//    glyph to a path for every symbol drawn.
+//---------------------------------------------------------
+
+QPainterPath ScoreFont::glyphPath(SymId id) const
+      {
+      const QFont* f = printFont();
+      if (!f)
+            return QPainterPath();
+      QMutexLocker locker(&paths->mutex);
+      auto i = paths->paths.constFind(int(id));
+      if (i != paths->paths.constEnd()) {
+            ++paths->hits;
+            return *i;
+            }
+      ++paths->misses;
+      locker.unlock();
+
+      QPainterPath path;
+      path.setFillRule(Qt::WindingFill);
+      path.addText(QPointF(), *f, toString(id));
+      // the bounding rects are computed lazily; do it now, before
+      // the path is shared between threads
+      path.boundingRect();
+      path.controlPointRect();
+
+      locker.relock();
+      paths->paths.insert(int(id), path);
+      return path;
+      }
+
+//---------------------------------------------------------
+//   traceGlyphPaths
+//    glyph path cache statistics of all score fonts
+//---------------------------------------------------------
+
+void ScoreFont::traceGlyphPaths()
+      {
+      if (!Trace::enabled())
+            return;
+      qint64 hits   = 0;
+      qint64 misses = 0;
+      qint64 size   = 0;
+      for (const ScoreFont& f : _scoreFonts) {
+            if (!f.paths)
+                  continue;
+            QMutexLocker locker(&f.paths->mutex);
+            hits   += f.paths->hits;
+            misses += f.paths->misses;
+            size   += f.paths->paths.size();
+            }
+      Trace::addCounter("glyph path cache hits", "export", hits);
+      Trace::addCounter("glyph path cache misses", "export", misses);
+      Trace::addCounter("glyph path cache size", "export", size);
+      }
+
 void ScoreFont::draw(SymId id, QPainter* painter, qreal mag, const QPointF& pos, int n) const
       {
       std::vector<SymId> d;
@@ -6125,6 +6227,7 @@ ScoreFont::ScoreFont(const ScoreFont& f)
 ScoreFont::~ScoreFont()
       {
       delete cache;
+      delete paths;
       }
 }
 
@@ -2754,6 +2754,8 @@ inline uint qHash(const GlyphKey& k)
       return (int(k.id) << 16) + k.mag;
       }
 
+struct GlyphPaths;
+
 //---------------------------------------------------------
 //   ScoreFont
 //---------------------------------------------------------
@@ -2768,6 +2770,7 @@ class ScoreFont {
       QByteArray fontImage;
       QCache<GlyphKey, GlyphPixmap>* cache { 0 };
       mutable QFont* font { 0 };
+      mutable GlyphPaths* paths { 0 };    // created with font
 
       static QVector<ScoreFont> _scoreFonts;
       const Sym& sym(SymId id) const { return _symbols[int(id)]; }
@@ -2801,6 +2804,9 @@ class ScoreFont {
       void draw(const std::vector<SymId>&, QPainter*, qreal mag, const QPointF& pos) const;
       void draw(const std::vector<SymId>&, QPainter*, qreal mag, const QPointF& pos, qreal scale) const;
       void draw(SymId id, QPainter* painter, qreal mag, const QPointF& pos, int n) const;
+      const QFont* printFont() const;
+      QPainterPath glyphPath(SymId id) const;
+      static void traceGlyphPaths();
 
       qreal height(SymId id, qreal mag) const         { return sym(id).bbox().height() * mag; }
       qreal width(SymId id, qreal mag) const          { return sym(id).bbox().width() * mag;  }
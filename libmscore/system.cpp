@@ -83,6 +83,7 @@ System::~System()
 void System::clear()
       {
       ml.clear();
+      _measureRight.clear();
       for (SpannerSegment* ss : _spannerSegments) {
             if (ss->system() == this)
                   ss->setParent(0);       // assume parent() is System
@@ -814,6 +815,41 @@ Measure* System::firstMeasure() const
       return i != ml.end() ? static_cast<Measure*>(*i) : 0;
       }
 
+//---------------------------------------------------------
+//   updateMeasureOffsets
+//    called after the measures are positioned; the right
+//    edges are ascending and allow a binary search, which
+//    matters for the long system of the continuous view
+//---------------------------------------------------------
+
+void System::updateMeasureOffsets()
+      {
+      _measureRight.resize(ml.size());
+      for (size_t i = 0; i < ml.size(); ++i)
+            _measureRight[i] = ml[i]->x() + ml[i]->width();
+      }
+
+//---------------------------------------------------------
+//   measureIndex
+//    index in measures() of the first measure which ends
+//    right of x (system coordinates), measures().size()
+//    if there is none
+//---------------------------------------------------------
+
+int System::measureIndex(qreal x) const
+      {
+      if (_measureRight.size() != ml.size()) {
+            int idx = 0;
+            for (MeasureBase* mb : ml) {
+                  if (mb->x() + mb->width() > x)
+                        break;
+                  ++idx;
+                  }
+            return idx;
+            }
+      return std::upper_bound(_measureRight.begin(), _measureRight.end(), x) - _measureRight.begin();
+      }
+
 //---------------------------------------------------------
 //   lastMeasure
 //---------------------------------------------------------
@@ -78,6 +78,7 @@ class System : public Element {
       SystemDivider*  _systemDividerRight   { 0 };
 
       std::vector<MeasureBase*> ml;
+      std::vector<qreal> _measureRight;   ///< right edge of the measures in ml, see updateMeasureOffsets()
       QList<SysStaff*> _staves;
       QList<Bracket*> _brackets;
       QList<SpannerSegment*> _spannerSegments;
@@ -133,6 +134,9 @@ class System : public Element {
       MeasureBase* prevMeasure(const MeasureBase*) const;
       MeasureBase* nextMeasure(const MeasureBase*) const;
 
+      void updateMeasureOffsets();
+      int measureIndex(qreal x) const;
+
       qreal leftMargin() const    { return _leftMargin; }
       VBox* vbox() const;
 
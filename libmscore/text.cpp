@@ -23,6 +23,7 @@
 #include "sym.h"
 #include "xml.h"
 #include "undo.h"
+#include "textlayoutcache.h"
 
 namespace Ms {
 
@@ -1225,7 +1226,14 @@ void Text::layout()
 
 void Text::layout1()
       {
-      if (!_editMode)
+      bool useCache = TextLayoutCache::canCache(this);
+      bool cached   = false;
+      TextLayoutKey key;
+      if (useCache) {
+            key    = TextLayoutCache::key(this);
+            cached = TextLayoutCache::instance()->find(key, &_layout);
+            }
+      if (!_editMode && !cached)
             createLayout();
 
       if (_layout.empty())
@@ -1235,7 +1243,8 @@ void Text::layout1()
       qreal y = 0;
       for (int i = 0; i < _layout.size(); ++i) {
             TextBlock* t = &_layout[i];
-            t->layout(this);
+            if (!cached)
+                  t->layout(this);
             const QRectF* r = &t->boundingRect();
 
             if (r->height() == 0)
@@ -1244,6 +1253,9 @@ void Text::layout1()
             t->setY(y);
             bb |= r->translated(0.0, y);
             }
+      if (useCache && !cached)
+            TextLayoutCache::instance()->insert(key, _layout);
+
       qreal yoff = 0;
       qreal h    = 0;
       if (parent()) {
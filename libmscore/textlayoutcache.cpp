@@ -0,0 +1,238 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2016 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include "textlayoutcache.h"
+#include "text.h"
+#include "score.h"
+#include "style.h"
+
+namespace Ms {
+
+TextLayoutCache* TextLayoutCache::_instance = 0;
+
+//---------------------------------------------------------
+//   Entry
+//---------------------------------------------------------
+
+struct TextLayoutCache::Entry {
+      QList<TextBlock> blocks;
+      };
+
+//---------------------------------------------------------
+//   operator==
+//---------------------------------------------------------
+
+bool TextLayoutKey::operator==(const TextLayoutKey& k) const
+      {
+      return size == k.size
+         && spatium == k.spatium
+         && align == k.align
+         && bold == k.bold
+         && italic == k.italic
+         && underline == k.underline
+         && sizeIsSpatiumDependent == k.sizeIsSpatiumDependent
+         && text == k.text
+         && family == k.family
+         && musicalTextFont == k.musicalTextFont;
+      }
+
+//---------------------------------------------------------
+//   qHash
+//---------------------------------------------------------
+
+uint qHash(const TextLayoutKey& k)
+      {
+      uint h = qHash(k.text);
+      h = h * 31 + qHash(k.family);
+      h = h * 31 + qHash(k.musicalTextFont);
+      h = h * 31 + qHash(k.size);
+      h = h * 31 + qHash(k.spatium);
+      h = h * 31 + uint(k.align);
+      h = h * 31 + (k.bold | (k.italic << 1) | (k.underline << 2) | (k.sizeIsSpatiumDependent << 3));
+      return h;
+      }
+
+//---------------------------------------------------------
+//   TextLayoutCache
+//    maxCost is counted in text fragments
+//---------------------------------------------------------
+
+TextLayoutCache::TextLayoutCache(int maxCost)
+   : _cache(maxCost)
+      {
+      }
+
+TextLayoutCache::~TextLayoutCache()
+      {
+      }
+
+//---------------------------------------------------------
+//   instance
+//---------------------------------------------------------
+
+TextLayoutCache* TextLayoutCache::instance()
+      {
+      if (!_instance)
+            _instance = new TextLayoutCache;
+      return _instance;
+      }
+
+//---------------------------------------------------------
+//   canCache
+//    Text laid out to the width of its parent (frames,
+//    page headers) depends on the parent geometry and
+//    texts in edit mode own a private layout.
+//---------------------------------------------------------
+
+bool TextLayoutCache::canCache(const Text* t)
+      {
+      return !t->editMode() && !t->layoutToParentWidth() && t->score();
+      }
+
+//---------------------------------------------------------
+//   key
+//---------------------------------------------------------
+
+TextLayoutKey TextLayoutCache::key(const Text* t)
+      {
+      const TextStyle& ts = t->textStyle();
+      TextLayoutKey k;
+      k.text                   = t->xmlText();
+      k.family                 = ts.family();
+      k.musicalTextFont        = t->score()->styleSt(StyleIdx::MusicalTextFont);
+      k.size                   = ts.size();
+      k.spatium                = t->spatium();
+      k.align                  = int(ts.align());
+      k.bold                   = ts.bold();
+      k.italic                 = ts.italic();
+      k.underline              = ts.underline();
+      k.sizeIsSpatiumDependent = ts.sizeIsSpatiumDependent();
+      return k;
+      }
+
+//---------------------------------------------------------
+//   find
+//    copy the cached layout into *blocks; return false
+//    if there is no entry for k
+//---------------------------------------------------------
+
+bool TextLayoutCache::find(const TextLayoutKey& k, QList<TextBlock>* blocks)
+      {
+      QMutexLocker locker(&_mutex);
+      Entry* e = _cache.object(k);
+      if (!e) {
+            ++_misses;
+            return false;
+            }
+      ++_hits;
+      *blocks = e->blocks;
+      return true;
+      }
+
+//---------------------------------------------------------
+//   insert
+//---------------------------------------------------------
+
+void TextLayoutCache::insert(const TextLayoutKey& k, const QList<TextBlock>& blocks)
+      {
+      int cost = 0;
+      for (const TextBlock& b : blocks)
+            cost += qMax(1, b.fragments().size());
+      Entry* e  = new Entry;
+      e->blocks = blocks;
+      QMutexLocker locker(&_mutex);
+      _cache.insert(k, e, cost);
+      ++_inserts;
+      }
+
+//---------------------------------------------------------
+//   clear
+//---------------------------------------------------------
+
+void TextLayoutCache::clear()
+      {
+      QMutexLocker locker(&_mutex);
+      _cache.clear();
+      }
+
+int TextLayoutCache::maxCost() const
+      {
+      QMutexLocker locker(&_mutex);
+      return _cache.maxCost();
+      }
+
+void TextLayoutCache::setMaxCost(int val)
+      {
+      QMutexLocker locker(&_mutex);
+      _cache.setMaxCost(val);
+      }
+
+int TextLayoutCache::totalCost() const
+      {
+      QMutexLocker locker(&_mutex);
+      return _cache.totalCost();
+      }
+
+int TextLayoutCache::count() const
+      {
+      QMutexLocker locker(&_mutex);
+      return _cache.count();
+      }
+
+//---------------------------------------------------------
+//   statistics
+//    find() and insert() may run in the layout threads
+//---------------------------------------------------------
+
+int TextLayoutCache::hits() const
+      {
+      QMutexLocker locker(&_mutex);
+      return _hits;
+      }
+
+int TextLayoutCache::misses() const
+      {
+      QMutexLocker locker(&_mutex);
+      return _misses;
+      }
+
+int TextLayoutCache::inserts() const
+      {
+      QMutexLocker locker(&_mutex);
+      return _inserts;
+      }
+
+//---------------------------------------------------------
+//   hitRate
+//---------------------------------------------------------
+
+qreal TextLayoutCache::hitRate() const
+      {
+      QMutexLocker locker(&_mutex);
+      int n = _hits + _misses;
+      return n ? qreal(_hits) / qreal(n) : 0.0;
+      }
+
+//---------------------------------------------------------
+//   resetStatistics
+//---------------------------------------------------------
+
+void TextLayoutCache::resetStatistics()
+      {
+      QMutexLocker locker(&_mutex);
+      _hits    = 0;
+      _misses  = 0;
+      _inserts = 0;
+      }
+
+}     // namespace Ms
+
@@ -0,0 +1,88 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2016 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#ifndef __TEXTLAYOUTCACHE_H__
+#define __TEXTLAYOUTCACHE_H__
+
+namespace Ms {
+
+class Text;
+class TextBlock;
+
+//---------------------------------------------------------
+//   TextLayoutKey
+//    everything TextBlock::layout() depends on when
+//    the text is not laid out to its parent width
+//---------------------------------------------------------
+
+struct TextLayoutKey {
+      QString text;
+      QString family;
+      QString musicalTextFont;
+      qreal size;
+      qreal spatium;
+      int align;
+      bool bold;
+      bool italic;
+      bool underline;
+      bool sizeIsSpatiumDependent;
+
+      bool operator==(const TextLayoutKey&) const;
+      };
+
+extern uint qHash(const TextLayoutKey&);
+
+//---------------------------------------------------------
+//   TextLayoutCache
+//    process wide cache of parsed and measured text
+//    blocks, shared by all texts of all scores with the
+//    same markup and resolved style
+//---------------------------------------------------------
+
+class TextLayoutCache {
+      struct Entry;
+
+      QCache<TextLayoutKey, Entry> _cache;
+      mutable QMutex _mutex;
+      int _hits     { 0 };
+      int _misses   { 0 };
+      int _inserts  { 0 };
+
+      static TextLayoutCache* _instance;
+
+   public:
+      TextLayoutCache(int maxCost = 200000);
+      ~TextLayoutCache();
+
+      static TextLayoutCache* instance();
+      static bool canCache(const Text*);
+      static TextLayoutKey key(const Text*);
+
+      bool find(const TextLayoutKey&, QList<TextBlock>*);
+      void insert(const TextLayoutKey&, const QList<TextBlock>&);
+      void clear();
+
+      int maxCost() const;
+      void setMaxCost(int);
+      int totalCost() const;
+      int count() const;
+
+      int hits() const;
+      int misses() const;
+      int inserts() const;
+      qreal hitRate() const;
+      void resetStatistics();
+      };
+
+}     // namespace Ms
+#endif
+
@@ -0,0 +1,368 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2016 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include "trace.h"
+
+#include <cstring>
+#include <memory>
+#include <vector>
+
+namespace Ms {
+
+std::atomic<bool> Trace::_enabled { false };
+
+//---------------------------------------------------------
+//   TraceEvent
+//---------------------------------------------------------
+
+struct TraceEvent {
+      const char* name;
+      const char* category;
+      const char* argName;
+      qint64 ts;              // us since start of trace
+      qint64 dur;
+      qint64 arg;
+      char phase;             // 'X' span, 'C' counter
+      };
+
+//---------------------------------------------------------
+//   ThreadBuffer
+//    ring buffer of the events of one thread; only the
+//    owning thread writes, stop() reads the last
+//    BUFFER_SIZE events after tracing is disabled and
+//    all writers left record()
+//---------------------------------------------------------
+
+static const quint64 BUFFER_SIZE = 1 << 16;
+static const size_t MAX_FREE_BUFFERS = 4;
+
+struct ThreadBuffer {
+      int tid;
+      QByteArray defaultName;
+      std::atomic<const char*> name { nullptr };
+      std::vector<TraceEvent> events;
+      std::atomic<quint64> count { 0 };
+      bool retired { false };             // thread exited, guarded by traceMutex
+      };
+
+//---------------------------------------------------------
+//   LocalBuffer
+//    gives the buffer of a thread back when the thread
+//    exits; pool threads come and go
+//---------------------------------------------------------
+
+struct LocalBuffer {
+      ThreadBuffer* buffer { nullptr };
+      ~LocalBuffer();
+      };
+
+static QMutex traceMutex;                 // protects buffers, freeBuffers and tracePath
+static std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+static std::vector<std::unique_ptr<ThreadBuffer>> freeBuffers;
+static int nextTid = 1;
+static thread_local LocalBuffer localBuffer;
+static std::atomic<ThreadBuffer*> reservedBuffer { nullptr };
+static std::atomic<int> writers { 0 };    // threads in record()
+static QElapsedTimer traceTimer;
+static QString tracePath;
+
+//---------------------------------------------------------
+//   newBuffer
+//    allocate and register a buffer; name is the name of
+//    a reserved buffer, 0 for the current thread
+//---------------------------------------------------------
+
+static ThreadBuffer* newBuffer(const char* name)
+      {
+      QThread* thread = name ? 0 : QThread::currentThread();
+      QMutexLocker locker(&traceMutex);
+      std::unique_ptr<ThreadBuffer> b;
+      if (!freeBuffers.empty()) {
+            b = std::move(freeBuffers.back());
+            freeBuffers.pop_back();
+            b->name.store(nullptr, std::memory_order_relaxed);
+            b->count.store(0, std::memory_order_relaxed);
+            b->retired = false;
+            }
+      else {
+            b.reset(new ThreadBuffer);
+            b->events.resize(BUFFER_SIZE);
+            }
+      b->tid = nextTid++;
+      if (name)
+            b->defaultName = name;
+      else if (QCoreApplication::instance() && thread == QCoreApplication::instance()->thread())
+            b->defaultName = "main";
+      else if (!thread->objectName().isEmpty())
+            b->defaultName = thread->objectName().toUtf8();
+      else
+            b->defaultName = "thread " + QByteArray::number(b->tid);
+      buffers.push_back(std::move(b));
+      return buffers.back().get();
+      }
+
+//---------------------------------------------------------
+//   releaseRetiredBuffers
+//    buffers of exited threads without events to write
+//    are kept for reuse or freed; traceMutex is locked
+//---------------------------------------------------------
+
+static void releaseRetiredBuffers()
+      {
+      for (auto i = buffers.begin(); i != buffers.end();) {
+            if ((*i)->retired && (*i)->count.load(std::memory_order_relaxed) == 0) {
+                  if (freeBuffers.size() < MAX_FREE_BUFFERS)
+                        freeBuffers.push_back(std::move(*i));
+                  i = buffers.erase(i);
+                  }
+            else
+                  ++i;
+            }
+      }
+
+//---------------------------------------------------------
+//   releaseBuffersAfterStop
+//    the events of exited threads are written now
+//---------------------------------------------------------
+
+static void releaseBuffersAfterStop()
+      {
+      for (auto& b : buffers) {
+            if (b->retired)
+                  b->count.store(0, std::memory_order_relaxed);
+            }
+      releaseRetiredBuffers();
+      }
+
+//---------------------------------------------------------
+//   ~LocalBuffer
+//    the events of the thread are still written by the
+//    next stop()
+//---------------------------------------------------------
+
+LocalBuffer::~LocalBuffer()
+      {
+      if (!buffer)
+            return;
+      QMutexLocker locker(&traceMutex);
+      buffer->retired = true;
+      releaseRetiredBuffers();
+      }
+
+//---------------------------------------------------------
+//   threadBuffer
+//---------------------------------------------------------
+
+static ThreadBuffer* threadBuffer()
+      {
+      if (!localBuffer.buffer)
+            localBuffer.buffer = newBuffer(0);
+      return localBuffer.buffer;
+      }
+
+//---------------------------------------------------------
+//   record
+//    callers count themselves in writers and check
+//    _enabled again, so that stop() can wait until no
+//    thread is between the check and the count update
+//---------------------------------------------------------
+
+static void record(const TraceEvent& e)
+      {
+      ThreadBuffer* b = threadBuffer();
+      quint64 n = b->count.load(std::memory_order_relaxed);
+      b->events[n % BUFFER_SIZE] = e;
+      b->count.store(n + 1, std::memory_order_release);
+      }
+
+//---------------------------------------------------------
+//   now
+//    in us
+//---------------------------------------------------------
+
+qint64 Trace::now()
+      {
+      return traceTimer.nsecsElapsed() / 1000;
+      }
+
+//---------------------------------------------------------
+//   start
+//    start recording; the trace is written to path by
+//    stop(), at the latest at program exit
+//---------------------------------------------------------
+
+bool Trace::start(const QString& path)
+      {
+      QFile f(path);
+      if (!f.open(QIODevice::WriteOnly)) {
+            qDebug("Trace: cannot open <%s>", qPrintable(path));
+            return false;
+            }
+      f.close();
+
+      static bool atExitRegistered = false;
+      if (!atExitRegistered) {
+            atexit(Trace::stop);
+            atExitRegistered = true;
+            }
+      QMutexLocker locker(&traceMutex);
+      tracePath = path;
+      for (auto& b : buffers)
+            b->count.store(0, std::memory_order_relaxed);
+      releaseRetiredBuffers();
+      traceTimer.start();
+      _enabled.store(true);
+      return true;
+      }
+
+//---------------------------------------------------------
+//   addSpan
+//---------------------------------------------------------
+
+void Trace::addSpan(const char* name, const char* category, qint64 start, qint64 duration,
+   const char* argName, qint64 arg)
+      {
+      if (!enabled())
+            return;
+      writers.fetch_add(1);
+      if (_enabled.load())
+            record({ name, category, argName, start, duration, arg, 'X' });
+      writers.fetch_sub(1);
+      }
+
+//---------------------------------------------------------
+//   addCounter
+//---------------------------------------------------------
+
+void Trace::addCounter(const char* name, const char* category, qint64 value)
+      {
+      if (!enabled())
+            return;
+      writers.fetch_add(1);
+      if (_enabled.load())
+            record({ name, category, "value", now(), 0, value, 'C' });
+      writers.fetch_sub(1);
+      }
+
+//---------------------------------------------------------
+//   reserveThread
+//    allocate the buffer of a realtime thread in advance;
+//    the next thread without a buffer which calls
+//    setThreadName() with the same name takes it
+//---------------------------------------------------------
+
+void Trace::reserveThread(const char* name)
+      {
+      if (!enabled() || reservedBuffer.load())
+            return;
+      reservedBuffer.store(newBuffer(name));
+      }
+
+//---------------------------------------------------------
+//   setThreadName
+//    name the current thread in the trace; threads
+//    not created by Qt (audio callbacks) have no name.
+//    Takes the reserved buffer, if there is one of that
+//    name, without allocating or locking.
+//---------------------------------------------------------
+
+void Trace::setThreadName(const char* name)
+      {
+      if (!enabled())
+            return;
+      if (!localBuffer.buffer) {
+            ThreadBuffer* b = reservedBuffer.load();
+            if (b && strcmp(b->defaultName.constData(), name) == 0
+               && reservedBuffer.compare_exchange_strong(b, nullptr))
+                  localBuffer.buffer = b;
+            }
+      threadBuffer()->name.store(name, std::memory_order_relaxed);
+      }
+
+//---------------------------------------------------------
+//   jsonString
+//---------------------------------------------------------
+
+static QByteArray jsonString(const char* s)
+      {
+      QByteArray r("\"");
+      for (const char* p = s; *p; ++p) {
+            if (*p == '"' || *p == '\\')
+                  r += '\\';
+            if (uchar(*p) >= 0x20)
+                  r += *p;
+            }
+      r += '"';
+      return r;
+      }
+
+//---------------------------------------------------------
+//   stop
+//    stop recording and write the trace
+//---------------------------------------------------------
+
+void Trace::stop()
+      {
+      if (!_enabled.exchange(false))
+            return;
+      // wait for events which passed the enabled check
+      while (writers.load() != 0)
+            QThread::yieldCurrentThread();
+
+      QMutexLocker locker(&traceMutex);
+      QFile f(tracePath);
+      if (!f.open(QIODevice::WriteOnly)) {
+            qDebug("Trace: cannot write <%s>", qPrintable(tracePath));
+            releaseBuffersAfterStop();
+            return;
+            }
+      const QByteArray pid = QByteArray::number(QCoreApplication::applicationPid());
+      f.write("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+      bool first = true;
+      for (const auto& b : buffers) {
+            quint64 n = b->count.load(std::memory_order_acquire);
+            if (n == 0)
+                  continue;
+            const QByteArray tid = QByteArray::number(b->tid);
+            const char* name = b->name.load(std::memory_order_relaxed);
+            QByteArray s;
+            if (!first)
+                  s += ",\n";
+            first = false;
+            s += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" + pid + ",\"tid\":" + tid
+               + ",\"args\":{\"name\":" + jsonString(name ? name : b->defaultName.constData()) + "}}";
+            if (n > BUFFER_SIZE)
+                  qDebug("Trace: %s: %llu events dropped", name ? name : b->defaultName.constData(), n - BUFFER_SIZE);
+            for (quint64 i = n > BUFFER_SIZE ? n - BUFFER_SIZE : 0; i < n; ++i) {
+                  const TraceEvent& e = b->events[i % BUFFER_SIZE];
+                  s += ",\n{\"name\":" + jsonString(e.name) + ",\"cat\":" + jsonString(e.category)
+                     + ",\"ph\":\"" + e.phase + "\",\"ts\":" + QByteArray::number(e.ts);
+                  if (e.phase == 'X')
+                        s += ",\"dur\":" + QByteArray::number(e.dur);
+                  s += ",\"pid\":" + pid + ",\"tid\":" + tid;
+                  if (e.argName)
+                        s += ",\"args\":{" + jsonString(e.argName) + ":" + QByteArray::number(e.arg) + "}";
+                  s += "}";
+                  if (s.size() > 65536) {
+                        f.write(s);
+                        s.clear();
+                        }
+                  }
+            f.write(s);
+            }
+      f.write("\n]}\n");
+      f.close();
+      releaseBuffersAfterStop();
+      }
+
+}     // namespace Ms
+
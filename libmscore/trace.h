@@ -0,0 +1,84 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2016 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#ifndef __TRACE_H__
+#define __TRACE_H__
+
+#include <atomic>
+
+namespace Ms {
+
+//---------------------------------------------------------
+//   Trace
+//    scoped time spans written as Chrome trace-event json
+//    (chrome://tracing, ui.perfetto.dev)
+//
+//    Tracing is always compiled in; while it is disabled
+//    a span costs one relaxed atomic load. Every thread
+//    records into its own ring buffer which is allocated
+//    on the first span of the thread, or in advance by
+//    reserveThread() for realtime threads, and given back
+//    when the thread exits. Recording takes no lock, so
+//    spans can be used in the audio thread.
+//    Names and categories must be string literals or
+//    otherwise outlive the trace.
+//---------------------------------------------------------
+
+class Trace {
+      static std::atomic<bool> _enabled;
+
+   public:
+      static bool enabled()  { return _enabled.load(std::memory_order_relaxed); }
+      static bool start(const QString& path);
+      static void stop();
+
+      static qint64 now();
+      static void addSpan(const char* name, const char* category, qint64 start, qint64 duration,
+         const char* argName = 0, qint64 arg = 0);
+      static void addCounter(const char* name, const char* category, qint64 value);
+      static void reserveThread(const char* name);
+      static void setThreadName(const char* name);
+      };
+
+//---------------------------------------------------------
+//   TraceSpan
+//---------------------------------------------------------
+
+class TraceSpan {
+      const char* _name;
+      const char* _category;
+      const char* _argName;
+      qint64 _arg;
+      qint64 _start;
+
+   public:
+      TraceSpan(const char* name, const char* category, const char* argName = 0, qint64 arg = 0)
+         : _name(name), _category(category), _argName(argName), _arg(arg)
+            {
+            _start = Trace::enabled() ? Trace::now() : -1;
+            }
+      ~TraceSpan()
+            {
+            if (_start >= 0)
+                  Trace::addSpan(_name, _category, _start, Trace::now() - _start, _argName, _arg);
+            }
+      };
+
+#define TRACE_CONCAT2(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT2(a, b)
+#define TRACE_SPAN(name, category) Ms::TraceSpan TRACE_CONCAT(traceSpan, __LINE__)(name, category)
+#define TRACE_SPAN_ARG(name, category, argName, arg) \
+      Ms::TraceSpan TRACE_CONCAT(traceSpan, __LINE__)(name, category, argName, arg)
+
+}     // namespace Ms
+#endif
+
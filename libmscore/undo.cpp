@@ -367,6 +367,54 @@ void Score::undoChangeProperty(ScoreElement* e, P_ID t, const QVariant& st, Prop
             }
       }
 
+//---------------------------------------------------------
+//   undoChangeProperties
+//    change one property of many elements with a single
+//    undo command; linked elements are changed once. The
+//    last change of an element or one of its links wins,
+//    as with one undoChangeProperty() after the other.
+//---------------------------------------------------------
+
+void Score::undoChangeProperties(P_ID id, const std::vector<PropertyChange>& changes)
+      {
+      if (id == P_ID::AUTOPLACE) {
+            // Element::undoChangeProperty() also resets the user offsets
+            for (const PropertyChange& c : changes)
+                  static_cast<Element*>(c.element)->undoChangeProperty(id, c.value, c.propertyStyle);
+            return;
+            }
+      bool link = propertyLink(id);
+      QSet<ScoreElement*> seen;
+      std::vector<PropertyChange> l;
+      l.reserve(changes.size());
+      for (auto i = changes.rbegin(); i != changes.rend(); ++i) {
+            const PropertyChange& c = *i;
+            for (ScoreElement* e : link ? c.element->linkList() : QList<ScoreElement*>({ c.element })) {
+                  if (seen.contains(e))
+                        continue;
+                  seen.insert(e);
+                  if (e->getProperty(id) != c.value || e->propertyStyle(id) != c.propertyStyle)
+                        l.push_back({ e, c.value, c.propertyStyle });
+                  }
+            }
+      std::reverse(l.begin(), l.end());
+      if (l.empty())
+            return;
+      if (l.size() == 1)
+            undo(new ChangeProperty(l[0].element, id, l[0].value, l[0].propertyStyle));
+      else
+            undo(new ChangeProperties(id, std::move(l)));
+      }
+
+void Score::undoChangeProperty(const QList<Element*>& el, P_ID id, const QVariant& v, PropertyStyle ps)
+      {
+      std::vector<PropertyChange> changes;
+      changes.reserve(el.size());
+      for (Element* e : el)
+            changes.push_back({ e, v, ps });
+      undoChangeProperties(id, changes);
+      }
+
 //---------------------------------------------------------
 //   undoPropertyChanged
 //---------------------------------------------------------
@@ -3064,10 +3112,14 @@ void ChangeStaffUserDist::flip()
 //   ChangeProperty::flip
 //---------------------------------------------------------
 
-void ChangeProperty::flip()
-      {
-      qCDebug(undoRedo) << "ChangeProperty::flip():" << element->name() << propertyName(id) << element->getProperty(id) << "->" << property;
+//---------------------------------------------------------
+//   flipProperty
+//    exchange the property value and style of element
+//    with property and propertyStyle
+//---------------------------------------------------------
 
+static void flipProperty(ScoreElement* element, P_ID id, QVariant& property, PropertyStyle& propertyStyle)
+      {
       if (id == P_ID::SPANNER_TICK || id == P_ID::SPANNER_TICKS)
             static_cast<Element*>(element)->score()->removeSpanner(static_cast<Spanner*>(element));
 
@@ -3091,6 +3143,23 @@ void ChangeProperty::flip()
       propertyStyle = ps;
       }
 
+void ChangeProperty::flip()
+      {
+      qCDebug(undoRedo) << "ChangeProperty::flip():" << element->name() << propertyName(id) << element->getProperty(id) << "->" << property;
+      flipProperty(element, id, property, propertyStyle);
+      }
+
+//---------------------------------------------------------
+//   ChangeProperties::flip
+//---------------------------------------------------------
+
+void ChangeProperties::flip()
+      {
+      qCDebug(undoRedo) << "ChangeProperties::flip():" << propertyName(id) << changes.size() << "elements";
+      for (PropertyChange& c : changes)
+            flipProperty(c.element, id, c.value, c.propertyStyle);
+      }
+
 //---------------------------------------------------------
 //   ChangeMetaText::flip
 //---------------------------------------------------------
@@ -1006,6 +1006,34 @@ class ChangeProperty : public UndoCommand {
       UNDO_NAME("ChangeProperty")
       };
 
+//---------------------------------------------------------
+//   PropertyChange
+//---------------------------------------------------------
+
+struct PropertyChange {
+      ScoreElement* element;
+      QVariant value;
+      PropertyStyle propertyStyle;
+      };
+
+//---------------------------------------------------------
+//   ChangeProperties
+//    one property of many elements, see
+//    Score::undoChangeProperties()
+//---------------------------------------------------------
+
+class ChangeProperties : public UndoCommand {
+      P_ID id;
+      std::vector<PropertyChange> changes;
+
+      void flip();
+
+   public:
+      ChangeProperties(P_ID i, std::vector<PropertyChange>&& l) : id(i), changes(std::move(l)) {}
+      P_ID getId() const  { return id; }
+      UNDO_NAME("ChangeProperties")
+      };
+
 //---------------------------------------------------------
 //   ChangeMetaText
 //---------------------------------------------------------
@@ -94,31 +94,26 @@ void ContinuousPanel::paint(const QRect&, QPainter& painter)
       _y -= 6 * _spatium;
 
       //
-      // Check elements at current panel position
+      // Find the measure at current panel position from the
+      // measure offsets of the system; the bsp tree of the
+      // continuous view is expensive to rebuild after layout
       //
       _offsetPanel = -(_sv->xoffset()) / _sv->mag();
       _rect        = QRect(_offsetPanel + _width, _y, 1, _height);
-      Page* page   = _score->pages().front();
-      QList<Element*> el = page->items(_rect);
-      if (el.empty()) {
+      const std::vector<MeasureBase*>& ml = system->measures();
+      size_t idx = system->measureIndex(_offsetPanel + _width - system->pagePos().x());
+      if (idx >= ml.size() || !ml[idx]->isMeasure()) {
             _visible = false;
             return;
             }
-      qStableSort(el.begin(), el.end(), elementLessThan);
+      Measure* _currentMeasure = toMeasure(ml[idx]);
 
-      const Measure*_currentMeasure = 0;
-      for (const Element* e : el) {
-            e->itemDiscovered = 0;
-            if (!e->visible() && !_score->showInvisible())
-                  continue;
-
-            if (e->isMeasure()) {
-                  _currentMeasure = toMeasure(e);
-                  break;
-                  }
+      // staff lines of the current measure
+      QList<Element*> el;
+      for (int i = 0; i < _score->nstaves(); ++i) {
+            if (system->staff(i)->show() && _score->staff(i)->show())
+                  el.append(_currentMeasure->staffLines(i));
             }
-      if (!_currentMeasure)
-            return;
 
       qreal _xPosMeasure       = _currentMeasure->canvasX();
       qreal _measureWidth      = _currentMeasure->width();
@@ -54,8 +54,9 @@ void ScoreView::startDrag()
             staffUserDist = dragStaff->userDist();
             }
       else {
+            data.startDragPositions.clear();
             foreach(Element* e, _score->selection().elements())
-                  e->setStartDragPosition(e->userOff());
+                  data.startDragPositions.insert(e, e->userOff());
             }
       _score->update();
       }
@@ -93,7 +94,6 @@ void ScoreView::doDragElement(QMouseEvent* ev)
                   dragStaff->setUserDist(dist);
                   data.startMove += delta;
 //TODO-ws                  _score->doLayoutSystems();
-//                  _score->layoutSpanner();
                   _score->setLayoutAll();
                   _score->update();
 //                  update();
@@ -149,11 +149,13 @@ void ScoreView::endDrag()
       else {
             foreach (Element* e, _score->selection().elements()) {
                   e->endDrag();
-                  if (e->userOff() != e->startDragPosition()) {
+                  QPointF startDragPosition = data.startDragPositions.value(e);
+                  if (e->userOff() != startDragPosition) {
                         e->undoChangeProperty(P_ID::AUTOPLACE, false);
-                        e->score()->undoPropertyChanged(e, P_ID::USER_OFF, e->startDragPosition());
+                        e->score()->undoPropertyChanged(e, P_ID::USER_OFF, startDragPosition);
                         }
                   }
+            data.startDragPositions.clear();
             }
       _score->setLayoutAll();
       dragElement = 0;
@@ -19,6 +19,7 @@
 #include "inspector/inspector.h"
 
 #include "libmscore/barline.h"
+#include "libmscore/beam.h"
 #include "libmscore/utils.h"
 #include "libmscore/segment.h"
 #include "libmscore/score.h"
@@ -201,6 +202,8 @@ void ScoreView::doDragEdit(QMouseEvent* ev)
             data.vRaster = false;
             editObject->editDrag(data);
             updateGrips();
+            if (editObject->isBeam())
+                  _score->layoutSpanner(toBeam(editObject));     // ties of the beamed chords follow the beam
             }
       QRectF r(editObject->canvasBoundingRect());
       _score->addRefresh(r);
@@ -217,7 +220,7 @@ void ScoreView::endDragEdit()
       editObject->endEditDrag();
       setDropTarget(0);
       updateGrips();
-      _score->rebuildBspTree();
+      _score->invalidateBspTree();
       _score->addRefresh(editObject->canvasBoundingRect());
       _score->update();
       }
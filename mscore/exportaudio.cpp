@@ -27,6 +27,7 @@
 #include "synthesizer/msynthesizer.h"
 #include "musescore.h"
 #include "preferences.h"
+#include "libmscore/trace.h"
 
 namespace Ms {
 
@@ -38,6 +39,7 @@ namespace Ms {
 
 bool MuseScore::saveAudio(Score* score, const QString& name)
       {
+      TRACE_SPAN("MuseScore::saveAudio", "export");
       int format;
       if (name.endsWith(".wav"))
             format = SF_FORMAT_WAV | SF_FORMAT_PCM_16;
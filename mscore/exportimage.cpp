@@ -0,0 +1,288 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2016 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include "exportimage.h"
+#include "svggenerator.h"
+#include "pngwriter.h"
+#include "libmscore/score.h"
+#include "libmscore/page.h"
+#include "libmscore/system.h"
+#include "libmscore/measure.h"
+#include "libmscore/staff.h"
+#include "libmscore/sym.h"
+#include "libmscore/mscore.h"
+
+namespace Ms {
+
+//---------------------------------------------------------
+//   paintElement(s)
+//---------------------------------------------------------
+
+static void paintElement(QPainter& p, const Element* e)
+      {
+      QPointF pos(e->pagePos());
+      p.translate(pos);
+      e->draw(&p);
+      p.translate(-pos);
+      }
+
+static void paintElements(QPainter& p, const QList<Element*>& el)
+      {
+      for (Element* e : el) {
+            if (!e->visible())
+                  continue;
+            paintElement(p, e);
+            }
+      }
+
+//---------------------------------------------------------
+//   savePngBands
+//    Page images larger than MAX_PNG_IMAGE_BYTES are
+//    rendered in horizontal bands of at most that size.
+//    Every band is compressed and written before the next
+//    one is painted, so memory use does not depend on
+//    page size and resolution. All elements are painted
+//    into every band and clipped by the image, as slurs,
+//    stems etc. can draw outside of their bbox.
+//---------------------------------------------------------
+
+static const qint64 MAX_PNG_IMAGE_BYTES = 64 * 1024 * 1024;
+
+static bool savePngBands(const QString& fileName, const QList<Element*>& el, const QPointF& origin,
+   int w, int h, double convDpi, bool transparent, QImage::Format format)
+      {
+      QFile file(fileName);
+      if (!file.open(QIODevice::WriteOnly))
+            return false;
+      PngWriter png(&file, w, h, convDpi, transparent);
+
+      const double mag      = convDpi / DPI;
+      const int bandHeight  = qMax(1, int(MAX_PNG_IMAGE_BYTES / (qint64(w) * 4)));
+      for (int y = 0; y < h; y += bandHeight) {
+            const int bh = qMin(bandHeight, h - y);
+            QImage band(w, bh, format);
+            band.fill(transparent ? 0 : 0xffffffff);
+
+            QPainter p(&band);
+            p.setRenderHint(QPainter::Antialiasing, true);
+            p.setRenderHint(QPainter::TextAntialiasing, true);
+            p.translate(0.0, -y);
+            p.scale(mag, mag);
+            p.translate(-origin);
+            paintElements(p, el);
+            p.end();
+            if (!png.writeRows(band))
+                  return false;
+            }
+      return png.finish();
+      }
+
+//---------------------------------------------------------
+//   savePngPage
+//    return true on success
+//---------------------------------------------------------
+
+bool savePngPage(Page* page, const QString& fileName, bool transparent, double convDpi, int trimMargin, QImage::Format format)
+      {
+      QImage::Format f;
+      if (format != QImage::Format_Indexed8)
+          f = format;
+      else
+          f = QImage::Format_ARGB32_Premultiplied;
+
+      QRectF r;
+      if (trimMargin >= 0) {
+            QMarginsF margins(trimMargin, trimMargin, trimMargin, trimMargin);
+            r = page->tbbox() + margins;
+            }
+      else
+            r = page->abbox();
+      int w = lrint(r.width()  * convDpi / DPI);
+      int h = lrint(r.height() * convDpi / DPI);
+
+      QList<Element*> pel = page->elements();
+      qStableSort(pel.begin(), pel.end(), elementLessThan);
+
+      if (format != QImage::Format_Indexed8 && qint64(w) * h * 4 > MAX_PNG_IMAGE_BYTES)
+            return savePngBands(fileName, pel, trimMargin >= 0 ? r.topLeft() : QPointF(), w, h, convDpi, transparent, f);
+
+      QImage printer(w, h, f);
+      printer.setDotsPerMeterX(lrint((convDpi * 1000) / INCH));
+      printer.setDotsPerMeterY(lrint((convDpi * 1000) / INCH));
+
+      printer.fill(transparent ? 0 : 0xffffffff);
+
+      double mag = convDpi / DPI;
+      QPainter p(&printer);
+      p.setRenderHint(QPainter::Antialiasing, true);
+      p.setRenderHint(QPainter::TextAntialiasing, true);
+      p.scale(mag, mag);
+      if (trimMargin >= 0)
+            p.translate(-r.topLeft());
+
+      paintElements(p, pel);
+      p.end();
+
+      if (format == QImage::Format_Indexed8) {
+            //convert to grayscale & respect alpha
+            QVector<QRgb> colorTable;
+            colorTable.push_back(QColor(0, 0, 0, 0).rgba());
+            if (!transparent) {
+                  for (int i = 1; i < 256; i++)
+                        colorTable.push_back(QColor(i, i, i).rgb());
+                  }
+            else {
+                  for (int i = 1; i < 256; i++)
+                        colorTable.push_back(QColor(0, 0, 0, i).rgba());
+                  }
+            printer = printer.convertToFormat(QImage::Format_Indexed8, colorTable);
+            }
+
+      return printer.save(fileName, "png");
+      }
+
+//---------------------------------------------------------
+//   paintSvgPage
+//---------------------------------------------------------
+
+void paintSvgPage(SvgGenerator& printer, QPainter& p, Score* score, Page* page)
+{
+      // 1st pass: StaffLines
+      for  (System* s : page->systems()) {
+            for (int i = 0, n = s->staves()->size(); i < n; i++) {
+                  if (score->staff(i)->invisible())
+                        continue;  // ignore invisible staves
+
+                  // The goal here is to draw SVG staff lines more efficiently.
+                  // MuseScore draws staff lines by measure, but for SVG they can
+                  // generally be drawn once for each system. This makes a big
+                  // difference for scores that scroll horizontally on a single
+                  // page. But there are exceptions to this rule:
+                  //
+                  //   ~ One (or more) invisible measure(s) in a system/staff ~
+                  //   ~ One (or more) elements of type HBOX or VBOX          ~
+                  //
+                  // In these cases the SVG staff lines for the system/staff
+                  // are drawn by measure.
+                  //
+                  bool byMeasure = false;
+                  for (MeasureBase* mb = s->firstMeasure(); mb != 0; mb = s->nextMeasure(mb)) {
+                        if (mb->type() == Element::Type::HBOX
+                         || mb->type() == Element::Type::VBOX
+                         || !static_cast<Measure*>(mb)->visible(i)) {
+                              byMeasure = true;
+                              break;
+                        }
+                  }
+                  if (byMeasure) { // Draw visible staff lines by measure
+                        for (MeasureBase* mb = s->firstMeasure(); mb != 0; mb = s->nextMeasure(mb)) {
+                              if (mb->type() != Element::Type::HBOX
+                               && mb->type() != Element::Type::VBOX
+                               && static_cast<Measure*>(mb)->visible(i)) {
+                                    StaffLines* sl = static_cast<Measure*>(mb)->staffLines(i);
+                                    printer.setElement(sl);
+                                    paintElement(p, sl);
+                              }
+                        }
+                  }
+                  else { // Draw staff lines once per system
+                        StaffLines* firstSL = s->firstMeasure()->staffLines(i)->clone();
+                        StaffLines*  lastSL =  s->lastMeasure()->staffLines(i);
+                        firstSL->bbox().setRight(lastSL->bbox().right()
+                                              +  lastSL->pagePos().x()
+                                              - firstSL->pagePos().x());
+                        printer.setElement(firstSL);
+                        paintElement(p, firstSL);
+                        delete firstSL;
+                  }
+            }
+      }
+      // 2nd pass: the rest of the elements
+      QList<Element*> pel = page->elements();
+      qStableSort(pel.begin(), pel.end(), elementLessThan);
+
+      Element::Type eType;
+      for (const Element* e : pel) {
+            // Always exclude invisible elements
+            if (!e->visible())
+                  continue;
+
+            eType = e->type();
+            switch (eType) { // In future sub-type code, this switch() grows, and eType gets used
+            case Element::Type::STAFF_LINES : // Handled in the 1st pass above
+                  continue; // Exclude from 2nd pass
+                  break;
+            default:
+                  break;
+            } // switch(eType)
+
+            // Set the Element pointer inside SvgGenerator/SvgPaintEngine
+            printer.setElement(e);
+
+            // Paint it
+            paintElement(p, e);
+      }
+}
+
+//---------------------------------------------------------
+//   saveSvgPages
+//    One file per page, named like the png export. Pages
+//    are painted one after another in this thread, like
+//    png pages: drawing elements uses fonts, glyph paths
+//    and layout data of the score, which are not thread
+//    safe. Each page is streamed to its file while painted.
+//---------------------------------------------------------
+
+bool saveSvgPages(Score* score, const QString& saveName, bool useSymbols)
+      {
+      QString baseName(saveName);
+      if (baseName.endsWith(".svg"))
+            baseName.chop(4);
+      const QList<Page*>& pl = score->pages();
+      const int padding      = QString("%1").arg(pl.size()).size();
+      const PageFormat* pf   = score->pageFormat();
+      const qreal w          = pf->width() * DPI;
+      const qreal h          = pf->height() * DPI;
+      const QString title(score->title());
+
+      score->setPrinting(true);
+      MScore::pdfPrinting = true;
+      MScore::printGlyphPaths = !useSymbols;
+
+      bool ok = true;
+      for (int pageIndex = 0; pageIndex < pl.size(); ++pageIndex) {
+            SvgGenerator printer;
+            printer.setTitle(title);
+            printer.setFileName(QString("%1-%2.svg").arg(baseName).arg(pageIndex + 1, padding, 10, QLatin1Char('0')));
+            printer.setUseSymbols(useSymbols);
+            printer.setSize(QSize(w, h));
+            printer.setViewBox(QRectF(0, 0, w, h));
+            QPainter p;
+            if (!p.begin(&printer)) {
+                  ok = false;
+                  break;
+                  }
+            p.setRenderHint(QPainter::Antialiasing, true);
+            p.setRenderHint(QPainter::TextAntialiasing, true);
+            paintSvgPage(printer, p, score, pl.at(pageIndex));
+            p.end();
+            }
+
+      score->setPrinting(false);
+      MScore::pdfPrinting = false;
+      MScore::printGlyphPaths = false;
+      ScoreFont::traceGlyphPaths();
+      return ok;
+      }
+
+} // namespace Ms
+
@@ -0,0 +1,34 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2016 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#ifndef __EXPORTIMAGE_H__
+#define __EXPORTIMAGE_H__
+
+namespace Ms {
+
+class Score;
+class Page;
+class SvgGenerator;
+
+//---------------------------------------------------------
+//   page image export
+//    used by MuseScore::savePng() and MuseScore::saveSvg();
+//    savePngPage() expects the score in printing mode
+//---------------------------------------------------------
+
+extern bool savePngPage(Page*, const QString& fileName, bool transparent, double convDpi, int trimMargin, QImage::Format);
+extern void paintSvgPage(SvgGenerator&, QPainter&, Score*, Page*);
+extern bool saveSvgPages(Score*, const QString& saveName, bool useSymbols);
+
+} // namespace Ms
+#endif
+
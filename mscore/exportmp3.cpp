@@ -25,6 +25,7 @@
 #include "libmscore/part.h"
 #include "preferences.h"
 #include "exportmp3.h"
+#include "libmscore/trace.h"
 
 namespace Ms {
 
@@ -612,6 +613,7 @@ QString MP3Exporter::getLibraryTypeString()
 
 bool MuseScore::saveMp3(Score* score, const QString& name)
       {
+      TRACE_SPAN("MuseScore::saveMp3", "export");
       EventMap events;
       score->renderMidi(&events);
       if(events.size() == 0)
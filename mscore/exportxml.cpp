@@ -98,6 +98,7 @@
 #include "libmscore/tie.h"
 #include "libmscore/undo.h"
 #include "musicxmlfonthandler.h"
+#include "libmscore/trace.h"
 
 namespace Ms {
 
@@ -5359,6 +5360,7 @@ void ExportMusicXml::write(QIODevice* dev)
 
 bool saveXml(Score* score, const QString& name)
       {
+      TRACE_SPAN("saveXml", "export");
       QFile f(name);
       if (!f.open(QIODevice::WriteOnly))
             return false;
@@ -5389,6 +5391,7 @@ bool saveXml(Score* score, const QString& name)
 
 bool saveMxl(Score* score, const QString& name)
       {
+      TRACE_SPAN("saveMxl", "export");
       MQZipWriter uz(name);
 
       QFileInfo fi(name);
@@ -72,6 +72,7 @@
 #include "libmscore/image.h"
 #include "synthesizer/msynthesizer.h"
 #include "svggenerator.h"
+#include "exportimage.h"
 #include "scorePreview.h"
 
 #ifdef OMR
@@ -83,6 +84,7 @@
 #include "diff/diff_match_patch.h"
 #include "libmscore/chordlist.h"
 #include "libmscore/mscore.h"
+#include "libmscore/trace.h"
 #include "thirdparty/qzip/qzipreader_p.h"
 
 
@@ -92,27 +94,6 @@ extern void importSoundfont(QString name);
 extern bool savePositions(Score*, const QString& name, bool segments);
 extern MasterSynthesizer* synti;
 
-//---------------------------------------------------------
-//   paintElement(s)
-//---------------------------------------------------------
-
-static void paintElement(QPainter& p, const Element* e)
-      {
-      QPointF pos(e->pagePos());
-      p.translate(pos);
-      e->draw(&p);
-      p.translate(-pos);
-      }
-
-static void paintElements(QPainter& p, const QList<Element*>& el)
-      {
-      for (Element* e : el) {
-            if (!e->visible())
-                  continue;
-            paintElement(p, e);
-            }
-      }
-
 //---------------------------------------------------------
 //   createDefaultFileName
 //---------------------------------------------------------
@@ -380,6 +361,7 @@ bool MuseScore::saveFile()
 
 bool MuseScore::saveFile(Score* score)
       {
+      TRACE_SPAN("MuseScore::saveFile", "file");
       if (score == 0)
             return false;
       if (score->created()) {
@@ -758,9 +740,10 @@ void MuseScore::newFile()
             xs->style()->set(StyleIdx::createMultiMeasureRests, true);
             x->setPartScore(xs);
             score->excerpts().append(x);
-            createExcerpt(x);
-            score->setExcerptsChanged(true);
             }
+      createExcerpts(excerpts);
+      if (!excerpts.isEmpty())
+            score->setExcerptsChanged(true);
       }
 
 //---------------------------------------------------------
@@ -1867,6 +1850,7 @@ bool MuseScore::saveAs(Score* cs, bool saveCopy, const QString& path, const QStr
 
 bool MuseScore::saveMidi(Score* score, const QString& name)
       {
+      TRACE_SPAN("MuseScore::saveMidi", "export");
       ExportMidi em(score);
       return em.write(name, preferences.midiExpandRepeats);
       }
@@ -1882,6 +1866,7 @@ bool MuseScore::savePdf(const QString& saveName)
 
 bool MuseScore::savePdf(Score* cs, const QString& saveName)
       {
+      TRACE_SPAN("MuseScore::savePdf", "export");
       cs->setPrinting(true);
       MScore::pdfPrinting = true;
       QPdfWriter printerDev(saveName);
@@ -1919,6 +1904,7 @@ bool MuseScore::savePdf(Score* cs, const QString& saveName)
 
 bool MuseScore::savePdf(QList<Score*> cs, const QString& saveName)
       {
+      TRACE_SPAN("MuseScore::savePdf", "export");
       if (cs.empty())
             return false;
       Score* firstScore = cs[0];
@@ -2025,6 +2011,7 @@ void importSoundfont(QString name)
 
 Score::FileError readScore(MasterScore* score, QString name, bool ignoreVersionError)
       {
+      TRACE_SPAN("readScore", "file");
       QFileInfo info(name);
       QString suffix  = info.suffix().toLower();
       score->setName(info.completeBaseName());
@@ -2319,15 +2306,10 @@ bool MuseScore::savePng(Score* score, const QString& name)
 
 bool MuseScore::savePng(Score* score, const QString& name, bool screenshot, bool transparent, double convDpi, int trimMargin, QImage::Format format)
       {
+      TRACE_SPAN("MuseScore::savePng", "export");
       bool rv = true;
       score->setPrinting(!screenshot);    // dont print page break symbols etc.
 
-      QImage::Format f;
-      if (format != QImage::Format_Indexed8)
-          f = format;
-      else
-          f = QImage::Format_ARGB32_Premultiplied;
-
       const QList<Page*>& pl = score->pages();
       int pages = pl.size();
 
@@ -2337,49 +2319,6 @@ bool MuseScore::savePng(Score* score, const QString& name, bool screenshot, bool
       for (int pageNumber = 0; pageNumber < pages; ++pageNumber) {
             Page* page = pl.at(pageNumber);
 
-            QRectF r;
-            if (trimMargin >= 0) {
-                  QMarginsF margins(trimMargin, trimMargin, trimMargin, trimMargin);
-                  r = page->tbbox() + margins;
-                  }
-            else
-                  r = page->abbox();
-            int w = lrint(r.width()  * convDpi / DPI);
-            int h = lrint(r.height() * convDpi / DPI);
-
-            QImage printer(w, h, f);
-            printer.setDotsPerMeterX(lrint((convDpi * 1000) / INCH));
-            printer.setDotsPerMeterY(lrint((convDpi * 1000) / INCH));
-
-            printer.fill(transparent ? 0 : 0xffffffff);
-
-            double mag = convDpi / DPI;
-            QPainter p(&printer);
-            p.setRenderHint(QPainter::Antialiasing, true);
-            p.setRenderHint(QPainter::TextAntialiasing, true);
-            p.scale(mag, mag);
-            if (trimMargin >= 0)
-                  p.translate(-r.topLeft());
-
-            QList<Element*> pel = page->elements();
-            qStableSort(pel.begin(), pel.end(), elementLessThan);
-            paintElements(p, pel);
-
-            if (format == QImage::Format_Indexed8) {
-                  //convert to grayscale & respect alpha
-                  QVector<QRgb> colorTable;
-                  colorTable.push_back(QColor(0, 0, 0, 0).rgba());
-                  if (!transparent) {
-                        for (int i = 1; i < 256; i++)
-                              colorTable.push_back(QColor(i, i, i).rgb());
-                        }
-                  else {
-                        for (int i = 1; i < 256; i++)
-                              colorTable.push_back(QColor(0, 0, 0, i).rgba());
-                        }
-                  printer = printer.convertToFormat(QImage::Format_Indexed8, colorTable);
-                  }
-
             QString fileName(name);
             if (fileName.endsWith(".png"))
                   fileName = fileName.left(fileName.size() - 4);
@@ -2408,7 +2347,8 @@ bool MuseScore::savePng(Score* score, const QString& name, bool screenshot, bool
                               continue;
                         }
                   }
-            rv = printer.save(fileName, "png");
+
+            rv = savePngPage(page, fileName, transparent, convDpi, trimMargin, format);
             if (!rv)
                   break;
             }
@@ -2525,11 +2465,16 @@ QString MuseScore::getWallpaper(const QString& caption)
 //
 bool MuseScore::saveSvg(Score* score, const QString& saveName)
 {
+      TRACE_SPAN("MuseScore::saveSvg", "export");
+      if (preferences.svgOneFilePerPage && score->npages() > 1)
+            return saveSvgPages(score, saveName, preferences.svgUseSymbols);
+
     SvgGenerator printer;
 
       QString title(score->title());
       printer.setTitle(title);
       printer.setFileName(saveName);
+      printer.setUseSymbols(preferences.svgUseSymbols);
       const PageFormat* pf = score->pageFormat();
 
       QRectF r;
@@ -2547,6 +2492,7 @@ bool MuseScore::saveSvg(Score* score, const QString& saveName)
 
       score->setPrinting(true);
       MScore::pdfPrinting = true;
+      MScore::printGlyphPaths = !preferences.svgUseSymbols;
 
       QPainter p(&printer);
       p.setRenderHint(QPainter::Antialiasing, true);
@@ -2556,86 +2502,15 @@ bool MuseScore::saveSvg(Score* score, const QString& saveName)
             p.translate(-r.topLeft());
 
       for (Page* page : score->pages()) {
-            // 1st pass: StaffLines
-            for  (System* s : page->systems()) {
-                  for (int i = 0, n = s->staves()->size(); i < n; i++) {
-                        if (score->staff(i)->invisible())
-                              continue;  // ignore invisible staves
-
-                        // The goal here is to draw SVG staff lines more efficiently.
-                        // MuseScore draws staff lines by measure, but for SVG they can
-                        // generally be drawn once for each system. This makes a big
-                        // difference for scores that scroll horizontally on a single
-                        // page. But there are exceptions to this rule:
-                        //
-                        //   ~ One (or more) invisible measure(s) in a system/staff ~
-                        //   ~ One (or more) elements of type HBOX or VBOX          ~
-                        //
-                        // In these cases the SVG staff lines for the system/staff
-                        // are drawn by measure.
-                        //
-                        bool byMeasure = false;
-                        for (MeasureBase* mb = s->firstMeasure(); mb != 0; mb = s->nextMeasure(mb)) {
-                              if (mb->type() == Element::Type::HBOX
-                               || mb->type() == Element::Type::VBOX
-                               || !static_cast<Measure*>(mb)->visible(i)) {
-                                    byMeasure = true;
-                                    break;
-                              }
-                        }
-                        if (byMeasure) { // Draw visible staff lines by measure
-                              for (MeasureBase* mb = s->firstMeasure(); mb != 0; mb = s->nextMeasure(mb)) {
-                                    if (mb->type() != Element::Type::HBOX
-                                     && mb->type() != Element::Type::VBOX
-                                     && static_cast<Measure*>(mb)->visible(i)) {
-                                          StaffLines* sl = static_cast<Measure*>(mb)->staffLines(i);
-                                          printer.setElement(sl);
-                                          paintElement(p, sl);
-                                    }
-                              }
-                        }
-                        else { // Draw staff lines once per system
-                              StaffLines* firstSL = s->firstMeasure()->staffLines(i)->clone();
-                              StaffLines*  lastSL =  s->lastMeasure()->staffLines(i);
-                              firstSL->bbox().setRight(lastSL->bbox().right()
-                                                    +  lastSL->pagePos().x()
-                                                    - firstSL->pagePos().x());
-                              printer.setElement(firstSL);
-                              paintElement(p, firstSL);
-                        }
-                  }
-            }
-            // 2nd pass: the rest of the elements
-            QList<Element*> pel = page->elements();
-            qStableSort(pel.begin(), pel.end(), elementLessThan);
-
-            Element::Type eType;
-            for (const Element* e : pel) {
-                  // Always exclude invisible elements
-                  if (!e->visible())
-                        continue;
-
-                  eType = e->type();
-                  switch (eType) { // In future sub-type code, this switch() grows, and eType gets used
-                  case Element::Type::STAFF_LINES : // Handled in the 1st pass above
-                        continue; // Exclude from 2nd pass
-                        break;
-                  default:
-                        break;
-                  } // switch(eType)
-
-                  // Set the Element pointer inside SvgGenerator/SvgPaintEngine
-                  printer.setElement(e);
-
-                  // Paint it
-                  paintElement(p, e);
-            }
+            paintSvgPage(printer, p, score, page);
             p.translate(QPointF(pf->width() * DPI, 0.0));
       }
 
       // Clean up and return
       score->setPrinting(false);
       MScore::pdfPrinting = false;
+      MScore::printGlyphPaths = false;
+      ScoreFont::traceGlyphPaths();
       p.end(); // Writes MuseScore SVG file to disk, finally
       return true;
 }
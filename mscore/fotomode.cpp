@@ -802,8 +802,10 @@ bool ScoreView::saveFotoAs(bool printMode, const QRectF& r)
             printer.setViewBox(QRect(0, 0, w, h));
             QPainter p(&printer);
             MScore::pdfPrinting = true;
+            MScore::printGlyphPaths = true;
             paintRect(printMode, p, r, mag);
             MScore::pdfPrinting = false;
+            MScore::printGlyphPaths = false;
             }
       else if (ext == "png") {
             QImage::Format f = QImage::Format_ARGB32_Premultiplied;
@@ -878,8 +880,10 @@ void ScoreView::fotoDragDrop(QMouseEvent*)
       printer.setViewBox(QRect(0, 0, w, h));
       QPainter p(&printer);
       MScore::pdfPrinting = true;
+      MScore::printGlyphPaths = true;
       paintRect(printMode, p, r, 1);
       MScore::pdfPrinting = false;
+      MScore::printGlyphPaths = false;
 
       QDrag* drag = new QDrag(this);
       QMimeData* mimeData = new QMimeData;
@@ -58,6 +58,8 @@
 #include "importmidi_simplify.h"
 #include "importmidi_voice.h"
 #include "importmidi_operations.h"
+#include "importmidi_parallel.h"
+#include "importmidi_cache.h"
 #include "importmidi_key.h"
 #include "importmidi_instrument.h"
 #include "importmidi_chordname.h"
@@ -164,7 +166,7 @@ void setChordVoice(MidiChord &chord, int voice)
             }
       }
 
-void findAllTupletsForDrums(
+bool findAllTupletsForDrums(
             MTrack &mtrack,
             TimeSigMap *sigmap,
             const ReducedFraction &basicQuant)
@@ -188,9 +190,11 @@ void findAllTupletsForDrums(
 
       std::vector<std::multimap<ReducedFraction,
                                 MidiTuplet::TupletData> > tuplets(drumVoiceCount);
+      bool reproducible = true;
       for (size_t voice = 0; voice < drumVoiceCount; ++voice) {
-            if (!chords[voice].empty())
-                  MidiTuplet::findAllTuplets(tuplets[voice], chords[voice], sigmap, basicQuant);
+            if (!chords[voice].empty()
+                        && !MidiTuplet::findAllTuplets(tuplets[voice], chords[voice], sigmap, basicQuant))
+                  reproducible = false;
             }
       mtrack.chords.clear();
       for (size_t voice = 0; voice < drumVoiceCount; ++voice) {
@@ -202,6 +206,7 @@ void findAllTupletsForDrums(
             }
       mtrack.updateTupletsFromChords();
       // note: temporary local tuplets and chords are deleted here
+      return reproducible;
       }
 
 void quantizeAllTracks(std::multimap<int, MTrack> &tracks,
@@ -210,22 +215,32 @@ void quantizeAllTracks(std::multimap<int, MTrack> &tracks,
       {
       auto &opers = preferences.midiImportOperations;
 
-      for (auto &track: tracks) {
-            MTrack &mtrack = track.second;
-            if (mtrack.chords.empty())
-                  continue;
-                        // pass current track index through MidiImportOperations
-                        // for further usage
-            MidiOperations::CurrentTrackSetter setCurrentTrack{opers, mtrack.indexOfOperation};
-
-            if (opers.data()->processingsOfOpenedFile == 0) {
+                  // operations are changed here, before the concurrent part
+      if (opers.data()->processingsOfOpenedFile == 0) {
+            for (const auto &track: tracks) {
+                  const MTrack &mtrack = track.second;
+                  if (mtrack.chords.empty())
+                        continue;
                   opers.data()->trackOpers.isDrumTrack.setValue(
-                                          opers.currentTrack(), mtrack.mtrack->drumTrack());
+                                          mtrack.indexOfOperation, mtrack.mtrack->drumTrack());
                   if (mtrack.mtrack->drumTrack()) {
                         opers.data()->trackOpers.maxVoiceCount.setValue(
-                                          opers.currentTrack(), MidiOperations::VoiceCount::V_1);
+                                          mtrack.indexOfOperation, MidiOperations::VoiceCount::V_1);
                         }
                   }
+            }
+
+                  // tracks are quantized independently, current track index is passed
+                  // through MidiImportOperations for further usage
+      MidiCache::TrackCache *cache = opers.data()->trackCache.get();
+      MidiOperations::Diagnostics *diagnostics = opers.data()->diagnostics.get();
+      diagnostics->reset();
+
+      MidiParallel::forEachTrack(tracks, [&opers, cache, sigmap, &lastTick](MTrack &mtrack) {
+            const MidiCache::Key key = cache->key(MidiCache::Stage::QUANTIZATION, mtrack, sigmap, lastTick);
+            if (cache->restore(MidiCache::Stage::QUANTIZATION, key, mtrack))
+                  return;
+
             const auto basicQuant = Quantize::quantValueToFraction(
                         opers.data()->trackOpers.quantValue.value(mtrack.indexOfOperation));
 
@@ -234,12 +249,12 @@ void quantizeAllTracks(std::multimap<int, MTrack> &tracks,
 
             MChord::setBarIndexes(mtrack.chords, basicQuant, lastTick, sigmap);
 
-            if (mtrack.mtrack->drumTrack())
-                  findAllTupletsForDrums(mtrack, sigmap, basicQuant);
-            else
-                  MidiTuplet::findAllTuplets(mtrack.tuplets, mtrack.chords, sigmap, basicQuant);
+                        // a tuplet search cut by time is not cached
+            const bool reproducible = mtrack.mtrack->drumTrack()
+                        ? findAllTupletsForDrums(mtrack, sigmap, basicQuant)
+                        : MidiTuplet::findAllTuplets(mtrack.tuplets, mtrack.chords, sigmap, basicQuant);
 
-            Q_ASSERT_X(!doNotesOverlap(track.second),
+            Q_ASSERT_X(!doNotesOverlap(mtrack),
                        "quantizeAllTracks",
                        "There are overlapping notes of the same voice that is incorrect");
 
@@ -252,6 +267,15 @@ void quantizeAllTracks(std::multimap<int, MTrack> &tracks,
             Q_ASSERT_X(MidiTuplet::areTupletRangesOk(mtrack.chords, mtrack.tuplets),
                        "quantizeAllTracks", "Tuplet chord/note is outside tuplet "
                         "or non-tuplet chord/note is inside tuplet");
+
+            if (reproducible)
+                  cache->store(MidiCache::Stage::QUANTIZATION, key, mtrack);
+            });
+
+      if (diagnostics->tupletSearchLimitReached > 0) {
+            qDebug("importMidi: tuplet search limit reached in %d bar(s), %lld combinations explored",
+                   int(diagnostics->tupletSearchLimitReached),
+                   (long long)diagnostics->tupletSearchNodes);
             }
       }
 
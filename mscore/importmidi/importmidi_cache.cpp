@@ -0,0 +1,202 @@
+#include "importmidi_cache.h"
+#include "importmidi_operations.h"
+#include "mscore/preferences.h"
+#include "libmscore/sig.h"
+#include "midi/midifile.h"
+
+
+namespace Ms {
+namespace MidiCache {
+
+namespace {
+
+// FNV-1a, 64 bit, and the hashed data
+class Hasher
+      {
+   public:
+      void add(quint64 value)
+            {
+            for (int i = 0; i != 8; ++i) {
+                  const char byte = char((value >> (i * 8)) & 0xff);
+                  _hash ^= uchar(byte);
+                  _hash *= 1099511628211ULL;
+                  _data.append(byte);
+                  }
+            }
+      void add(int value)  { add(quint64(qint64(value))); }
+      void add(bool value) { add(quint64(value)); }
+      void add(const ReducedFraction &value)
+            {
+            add(value.numerator());
+            add(value.denominator());
+            }
+      Key result() const { return Key{_hash, _data}; }
+
+   private:
+      quint64 _hash = 14695981039346656037ULL;
+      QByteArray _data;
+      };
+
+void addTuplet(Hasher &h,
+               bool isInTuplet,
+               const std::multimap<ReducedFraction, MidiTuplet::TupletData>::iterator &tuplet)
+      {
+      h.add(isInTuplet);
+      if (isInTuplet) {
+            h.add(tuplet->second.onTime);
+            h.add(tuplet->second.voice);
+            }
+      }
+
+void addChords(Hasher &h, const MTrack &mtrack)
+      {
+      h.add(int(mtrack.chords.size()));
+      for (const auto &chord: mtrack.chords) {
+            h.add(chord.first);
+            h.add(chord.second.voice);
+            h.add(chord.second.barIndex);
+            addTuplet(h, chord.second.isInTuplet, chord.second.tuplet);
+            h.add(chord.second.notes.size());
+            for (const auto &note: chord.second.notes) {
+                  h.add(note.pitch);
+                  h.add(note.velo);
+                  h.add(note.offTime);
+                  h.add(note.staccato);
+                  addTuplet(h, note.isInTuplet, note.tuplet);
+                  h.add(note.offTimeQuant);
+                  h.add(note.origOnTime);
+                  }
+            }
+      h.add(int(mtrack.tuplets.size()));
+      for (const auto &tuplet: mtrack.tuplets) {
+            h.add(tuplet.first);
+            h.add(tuplet.second.voice);
+            h.add(tuplet.second.len);
+            h.add(tuplet.second.tupletNumber);
+            }
+      }
+
+void addOperations(Hasher &h, int trackIndex)
+      {
+      const auto &opers = preferences.midiImportOperations.data()->trackOpers;
+                  // operations for all tracks
+      h.add(opers.isHumanPerformance.value());
+      h.add(opers.measureCount2xLess.value());
+      h.add(opers.searchPickupMeasure.value());
+      h.add(int(opers.timeSigNumerator.value()));
+      h.add(int(opers.timeSigDenominator.value()));
+                  // operations of this track that affect the cached stages
+      h.add(opers.isDrumTrack.value(trackIndex));
+      h.add(int(opers.quantValue.value(trackIndex)));
+      h.add(opers.searchTuplets.value(trackIndex));
+      h.add(opers.search2plets.value(trackIndex));
+      h.add(opers.search3plets.value(trackIndex));
+      h.add(opers.search4plets.value(trackIndex));
+      h.add(opers.search5plets.value(trackIndex));
+      h.add(opers.search7plets.value(trackIndex));
+      h.add(opers.search9plets.value(trackIndex));
+      h.add(opers.useDots.value(trackIndex));
+      h.add(opers.simplifyDurations.value(trackIndex));
+      h.add(opers.showStaccato.value(trackIndex));
+      h.add(opers.doStaffSplit.value(trackIndex));
+      h.add(int(opers.maxVoiceCount.value(trackIndex)));
+                  // cut tuplet search can give a different result
+      const auto &limits = preferences.midiImportOperations.data()->tupletSearchLimits;
+      h.add(limits.maxNodes);
+      h.add(limits.maxTimeMs);
+      }
+
+void addTimeSigs(Hasher &h, const TimeSigMap *sigmap)
+      {
+      h.add(int(sigmap->size()));
+      for (const auto &sig: *sigmap) {
+            h.add(sig.first);
+            h.add(sig.second.timesig().numerator());
+            h.add(sig.second.timesig().denominator());
+            h.add(sig.second.nominal().numerator());
+            h.add(sig.second.nominal().denominator());
+            }
+      }
+
+} // namespace
+
+Key TrackCache::key(Stage stage,
+                    const MTrack &mtrack,
+                    const TimeSigMap *sigmap,
+                    const ReducedFraction &lastTick) const
+      {
+      Hasher h;
+      h.add(int(stage));
+      h.add(mtrack.indexOfOperation);
+      h.add(mtrack.mtrack->drumTrack());
+      h.add(lastTick);
+      addOperations(h, mtrack.indexOfOperation);
+      addTimeSigs(h, sigmap);
+      addChords(h, mtrack);
+      return h.result();
+      }
+
+bool TrackCache::restore(Stage stage, const Key &key, MTrack &mtrack, bool *flag)
+      {
+      QMutexLocker locker(&_mutex);
+
+      const auto it = _results.find({stage, mtrack.indexOfOperation});
+      if (it != _results.end()) {
+            for (const Result &result: it->second) {
+                  if (result.key != key)
+                        continue;
+                              // copy updates tuplet references of chords,
+                              // swap keeps them valid
+                  MTrack track(result.track);
+                  std::swap(mtrack.chords, track.chords);
+                  std::swap(mtrack.tuplets, track.tuplets);
+                  if (flag)
+                        *flag = result.flag;
+                  ++_hits;
+                  return true;
+                  }
+            }
+      ++_misses;
+      return false;
+      }
+
+void TrackCache::store(Stage stage, const Key &key, const MTrack &mtrack, bool flag)
+      {
+      Result result{key, mtrack, flag};
+
+      QMutexLocker locker(&_mutex);
+
+      auto &results = _results[{stage, mtrack.indexOfOperation}];
+      for (auto it = results.begin(); it != results.end(); ++it) {
+            if (it->key == key) {
+                  results.erase(it);
+                  break;
+                  }
+            }
+      results.push_front(std::move(result));
+      if (results.size() > MAX_RESULTS)
+            results.pop_back();
+      }
+
+void TrackCache::clear()
+      {
+      QMutexLocker locker(&_mutex);
+      _results.clear();
+      _hits = 0;
+      _misses = 0;
+      }
+
+int TrackCache::hits() const
+      {
+      QMutexLocker locker(&_mutex);
+      return _hits;
+      }
+
+int TrackCache::misses() const
+      {
+      QMutexLocker locker(&_mutex);
+      return _misses;
+      }
+
+} // namespace MidiCache
+} // namespace Ms
@@ -0,0 +1,82 @@
+#ifndef IMPORTMIDI_CACHE_H
+#define IMPORTMIDI_CACHE_H
+
+#include "importmidi_inner.h"
+#include "importmidi_chord.h"
+
+#include <deque>
+#include <map>
+
+
+namespace Ms {
+
+class TimeSigMap;
+
+namespace MidiCache {
+
+enum class Stage : char {
+      QUANTIZATION,           // bar indexes, tuplets, quantized chords
+      VOICE_SEPARATION
+      };
+
+// Stage input of one track: the hash is compared first,
+// the full data on equal hashes, so a hash collision is not a hit
+
+struct Key
+      {
+      quint64 hash = 0;
+      QByteArray data;
+
+      bool operator==(const Key &k) const { return hash == k.hash && data == k.data; }
+      bool operator!=(const Key &k) const { return !(*this == k); }
+      };
+
+// Results of the expensive per-track stages of the MIDI import,
+// stored for one opened MIDI file.
+//
+// Result is keyed by the stage input (chords and tuplets of the track),
+// the import operations that can change the stage result, the time sig map
+// and the last tick. So if the user changes operations of one track
+// in the import panel, the stages are recomputed only for that track.
+// Access is thread-safe: tracks are processed concurrently.
+
+class TrackCache
+      {
+   public:
+      Key key(Stage stage,
+              const MTrack &mtrack,
+              const TimeSigMap *sigmap,
+              const ReducedFraction &lastTick) const;
+                  // on success - chords and tuplets of the track are replaced
+                  // by the stored stage result
+      bool restore(Stage stage, const Key &key, MTrack &mtrack, bool *flag = nullptr);
+      void store(Stage stage, const Key &key, const MTrack &mtrack, bool flag = false);
+      void clear();
+
+      int hits() const;
+      int misses() const;
+
+   private:
+      struct Result
+            {
+            Key key;
+            MTrack track;
+            bool flag;
+            };
+                  // max number of remembered results per stage and track;
+                  // allows to go back to the previous option value
+                  // without recomputation
+      static const size_t MAX_RESULTS = 4;
+
+      mutable QMutex _mutex;
+                  // <<stage, track index>, results, most recent first>
+      std::map<std::pair<Stage, int>, std::deque<Result>> _results;
+      int _hits = 0;
+      int _misses = 0;
+      };
+
+} // namespace MidiCache
+} // namespace Ms
+
+
+#endif // IMPORTMIDI_CACHE_H
@@ -70,6 +70,24 @@ bool isUnaryNegationOverflow(int a)             // -a
       return (a == std::numeric_limits<int>::min());
       }
 
+bool isAdditionOverflow64(qint64 a, qint64 b)   // a + b
+      {
+      return ((b > 0 && a > (std::numeric_limits<qint64>::max() - b))
+                || (b < 0 && a < std::numeric_limits<qint64>::min() - b));
+      }
+
+bool isSubtractionOverflow64(qint64 a, qint64 b)    // a - b
+      {
+      return ((b > 0 && a < std::numeric_limits<qint64>::min() + b)
+                  || (b < 0 && a > std::numeric_limits<qint64>::max() + b));
+      }
+
+bool isMultiplicationOverflow64(qint64 a, qint64 b) // a * b, b > 0
+      {
+      return (a > std::numeric_limits<qint64>::max() / b
+                  || a < std::numeric_limits<qint64>::min() / b);
+      }
+
 #endif
 
 //---------------------------------------------------------------------------------------
@@ -217,6 +235,12 @@ ReducedFraction& ReducedFraction::operator+=(const ReducedFraction& val)
       ReducedFraction value = val;
       value.preventOverflow();
 
+      if (denominator_ == val.denominator_ && denominator_ > 0) {
+            Q_ASSERT_X(!isAdditionOverflow(numerator_, val.numerator_),
+                       "ReducedFraction::operator+=", "Addition overflow");
+            numerator_ += val.numerator_;
+            return *this;
+            }
       const int tmp = lcm(denominator_, val.denominator_);
       numerator_ = fractionPart(tmp, numerator_, denominator_)
                   + fractionPart(tmp, val.numerator_, val.denominator_);
@@ -230,6 +254,12 @@ ReducedFraction& ReducedFraction::operator-=(const ReducedFraction& val)
       ReducedFraction value = val;
       value.preventOverflow();
 
+      if (denominator_ == val.denominator_ && denominator_ > 0) {
+            Q_ASSERT_X(!isSubtractionOverflow(numerator_, val.numerator_),
+                       "ReducedFraction::operator-=", "Subtraction overflow");
+            numerator_ -= val.numerator_;
+            return *this;
+            }
       const int tmp = lcm(denominator_, val.denominator_);
       numerator_ = fractionPart(tmp, numerator_, denominator_)
                   - fractionPart(tmp, val.numerator_, val.denominator_);
@@ -293,6 +323,8 @@ ReducedFraction& ReducedFraction::operator/=(int val)
 
 bool ReducedFraction::operator<(const ReducedFraction& val) const
       {
+      if (denominator_ == val.denominator_ && denominator_ > 0)
+            return numerator_ < val.numerator_;
       const int v = lcm(denominator_, val.denominator_);
       return fractionPart(v, numerator_, denominator_)
                   < fractionPart(v, val.numerator_, val.denominator_);
@@ -300,6 +332,8 @@ bool ReducedFraction::operator<(const ReducedFraction& val) const
 
 bool ReducedFraction::operator<=(const ReducedFraction& val) const
       {
+      if (denominator_ == val.denominator_ && denominator_ > 0)
+            return numerator_ <= val.numerator_;
       const int v = lcm(denominator_, val.denominator_);
       return fractionPart(v, numerator_, denominator_)
                   <= fractionPart(v, val.numerator_, val.denominator_);
@@ -307,6 +341,8 @@ bool ReducedFraction::operator<=(const ReducedFraction& val) const
 
 bool ReducedFraction::operator>(const ReducedFraction& val) const
       {
+      if (denominator_ == val.denominator_ && denominator_ > 0)
+            return numerator_ > val.numerator_;
       const int v = lcm(denominator_, val.denominator_);
       return fractionPart(v, numerator_, denominator_)
                   > fractionPart(v, val.numerator_, val.denominator_);
@@ -314,6 +350,8 @@ bool ReducedFraction::operator>(const ReducedFraction& val) const
 
 bool ReducedFraction::operator>=(const ReducedFraction& val) const
       {
+      if (denominator_ == val.denominator_ && denominator_ > 0)
+            return numerator_ >= val.numerator_;
       const int v = lcm(denominator_, val.denominator_);
       return fractionPart(v, numerator_, denominator_)
                   >= fractionPart(v, val.numerator_, val.denominator_);
@@ -321,6 +359,8 @@ bool ReducedFraction::operator>=(const ReducedFraction& val) const
 
 bool ReducedFraction::operator==(const ReducedFraction& val) const
       {
+      if (denominator_ == val.denominator_ && denominator_ > 0)
+            return numerator_ == val.numerator_;
       const int v = lcm(denominator_, val.denominator_);
       return fractionPart(v, numerator_, denominator_)
                   == fractionPart(v, val.numerator_, val.denominator_);
@@ -328,6 +368,8 @@ bool ReducedFraction::operator==(const ReducedFraction& val) const
 
 bool ReducedFraction::operator!=(const ReducedFraction& val) const
       {
+      if (denominator_ == val.denominator_ && denominator_ > 0)
+            return numerator_ != val.numerator_;
       const int v = lcm(denominator_, val.denominator_);
       return fractionPart(v, numerator_, denominator_)
                   != fractionPart(v, val.numerator_, val.denominator_);
@@ -366,4 +408,76 @@ ReducedFraction toMuseScoreTicks(int tick, int oldDivision, bool isDivisionInTps
       return ReducedFraction::fromTicks(tmp / oldDivision + integral * MScore::division);
       }
 
+//-------------------------------------------------------------------------
+
+FixedTicks::FixedTicks(const ReducedFraction &fraction)
+      {
+      const qint64 whole = wholeNote();
+      const qint64 numerator = fraction.numerator();
+      const qint64 denominator = fraction.denominator();
+
+      Q_ASSERT_X(denominator != 0, "FixedTicks::FixedTicks", "Division by zero");
+      Q_ASSERT_X(isOnGrid(fraction), "FixedTicks::FixedTicks", "Time is not on the grid");
+
+      if (whole % denominator == 0) {
+            ticks_ = numerator * (whole / denominator);
+            return;
+            }
+                  // not on the grid - round to the nearest tick
+      Q_ASSERT_X(!isMultiplicationOverflow64(qAbs(numerator), whole),
+                 "FixedTicks::FixedTicks", "Multiplication overflow");
+
+      const qint64 tmp = numerator * whole;
+      ticks_ = (tmp >= 0 ? tmp + denominator / 2 : tmp - denominator / 2) / denominator;
+      }
+
+qint64 FixedTicks::wholeNote()
+      {
+      return qint64(MScore::division) * 4 * TUPLET_LCM;
+      }
+
+bool FixedTicks::isOnGrid(const ReducedFraction &fraction)
+      {
+      return fraction.denominator() != 0 && wholeNote() % fraction.denominator() == 0;
+      }
+
+ReducedFraction FixedTicks::fraction() const
+      {
+      const qint64 whole = wholeNote();
+                  // reduce by gcd
+      qint64 a = qAbs(ticks_);
+      qint64 b = whole;
+      while (b != 0) {
+            const qint64 r = a % b;
+            a = b;
+            b = r;
+            }
+      const qint64 numerator = ticks_ / a;
+      const qint64 denominator = whole / a;
+
+      Q_ASSERT_X(numerator <= std::numeric_limits<int>::max()
+                 && numerator >= std::numeric_limits<int>::min(),
+                 "FixedTicks::fraction", "Numerator overflow");
+
+      return ReducedFraction(int(numerator), int(denominator));
+      }
+
+FixedTicks& FixedTicks::operator+=(const FixedTicks &val)
+      {
+      Q_ASSERT_X(!isAdditionOverflow64(ticks_, val.ticks_),
+                 "FixedTicks::operator+=", "Addition overflow");
+
+      ticks_ += val.ticks_;
+      return *this;
+      }
+
+FixedTicks& FixedTicks::operator-=(const FixedTicks &val)
+      {
+      Q_ASSERT_X(!isSubtractionOverflow64(ticks_, val.ticks_),
+                 "FixedTicks::operator-=", "Subtraction overflow");
+
+      ticks_ -= val.ticks_;
+      return *this;
+      }
+
 } // namespace Ms
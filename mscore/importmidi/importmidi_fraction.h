@@ -56,6 +56,47 @@ class ReducedFraction
 
 ReducedFraction toMuseScoreTicks(int tick, int oldDivision, bool isDivisionInTps);
 
+// Time on the fixed grid: whole note = MScore::division * 4 * TUPLET_LCM ticks.
+// All times of the MIDI import (MIDI ticks, quantized regular and tuplet times
+// for the supported tuplet numbers 2, 3, 4, 5, 7, 9) lie on that grid,
+// so plain 64-bit integer arithmetic without GCD reduction is exact.
+// Used in the hot loops of the import algorithms.
+
+class FixedTicks
+      {
+   public:
+      static const int TUPLET_LCM = 1260;       // lcm(2, 3, 4, 5, 7, 9)
+
+      FixedTicks() : ticks_(0) {}
+      explicit FixedTicks(const ReducedFraction &);
+
+      static qint64 wholeNote();
+      static bool isOnGrid(const ReducedFraction &);
+
+      qint64 value() const { return ticks_; }
+      ReducedFraction fraction() const;
+      double toDouble() const { return ticks_ * 1.0 / wholeNote(); }
+      FixedTicks absValue() const { return fromValue(qAbs(ticks_)); }
+
+      FixedTicks& operator+=(const FixedTicks&);
+      FixedTicks& operator-=(const FixedTicks&);
+
+      FixedTicks operator+(const FixedTicks& v) const { return FixedTicks(*this) += v; }
+      FixedTicks operator-(const FixedTicks& v) const { return FixedTicks(*this) -= v; }
+
+      bool operator<(const FixedTicks& v) const  { return ticks_ < v.ticks_; }
+      bool operator<=(const FixedTicks& v) const { return ticks_ <= v.ticks_; }
+      bool operator>=(const FixedTicks& v) const { return ticks_ >= v.ticks_; }
+      bool operator>(const FixedTicks& v) const  { return ticks_ > v.ticks_; }
+      bool operator==(const FixedTicks& v) const { return ticks_ == v.ticks_; }
+      bool operator!=(const FixedTicks& v) const { return ticks_ != v.ticks_; }
+
+   private:
+      static FixedTicks fromValue(qint64 ticks) { FixedTicks t; t.ticks_ = ticks; return t; }
+
+      qint64 ticks_;
+      };
+
 } // namespace Ms
 
 
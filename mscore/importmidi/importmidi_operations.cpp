@@ -1,4 +1,5 @@
 #include "importmidi_operations.h"
+#include "importmidi_cache.h"
 
 
 namespace Ms {
@@ -234,6 +235,8 @@ void Data::addNewMidiFile(const QString &fileName)
             return;
       FileData fileData;
       setOperationsFromFile(_midiOperationsFile, fileData.trackOpers);
+      fileData.trackCache = std::make_shared<MidiCache::TrackCache>();
+      fileData.diagnostics = std::make_shared<Diagnostics>();
       _data.insert({fileName, fileData});
       }
 
@@ -268,13 +271,32 @@ bool Data::hasMidiFile(const QString &fileName)
       return _data.find(fileName) != _data.end();
       }
 
+namespace {
+
+QThreadStorage<int> currentTrackStorage;
+
+} // namespace
+
+int Data::currentTrackIndex()
+      {
+      if (!currentTrackStorage.hasLocalData())
+            return -1;
+      return currentTrackStorage.localData();
+      }
+
+void Data::setCurrentTrackIndex(int track)
+      {
+      currentTrackStorage.setLocalData(track);
+      }
+
 int Data::currentTrack() const
       {
+      const int track = currentTrackIndex();
 
-      Q_ASSERT_X(_currentTrack >= 0,
+      Q_ASSERT_X(track >= 0,
                  "Data::currentTrack", "Invalid current track index");
 
-      return _currentTrack;
+      return track;
       }
 
 void Data::setOperationsFile(const QString &fileName)
@@ -4,6 +4,9 @@
 #include "importmidi_operation.h"
 #include "midi/midifile.h"
 
+#include <memory>
+#include <atomic>
+
 
 namespace Ms {
 
@@ -16,6 +19,9 @@ namespace MidiCharset {
 namespace Quantize {
       MidiOperations::QuantValue defaultQuantValueFromPreferences();
 }
+namespace MidiCache {
+      class TrackCache;
+}
 
 namespace MidiOperations {
 
@@ -181,6 +187,37 @@ struct HumanBeatData
       bool measureCount2xLess = false;
       };
 
+// limits of the search of the best tuplet combination, per bar;
+// when a limit is reached the best combination found so far is used.
+// Both limits are off by default, so the search is exact:
+// a cut search can give a different score, and with the time limit
+// the imported score also depends on the machine load
+
+struct TupletSearchLimits
+      {
+      int maxNodes = 0;             // explored tuplet combinations, 0 - no limit
+      int maxTimeMs = 0;            // 0 - no time limit
+      };
+
+// statistics of the last processing of the file;
+// tracks are processed concurrently so counters are atomic
+
+struct Diagnostics
+      {
+      std::atomic<qint64> tupletSearchNodes{0};       // explored tuplet combinations
+      std::atomic<int> tupletSearchLimitReached{0};   // bars where the search was cut
+      std::atomic<int> tupletSearchMemoHits{0};       // bars with reused search result
+      std::atomic<qint64> tupletSearchMaxBarNodes{0}; // most combinations explored in one bar
+
+      void reset()
+            {
+            tupletSearchNodes = 0;
+            tupletSearchLimitReached = 0;
+            tupletSearchMemoHits = 0;
+            tupletSearchMaxBarNodes = 0;
+            }
+      };
+
 struct FileData
       {
       MidiFile midiFile;
@@ -199,6 +236,11 @@ struct FileData
       QList<std::multimap<ReducedFraction, std::string>> lyricTracks;
       std::multimap<ReducedFraction, QString> chordNames;
       HumanBeatData humanBeatData;
+                  // results of per-track import stages for reimport
+                  // after the user changes operations
+      std::shared_ptr<MidiCache::TrackCache> trackCache;
+      TupletSearchLimits tupletSearchLimits;
+      std::shared_ptr<Diagnostics> diagnostics;
       };
 
 class Data
@@ -220,30 +262,32 @@ class Data
       friend class CurrentTrackSetter;
       friend class CurrentMidiFileSetter;
 
+      static int currentTrackIndex();
+      static void setCurrentTrackIndex(int track);
+
       QString _currentMidiFile;
       QString _midiOperationsFile;
-      int _currentTrack = -1;
 
       std::map<QString, FileData> _data;    // <file name, tracks data>
       };
 
 // scoped setter of current track
+// current track is stored per thread, so different tracks
+// can be processed concurrently
 class CurrentTrackSetter
       {
    public:
-      CurrentTrackSetter(Data &opers, int track)
-            : _opers(opers)
+      CurrentTrackSetter(Data &, int track)
             {
-            _oldValue = _opers._currentTrack;
-            _opers._currentTrack = track;
+            _oldValue = Data::currentTrackIndex();
+            Data::setCurrentTrackIndex(track);
             }
 
       ~CurrentTrackSetter()
             {
-            _opers._currentTrack = _oldValue;
+            Data::setCurrentTrackIndex(_oldValue);
             }
    private:
-      Data &_opers;
       int _oldValue;
                   // disallow heap allocation - for stack-only usage
       void* operator new(size_t);               // standard new
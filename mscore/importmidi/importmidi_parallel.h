@@ -0,0 +1,50 @@
+#ifndef IMPORTMIDI_PARALLEL_H
+#define IMPORTMIDI_PARALLEL_H
+
+#include "importmidi_inner.h"
+#include "importmidi_operations.h"
+#include "mscore/preferences.h"
+
+#include <vector>
+
+
+namespace Ms {
+namespace MidiParallel {
+
+// Runs the per-track stage 'func' for all tracks on the global thread pool
+// and returns when all tracks are processed.
+//
+// Stages that are run this way must only modify their own MTrack
+// and may only read the shared data (time sig map, import operations)
+// - so the result does not depend on the processing order.
+// The current track of the MIDI import operations is set
+// in the thread that processes the track.
+
+template<typename Func>
+void forEachTrack(std::multimap<int, MTrack> &tracks, Func func)
+      {
+      std::vector<MTrack *> trackList;
+      for (auto &track: tracks) {
+            if (!track.second.chords.empty())
+                  trackList.push_back(&track.second);
+            }
+
+      auto &opers = preferences.midiImportOperations;
+      auto processTrack = [&opers, &func](MTrack *mtrack) {
+            MidiOperations::CurrentTrackSetter setCurrentTrack{opers, mtrack->indexOfOperation};
+            func(*mtrack);
+            };
+
+      if (trackList.size() < 2 || QThreadPool::globalInstance()->maxThreadCount() < 2) {
+            for (MTrack *mtrack: trackList)
+                  processTrack(mtrack);
+            return;
+            }
+      QtConcurrent::blockingMap(trackList, processTrack);
+      }
+
+} // namespace MidiParallel
+} // namespace Ms
+
+
+#endif // IMPORTMIDI_PARALLEL_H
@@ -6,6 +6,7 @@
 #include "importmidi_quant.h"
 #include "importmidi_voice.h"
 #include "importmidi_operations.h"
+#include "importmidi_parallel.h"
 #include "mscore/preferences.h"
 #include "libmscore/sig.h"
 #include "libmscore/durationtype.h"
@@ -280,17 +281,13 @@ void simplifyDurations(
       {
       auto &opers = preferences.midiImportOperations;
 
-      for (auto &track: tracks) {
-            MTrack &mtrack = track.second;
+                  // tracks are independent here so they are processed concurrently
+      MidiParallel::forEachTrack(tracks, [&opers, sigmap, simplifyDrumTracks](MTrack &mtrack) {
             if (mtrack.mtrack->drumTrack() != simplifyDrumTracks)
-                  continue;
-            auto &chords = track.second.chords;
-            if (chords.empty())
-                  continue;
+                  return;
+            auto &chords = mtrack.chords;
 
             if (opers.data()->trackOpers.simplifyDurations.value(mtrack.indexOfOperation)) {
-                  MidiOperations::CurrentTrackSetter setCurrentTrack{opers, mtrack.indexOfOperation};
-
                   Q_ASSERT_X(MidiTuplet::areTupletRangesOk(chords, mtrack.tuplets),
                              "Simplify::simplifyDurations", "Tuplet chord/note is outside tuplet "
                              "or non-tuplet chord/note is inside tuplet before simplification");
@@ -303,7 +300,7 @@ void simplifyDurations(
                              "Simplify::simplifyDurations", "Tuplet chord/note is outside tuplet "
                              "or non-tuplet chord/note is inside tuplet after simplification");
                   }
-            }
+            });
       }
 
 void simplifyDurationsForDrums(std::multimap<int, MTrack> &tracks, const TimeSigMap *sigmap)
@@ -235,17 +235,6 @@ tupletInterval(const TupletInfo &tuplet,
       return std::make_pair(tuplet.onTime, tupletEnd);
       }
 
-std::vector<std::pair<ReducedFraction, ReducedFraction> >
-findTupletIntervals(const std::vector<TupletInfo> &tuplets,
-                    const ReducedFraction &basicQuant)
-      {
-      std::vector<std::pair<ReducedFraction, ReducedFraction>> tupletIntervals;
-      for (const auto &tuplet: tuplets)
-            tupletIntervals.push_back(tupletInterval(tuplet, basicQuant));
-
-      return tupletIntervals;
-      }
-
 // find tuplets over which duration lies
 
 std::vector<TupletData>
@@ -1023,7 +1012,8 @@ void findTuplets(
             const ReducedFraction &basicQuant,
             std::multimap<ReducedFraction, TupletData> &tupletEvents,
             const TimeSigMap *sigmap,
-            int barIndex)
+            int barIndex,
+            TupletSearchContext &searchContext)
       {
       if (chords.empty() || startBarChordIt == endBarChordIt)
             return;
@@ -1044,7 +1034,7 @@ void findTuplets(
       if (tuplets.empty())
             return;
 
-      filterTuplets(tuplets, basicQuant);
+      filterTuplets(tuplets, basicQuant, &searchContext);
                   // later notes will be sorted and their indexes become invalid
                   // so assign staccato information to notes now
       if (opers.simplifyDurations.value(currentTrack))
@@ -1105,14 +1095,14 @@ void setAllTupletOffTimes(
             }
       }
 
-void findAllTuplets(
+bool findAllTuplets(
             std::multimap<ReducedFraction, TupletData> &tuplets,
             std::multimap<ReducedFraction, MidiChord> &chords,
             const TimeSigMap *sigmap,
             const ReducedFraction &basicQuant)
       {
       if (chords.empty())
-            return;
+            return true;
 
       Q_ASSERT_X(MChord::areNotesLongEnough(chords),
                  "MidiTuplet::findAllTuplets", "There are too short notes");
@@ -1121,6 +1111,11 @@ void findAllTuplets(
       Q_ASSERT_X(MChord::areBarIndexesSuccessive(chords),
                  "MidiTuplet::findAllTuplets", "Bar indexes are not successive");
 
+      auto *data = preferences.midiImportOperations.data();
+      TupletSearchContext searchContext;
+      searchContext.maxNodes = data->tupletSearchLimits.maxNodes;
+      searchContext.maxTimeMs = data->tupletSearchLimits.maxTimeMs;
+
       {
       auto startBarIt = chords.begin();
       for (auto endBarIt = std::next(startBarIt); endBarIt != chords.end(); ++endBarIt) {
@@ -1132,7 +1127,7 @@ void findAllTuplets(
             if (endBarIt->second.barIndex > currentBarIndex) {
                   const size_t oldTupletCount = tuplets.size();
                   findTuplets(startBarIt, endBarIt, chords, basicQuant,
-                              tuplets, sigmap, currentBarIndex);
+                              tuplets, sigmap, currentBarIndex, searchContext);
 
                   Q_ASSERT_X(tuplets.size() >= oldTupletCount, "MidiTuplet::findAllTuplets",
                              "Some old tuplets were deleted that is incorrect");
@@ -1170,8 +1165,17 @@ void findAllTuplets(
             }
                   // handle the last bar containing chords
       findTuplets(startBarIt, chords.end(), chords, basicQuant, tuplets,
-                  sigmap, startBarIt->second.barIndex);
+                  sigmap, startBarIt->second.barIndex, searchContext);
       }
+      data->diagnostics->tupletSearchNodes += searchContext.nodes;
+      data->diagnostics->tupletSearchLimitReached += searchContext.limitReachedBars;
+      data->diagnostics->tupletSearchMemoHits += searchContext.memoHits;
+      qint64 maxBarNodes = data->diagnostics->tupletSearchMaxBarNodes;
+      while (searchContext.maxBarNodes > maxBarNodes
+             && !data->diagnostics->tupletSearchMaxBarNodes.compare_exchange_weak(
+                                          maxBarNodes, searchContext.maxBarNodes)) {
+            }
+
                   // check if there are not detected off times inside tuplets
       setAllTupletOffTimes(tuplets, chords, sigmap);
 
@@ -1181,6 +1185,8 @@ void findAllTuplets(
       Q_ASSERT_X(MChord::areNotesLongEnough(chords),
                  "MidiTuplet::findAllTuplets", "There are too short notes");
       Q_ASSERT(areAllTupletsDifferent(tuplets));
+
+      return searchContext.timeLimitReachedBars == 0;
       }
 
 } // namespace MidiTuplet
@@ -74,10 +74,6 @@ std::pair<ReducedFraction, ReducedFraction>
 tupletInterval(const TupletInfo &tuplet,
                const ReducedFraction &basicQuant);
 
-std::vector<std::pair<ReducedFraction, ReducedFraction> >
-findTupletIntervals(const std::vector<TupletInfo> &tuplets,
-                    const ReducedFraction &basicQuant);
-
 std::vector<TupletData>
 findTupletsInBarForDuration(int voice,
                             const ReducedFraction &barStartTick,
@@ -98,9 +94,11 @@ findTupletContainingTime(int voice,
                          const std::multimap<ReducedFraction, TupletData> &tupletEvents,
                          bool strictComparison);
 
-// Find tuplets and set bar indexes
+// Find tuplets and set bar indexes;
+// return false if the tuplet search was cut by its time limit,
+// then the result depends on the machine load and should not be cached
 
-void findAllTuplets(
+bool findAllTuplets(
             std::multimap<ReducedFraction, TupletData> &tuplets,
             std::multimap<ReducedFraction, MidiChord> &chords,
             const TimeSigMap *sigmap,
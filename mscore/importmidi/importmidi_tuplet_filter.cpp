@@ -7,6 +7,7 @@
 #include "libmscore/mscore.h"
 
 #include <set>
+#include <algorithm>
 
 
 namespace Ms {
@@ -22,7 +23,7 @@ class TupletErrorResult
    public:
       TupletErrorResult(double t = 0.0,
                         double relPlaces = 0.0,
-                        const ReducedFraction &r = ReducedFraction(0, 1),
+                        double r = 0.0,
                         size_t vc = 0,
                         size_t tc = 0)
             : tupletAverageError(t)
@@ -38,8 +39,7 @@ class TupletErrorResult
             {
             double value = div(tupletAverageError, er.tupletAverageError)
                          - div(relativeUsedChordPlaces, er.relativeUsedChordPlaces)
-                         + div(sumLengthOfRests.numerator() * 1.0 / sumLengthOfRests.denominator(),
-                               er.sumLengthOfRests.numerator() * 1.0 / er.sumLengthOfRests.denominator());
+                         + div(sumLengthOfRests, er.sumLengthOfRests);
             if (value == 0) {
                    value = div(voiceCount, er.voiceCount)
                          + div(tupletCount, er.tupletCount);
@@ -57,7 +57,7 @@ class TupletErrorResult
 
       double tupletAverageError;
       double relativeUsedChordPlaces;
-      ReducedFraction sumLengthOfRests;
+      double sumLengthOfRests;            // in whole notes
       size_t voiceCount;
       size_t tupletCount;
       };
@@ -169,35 +169,129 @@ std::set<int> findLongestUncommonGroup(
       }
 
 
+// Tuplet data for the search of the best tuplet combination.
+// Times are in fixed-grid ticks and chords are replaced by indexes
+// in the flat array of all tuplet chords sorted by onTime -
+// the search evaluates a lot of tuplet combinations,
+// so it does no fraction arithmetic and no tree lookups
+
+struct TupletSearchData
+      {
+      std::vector<std::pair<FixedTicks, FixedTicks>> intervals;
+      std::vector<FixedTicks> sumErrors;
+      std::vector<FixedTicks> sumLengthOfRests;
+      std::vector<int> tupletNumbers;
+      std::vector<int> firstChordIndexes;
+                  // chord indexes of tuplets, in onTime order
+      std::vector<std::vector<int>> chords;
+                  // on time quant error and note count of chords, by chord index
+      std::vector<FixedTicks> chordQuantErrors;
+      std::vector<int> chordNoteCounts;
+      };
+
+TupletSearchData prepareSearchData(
+            const std::vector<TupletInfo> &tuplets,
+            const ReducedFraction &basicQuant)
+      {
+      struct {
+            bool operator()(const std::pair<const ReducedFraction, MidiChord> *c1,
+                            const std::pair<const ReducedFraction, MidiChord> *c2) const
+                  {
+                  if (c1->first != c2->first)
+                        return c1->first < c2->first;
+                  return c1 < c2;
+                  }
+            } comparator;
+
+      std::vector<std::pair<const ReducedFraction, MidiChord> *> sortedChords;
+      for (const auto &tuplet: tuplets) {
+            for (const auto &chord: tuplet.chords)
+                  sortedChords.push_back(&*chord.second);
+            }
+      std::sort(sortedChords.begin(), sortedChords.end(), comparator);
+      sortedChords.erase(std::unique(sortedChords.begin(), sortedChords.end()),
+                         sortedChords.end());
+
+      TupletSearchData data;
+      for (const auto *chord: sortedChords) {
+            data.chordQuantErrors.push_back(
+                        FixedTicks(Quantize::findOnTimeQuantError(*chord, basicQuant)));
+            data.chordNoteCounts.push_back(chord->second.notes.size());
+            }
+      for (const auto &tuplet: tuplets) {
+            const auto interval = tupletInterval(tuplet, basicQuant);
+            data.intervals.push_back({FixedTicks(interval.first), FixedTicks(interval.second)});
+            data.sumErrors.push_back(FixedTicks(tuplet.tupletSumError));
+            data.sumLengthOfRests.push_back(FixedTicks(tuplet.sumLengthOfRests));
+            data.tupletNumbers.push_back(tuplet.tupletNumber);
+            data.firstChordIndexes.push_back(tuplet.firstChordIndex);
+
+            std::vector<int> chordIndexes;
+            for (const auto &chord: tuplet.chords) {
+                  const auto it = std::lower_bound(sortedChords.begin(), sortedChords.end(),
+                                                   &*chord.second, comparator);
+
+                  Q_ASSERT_X(it != sortedChords.end() && *it == &*chord.second,
+                             "MidiTuplet::prepareSearchData", "Tuplet chord was not found");
+
+                  chordIndexes.push_back(it - sortedChords.begin());
+                  }
+            data.chords.push_back(chordIndexes);
+            }
+      return data;
+      }
+
+bool haveIntersection(const std::pair<FixedTicks, FixedTicks> &interval,
+                      const std::vector<std::pair<FixedTicks, FixedTicks>> &intervals)
+      {
+      for (const auto &i: intervals) {
+            if (i.second > interval.first && i.first < interval.second)
+                  return true;
+            }
+      return false;
+      }
+
 struct TupletCommon
       {
             // indexes of tuplets that have common chords with the tuplet with tupletIndex
       std::set<int> commonIndexes;
       };
 
-bool areInCommons(const TupletInfo &t1, const TupletInfo &t2)
+bool areInCommons(int i, int j, const TupletSearchData &data)
       {
-      for (auto it1 = t1.chords.begin(); it1 != t1.chords.end(); ++it1) {
-            for (auto it2 = t2.chords.begin(); it2 != t2.chords.end(); ++it2) {
-                  if (&*it1->second != &*it2->second)
-                        continue;
-                  if (t1.firstChordIndex != 0 || t2.firstChordIndex != 0
-                              || it1 != t1.chords.begin() || it2 != t2.chords.begin()
-                              || !isMoreTupletVoicesAllowed(1, it1->second->second.notes.size())) {
-                        return true;
-                        }
+                  // chord indexes of both tuplets are sorted, so merge them
+      const auto &chords1 = data.chords[i];
+      const auto &chords2 = data.chords[j];
+      size_t k1 = 0;
+      size_t k2 = 0;
+      while (k1 != chords1.size() && k2 != chords2.size()) {
+            if (chords1[k1] < chords2[k2]) {
+                  ++k1;
+                  continue;
+                  }
+            if (chords2[k2] < chords1[k1]) {
+                  ++k2;
+                  continue;
                   }
+            if (data.firstChordIndexes[i] != 0 || data.firstChordIndexes[j] != 0
+                        || k1 != 0 || k2 != 0
+                        || !isMoreTupletVoicesAllowed(1, data.chordNoteCounts[chords1[k1]])) {
+                  return true;
+                  }
+            ++k1;
+            ++k2;
             }
       return false;
       }
 
-std::vector<TupletCommon> findTupletCommons(const std::vector<TupletInfo> &tuplets)
+std::vector<TupletCommon> findTupletCommons(const TupletSearchData &data)
       {
-      std::vector<TupletCommon> tupletCommons(tuplets.size());
+      const size_t tupletCount = data.chords.size();
+      std::vector<TupletCommon> tupletCommons(tupletCount);
 
-      for (size_t i = 0; i != tuplets.size() - 1; ++i) {
-            for (size_t j = i + 1; j != tuplets.size(); ++j) {
-                  if (areInCommons(tuplets[i], tuplets[j]))
+      for (size_t i = 0; i != tupletCount - 1; ++i) {
+            for (size_t j = i + 1; j != tupletCount; ++j) {
+                  if (areInCommons(i, j, data))
                         tupletCommons[i].commonIndexes.insert(j);
                   }
             }
@@ -231,45 +325,41 @@ bool isInCommonIndexes(
 
 TupletErrorResult findTupletError(
             const std::vector<int> &tupletIndexes,
-            const std::vector<TupletInfo> &tuplets,
-            size_t voiceCount,
-            const ReducedFraction &basicQuant)
+            const TupletSearchData &data,
+            size_t voiceCount)
       {
-      ReducedFraction sumError{0, 1};
-      ReducedFraction sumLengthOfRests{0, 1};
+      FixedTicks sumError;
+      FixedTicks sumLengthOfRests;
       int sumChordCount = 0;
       int sumChordPlaces = 0;
-      std::set<std::pair<const ReducedFraction, MidiChord> *> usedChords;
-      std::vector<char> usedIndexes(tuplets.size(), 0);
+      std::vector<char> usedChords(data.chordNoteCounts.size(), 0);
+      std::vector<char> usedIndexes(data.chords.size(), 0);
 
       for (int i: tupletIndexes) {
-            const auto &tuplet = tuplets[i];
-
-            sumError += tuplet.tupletSumError;
-            sumLengthOfRests += tuplet.sumLengthOfRests;
-            sumChordCount += tuplet.chords.size();
-            sumChordPlaces += tuplet.tupletNumber;
+            sumError += data.sumErrors[i];
+            sumLengthOfRests += data.sumLengthOfRests[i];
+            sumChordCount += data.chords[i].size();
+            sumChordPlaces += data.tupletNumbers[i];
 
             usedIndexes[i] = 1;
-            for (const auto &chord: tuplet.chords)
-                  usedChords.insert(&*chord.second);
+            for (int chord: data.chords[i])
+                  usedChords[chord] = 1;
             }
                   // add quant error of all chords excluded from tuplets
-      for (size_t i = 0; i != tuplets.size(); ++i) {
+      for (size_t i = 0; i != data.chords.size(); ++i) {
             if (usedIndexes[i])
                   continue;
-            const auto &tuplet = tuplets[i];
-            for (const auto &chord: tuplet.chords) {
-                  if (usedChords.find(&*chord.second) != usedChords.end())
+            for (int chord: data.chords[i]) {
+                  if (usedChords[chord])
                         continue;
-                  sumError += Quantize::findOnTimeQuantError(*chord.second, basicQuant);
+                  sumError += data.chordQuantErrors[chord];
                   }
             }
 
       return TupletErrorResult{
-                  sumError.numerator() * 1.0 / (sumError.denominator() * sumChordCount),
+                  sumError.value() * 1.0 / (FixedTicks::wholeNote() * sumChordCount),
                   sumChordCount * 1.0 / sumChordPlaces,
-                  sumLengthOfRests,
+                  sumLengthOfRests.toDouble(),
                   voiceCount,
                   tupletIndexes.size()
             };
@@ -309,39 +399,28 @@ bool areCommonsUncommon(const std::vector<int> &selectedCommons,
 
 int findAvailableVoice(
             size_t tupletIndex,
-            const std::vector<std::pair<ReducedFraction, ReducedFraction>> &tupletIntervals,
-            const std::map<int, std::vector<std::pair<ReducedFraction, ReducedFraction>>> &voiceIntervals)
+            const std::vector<std::pair<FixedTicks, FixedTicks>> &tupletIntervals,
+            const std::vector<std::vector<std::pair<FixedTicks, FixedTicks>>> &voiceIntervals)
       {
       int voice = 0;
-      while (true) {
-            const auto it = voiceIntervals.find(voice);
-            if (it != voiceIntervals.end()
-                        && haveIntersection(tupletIntervals[tupletIndex], it->second)) {
-                  ++voice;
-                  continue;
-                  }
-            break;
+      while (voice < (int)voiceIntervals.size()
+                  && haveIntersection(tupletIntervals[tupletIndex], voiceIntervals[voice])) {
+            ++voice;
             }
-
       return voice;
       }
 
-std::map<std::pair<const ReducedFraction, MidiChord> *, int>
-prepareUsedFirstChords(const std::vector<int> &selectedTuplets,
-                       const std::vector<TupletInfo> &tuplets)
+// <chord index, count of selected tuplets that start from that chord>
+
+std::vector<int> prepareUsedFirstChords(const std::vector<int> &selectedTuplets,
+                                        const TupletSearchData &data)
       {
-      std::map<std::pair<const ReducedFraction, MidiChord> *, int> usedFirstChords;
+      std::vector<int> usedFirstChords(data.chordNoteCounts.size(), 0);
       for (int i: selectedTuplets) {
-            if (tuplets[i].firstChordIndex != 0)
+            if (data.firstChordIndexes[i] != 0)
                   continue;
-            const auto firstChord = tuplets[i].chords.begin();
-            const auto it = usedFirstChords.find(&*firstChord->second);
-            if (it != usedFirstChords.end())
-                  ++(it->second);
-            else
-                  usedFirstChords.insert({&*firstChord->second, 1});
+            ++usedFirstChords[data.chords[i].front()];
             }
-
       return usedFirstChords;
       }
 
@@ -361,26 +440,24 @@ std::vector<int> findUnusedIndexes(const std::vector<int> &selectedTuplets)
 
 bool canUseIndex(
             int indexToCheck,
-            const std::vector<TupletInfo> &tuplets,
-            const std::vector<std::pair<ReducedFraction, ReducedFraction> > &tupletIntervals,
-            const std::map<int, std::vector<std::pair<ReducedFraction, ReducedFraction>>> &voiceIntervals,
-            const std::map<std::pair<const ReducedFraction, MidiChord> *, int> &usedFirstChords)
+            const TupletSearchData &data,
+            const std::vector<std::vector<std::pair<FixedTicks, FixedTicks>>> &voiceIntervals,
+            const std::vector<int> &usedFirstChords)
       {
-      const auto &tuplet = tuplets[indexToCheck];
                   // check tuplets for common 1st chord
-      if (tuplet.firstChordIndex == 0) {
-            const auto firstChord = tuplet.chords.begin();
-            const auto it = usedFirstChords.find(&*firstChord->second);
-            if (it != usedFirstChords.end() && !isMoreTupletVoicesAllowed(
-                              it->second, it->first->second.notes.size())) {
+      if (data.firstChordIndexes[indexToCheck] == 0) {
+            const int firstChord = data.chords[indexToCheck].front();
+            const int usedVoices = usedFirstChords[firstChord];
+            if (usedVoices != 0 && !isMoreTupletVoicesAllowed(
+                              usedVoices, data.chordNoteCounts[firstChord])) {
                   return false;
                   }
             }
                   // check tuplets for resulting voice count
-      const int voice = findAvailableVoice(indexToCheck, tupletIntervals, voiceIntervals);
+      const int voice = findAvailableVoice(indexToCheck, data.intervals, voiceIntervals);
       const int voiceCount = qMax((int)voiceIntervals.size(), voice + 1);     // index + 1 = count
-      if (voiceCount > 1 && (int)tuplet.chords.size()
-                  < tupletLimits(tuplet.tupletNumber).minNoteCountAddVoice) {
+      if (voiceCount > 1 && (int)data.chords[indexToCheck].size()
+                  < tupletLimits(data.tupletNumbers[indexToCheck]).minNoteCountAddVoice) {
             return false;
             }
       return true;
@@ -433,33 +510,86 @@ void tryUpdateBestIndexes(
             std::vector<int> &bestTupletIndexes,
             TupletErrorResult &minCurrentError,
             const std::vector<int> &selectedTuplets,
-            const std::vector<TupletInfo> &tuplets,
-            const std::map<int, std::vector<std::pair<ReducedFraction, ReducedFraction>>> &voiceIntervals,
-            const ReducedFraction &basicQuant)
+            const TupletSearchData &data,
+            const std::vector<std::vector<std::pair<FixedTicks, FixedTicks>>> &voiceIntervals)
       {
       const size_t voiceCount = voiceIntervals.size();
-      const auto error = findTupletError(selectedTuplets, tuplets,
-                                         voiceCount, basicQuant);
+      const auto error = findTupletError(selectedTuplets, data, voiceCount);
       if (!minCurrentError.isInitialized() || error < minCurrentError) {
             minCurrentError = error;
             bestTupletIndexes = selectedTuplets;
             }
       }
 
-std::map<int, std::vector<std::pair<ReducedFraction, ReducedFraction> > >
+// voice intervals, voice index = vector index
+
+std::vector<std::vector<std::pair<FixedTicks, FixedTicks>>>
 prepareVoiceIntervals(
             const std::vector<int> &selectedTuplets,
-            const std::vector<std::pair<ReducedFraction, ReducedFraction> > &tupletIntervals)
+            const std::vector<std::pair<FixedTicks, FixedTicks>> &tupletIntervals)
       {
-                  // <voice, intervals>
-      std::map<int, std::vector<std::pair<ReducedFraction, ReducedFraction>>> voiceIntervals;
+      std::vector<std::vector<std::pair<FixedTicks, FixedTicks>>> voiceIntervals;
       for (int i: selectedTuplets) {
-            int voice = findAvailableVoice(i, tupletIntervals, voiceIntervals);
+            const int voice = findAvailableVoice(i, tupletIntervals, voiceIntervals);
+            if (voice == (int)voiceIntervals.size())
+                  voiceIntervals.emplace_back();
             voiceIntervals[voice].push_back(tupletIntervals[i]);
             }
       return voiceIntervals;
       }
 
+// node and time budget of the search in one bar;
+// maxTimeMs == 0 - no time limit
+
+class SearchBudget
+      {
+   public:
+      SearchBudget(int maxNodes, int maxTimeMs)
+            : maxNodes_(maxNodes)
+            , maxTimeMs_(maxTimeMs)
+            , nodes_(0)
+            , isExceeded_(false)
+            , isTimeExceeded_(false)
+            {
+            timer_.start();
+            }
+
+      bool isExceeded() const
+            {
+            return isExceeded_;
+            }
+
+      bool isTimeExceeded() const
+            {
+            return isTimeExceeded_;
+            }
+
+      qint64 nodes() const
+            {
+            return nodes_;
+            }
+
+      void addNode()
+            {
+            ++nodes_;
+            if (maxNodes_ > 0 && nodes_ > maxNodes_)
+                  isExceeded_ = true;
+                        // don't query the clock for every node
+            else if (maxTimeMs_ > 0 && (nodes_ & 0xff) == 0 && timer_.elapsed() > maxTimeMs_) {
+                  isExceeded_ = true;
+                  isTimeExceeded_ = true;
+                  }
+            }
+
+   private:
+      qint64 maxNodes_;
+      qint64 maxTimeMs_;
+      qint64 nodes_;
+      bool isExceeded_;
+      bool isTimeExceeded_;
+      QElapsedTimer timer_;
+      };
+
 class ValidTuplets
       {
    public:
@@ -536,11 +666,15 @@ void findNextTuplet(
             TupletErrorResult &minCurrentError,
             const std::vector<TupletCommon> &tupletCommons,
             const std::vector<TupletInfo> &tuplets,
-            const std::vector<std::pair<ReducedFraction, ReducedFraction> > &tupletIntervals,
+            const TupletSearchData &data,
             size_t commonsSize,
-            const ReducedFraction &basicQuant)
+            SearchBudget &budget)
       {
       while (!validTuplets.empty()) {
+            if (budget.isExceeded())
+                  return;
+            budget.addNode();
+
             size_t index = validTuplets.first();
 
             bool isCommonGroupBegins = (selectedTuplets.empty() && index == commonsSize);
@@ -555,8 +689,8 @@ void findNextTuplet(
             Q_ASSERT_X(validateSelectedTuplets(selectedTuplets.begin(), selectedTuplets.end(), tuplets),
                        "MIDI tuplets::findNextTuplet", "Tuplets have common chords but they shouldn't");
 
-            const auto voiceIntervals = prepareVoiceIntervals(selectedTuplets, tupletIntervals);
-            const auto usedFirstChords = prepareUsedFirstChords(selectedTuplets, tuplets);
+            const auto voiceIntervals = prepareVoiceIntervals(selectedTuplets, data.intervals);
+            const auto usedFirstChords = prepareUsedFirstChords(selectedTuplets, data);
 
             Q_ASSERT_X(areCommonsDifferent(selectedTuplets), "MidiTuplet::findNextTuplet",
                        "There are duplicates in selected commons");
@@ -567,15 +701,14 @@ void findNextTuplet(
                   bool canAddMoreIndexes = false;
                   for (size_t i = 0; i != commonsSize; ++i) {
                         if (!isInCommonIndexes(i, selectedTuplets, tupletCommons)
-                                    && canUseIndex(i, tuplets, tupletIntervals,
-                                                   voiceIntervals, usedFirstChords)) {
+                                    && canUseIndex(i, data, voiceIntervals, usedFirstChords)) {
                               canAddMoreIndexes = true;
                               break;
                               }
                         }
                   if (!canAddMoreIndexes) {
                         tryUpdateBestIndexes(bestTupletIndexes, minCurrentError,
-                                             selectedTuplets, tuplets, voiceIntervals, basicQuant);
+                                             selectedTuplets, data, voiceIntervals);
                         }
                   return;
                   }
@@ -591,8 +724,7 @@ void findNextTuplet(
                         }
                   }
             for (int i = validTuplets.first(); validTuplets.isValid(i); ) {
-                  if (!canUseIndex(i, tuplets, tupletIntervals,
-                                   voiceIntervals, usedFirstChords)) {
+                  if (!canUseIndex(i, data, voiceIntervals, usedFirstChords)) {
                         i = validTuplets.exclude(i);
                         continue;
                         }
@@ -603,20 +735,19 @@ void findNextTuplet(
                   bool canAddMoreIndexes = false;
                   for (int i: unusedIndexes) {
                         if (!isInCommonIndexes(i, selectedTuplets, tupletCommons)
-                                    && canUseIndex(i, tuplets, tupletIntervals,
-                                                   voiceIntervals, usedFirstChords)) {
+                                    && canUseIndex(i, data, voiceIntervals, usedFirstChords)) {
                               canAddMoreIndexes = true;
                               break;
                               }
                         }
                   if (!canAddMoreIndexes) {
                         tryUpdateBestIndexes(bestTupletIndexes, minCurrentError,
-                                             selectedTuplets, tuplets, voiceIntervals, basicQuant);
+                                             selectedTuplets, data, voiceIntervals);
                         }
                   }
             else {
                   findNextTuplet(selectedTuplets, validTuplets, bestTupletIndexes, minCurrentError,
-                                 tupletCommons, tuplets, tupletIntervals, commonsSize, basicQuant);
+                                 tupletCommons, tuplets, data, commonsSize, budget);
                   }
 
             selectedTuplets.pop_back();
@@ -641,25 +772,92 @@ void moveUncommonTupletsToEnd(std::vector<TupletInfo> &tuplets, std::set<int> &u
                  "Untested uncommon tuplets remaining");
       }
 
+// take tuplets in index order if they are compatible with already taken ones;
+// used when the search budget is exceeded
+
+std::vector<int> findGreedyTuplets(
+            const std::vector<TupletCommon> &tupletCommons,
+            const TupletSearchData &data)
+      {
+      std::vector<int> selectedTuplets;
+      for (int i = 0; i != (int)data.chords.size(); ++i) {
+            if (isInCommonIndexes(i, selectedTuplets, tupletCommons))
+                  continue;
+            const auto voiceIntervals = prepareVoiceIntervals(selectedTuplets, data.intervals);
+            const auto usedFirstChords = prepareUsedFirstChords(selectedTuplets, data);
+            if (canUseIndex(i, data, voiceIntervals, usedFirstChords))
+                  selectedTuplets.push_back(i);
+            }
+      return selectedTuplets;
+      }
+
 std::vector<int> findBestTuplets(
             const std::vector<TupletCommon> &tupletCommons,
             const std::vector<TupletInfo> &tuplets,
+            const TupletSearchData &data,
             size_t commonsSize,
-            const ReducedFraction &basicQuant)
+            TupletSearchContext &context)
       {
       std::vector<int> bestTupletIndexes;
       std::vector<int> selectedTuplets;
       TupletErrorResult minCurrentError;
-      const auto tupletIntervals = findTupletIntervals(tuplets, basicQuant);
-
       ValidTuplets validTuplets(tuplets.size());
+      SearchBudget budget(context.maxNodes, context.maxTimeMs);
 
       findNextTuplet(selectedTuplets, validTuplets, bestTupletIndexes, minCurrentError,
-                     tupletCommons, tuplets, tupletIntervals, commonsSize, basicQuant);
+                     tupletCommons, tuplets, data, commonsSize, budget);
+
+      context.nodes += budget.nodes();
+      context.maxBarNodes = std::max(context.maxBarNodes, budget.nodes());
+      if (budget.isExceeded()) {
+            ++context.limitReachedBars;
+            if (budget.isTimeExceeded())
+                  ++context.timeLimitReachedBars;
+                        // search was cut - the greedy result can be better
+                        // than the best result found so far
+            const auto greedyTuplets = findGreedyTuplets(tupletCommons, data);
+            if (!greedyTuplets.empty()) {
+                  tryUpdateBestIndexes(bestTupletIndexes, minCurrentError, greedyTuplets, data,
+                                       prepareVoiceIntervals(greedyTuplets, data.intervals));
+                  }
+            }
 
       return bestTupletIndexes;
       }
 
+// search result depends only on the relative positions of tuplets and chords,
+// so the key is shifted to the start of the first tuplet
+
+std::vector<qint64> searchDataKey(const TupletSearchData &data, size_t commonsSize)
+      {
+      FixedTicks start;
+      for (size_t i = 0; i != data.intervals.size(); ++i) {
+            if (i == 0 || data.intervals[i].first < start)
+                  start = data.intervals[i].first;
+            }
+
+      std::vector<qint64> key;
+      key.push_back(commonsSize);
+      key.push_back(data.chords.size());
+      key.push_back(data.chordNoteCounts.size());
+      for (size_t i = 0; i != data.chords.size(); ++i) {
+            key.push_back((data.intervals[i].first - start).value());
+            key.push_back((data.intervals[i].second - start).value());
+            key.push_back(data.sumErrors[i].value());
+            key.push_back(data.sumLengthOfRests[i].value());
+            key.push_back(data.tupletNumbers[i]);
+            key.push_back(data.firstChordIndexes[i]);
+            key.push_back(data.chords[i].size());
+            for (int chord: data.chords[i])
+                  key.push_back(chord);
+            }
+      for (size_t i = 0; i != data.chordNoteCounts.size(); ++i) {
+            key.push_back(data.chordQuantErrors[i].value());
+            key.push_back(data.chordNoteCounts[i]);
+            }
+      return key;
+      }
+
 void removeExtraTuplets(std::vector<TupletInfo> &tuplets)
       {
       const size_t MAX_TUPLETS = 17;         // found empirically
@@ -673,7 +871,7 @@ void removeExtraTuplets(std::vector<TupletInfo> &tuplets)
                         tuplets[i].tupletSumError.numerator() * 1.0
                               / (tuplets[i].tupletSumError.denominator() * tuplets[i].chords.size()),
                         tuplets[i].chords.size() * 1.0 / tuplets[i].tupletNumber,
-                        tuplets[i].sumLengthOfRests,
+                        tuplets[i].sumLengthOfRests.toDouble(),
                         1,
                         1
                   };
@@ -696,7 +894,8 @@ void removeExtraTuplets(std::vector<TupletInfo> &tuplets)
 // to be splitted into different voices
 
 void filterTuplets(std::vector<TupletInfo> &tuplets,
-                   const ReducedFraction &basicQuant)
+                   const ReducedFraction &basicQuant,
+                   TupletSearchContext *context)
       {
       if (tuplets.empty())
             return;
@@ -718,10 +917,28 @@ void filterTuplets(std::vector<TupletInfo> &tuplets,
             commonsSize -= uncommons.size();
             moveUncommonTupletsToEnd(tuplets, uncommons);
             }
-      const auto tupletCommons = findTupletCommons(tuplets);
+      TupletSearchContext defaultContext;
+      if (!context)
+            context = &defaultContext;
 
-      const std::vector<int> bestIndexes = findBestTuplets(tupletCommons, tuplets,
-                                                           commonsSize, basicQuant);
+      const auto searchData = prepareSearchData(tuplets, basicQuant);
+      auto key = searchDataKey(searchData, commonsSize);
+      std::vector<int> bestIndexes;
+
+      const auto it = context->results.find(key);
+      if (it != context->results.end()) {
+            bestIndexes = it->second;
+            ++context->memoHits;
+            }
+      else {
+            const auto tupletCommons = findTupletCommons(searchData);
+            const int timeLimitReachedBars = context->timeLimitReachedBars;
+            bestIndexes = findBestTuplets(tupletCommons, tuplets, searchData,
+                                          commonsSize, *context);
+                        // a result cut by time is not reproducible, don't reuse it
+            if (context->timeLimitReachedBars == timeLimitReachedBars)
+                  context->results.insert({std::move(key), bestIndexes});
+            }
 
       Q_ASSERT_X(validateSelectedTuplets(bestIndexes.begin(), bestIndexes.end(), tuplets),
                  "MIDI tuplets: filterTuplets", "Tuplets have common chords but they shouldn't");
@@ -1,6 +1,9 @@
 #ifndef IMPORTMIDI_TUPLET_FILTER_H
 #define IMPORTMIDI_TUPLET_FILTER_H
 
+#include <map>
+#include <vector>
+
 
 namespace Ms {
 
@@ -10,8 +13,28 @@ namespace MidiTuplet {
 
 struct TupletInfo;
 
+// State of the best tuplet combination search for one track:
+// search limits, results for already processed bars
+// (bars with the same rhythm have the same tuplet candidates)
+// and statistics. Results cut by the time limit are not kept
+
+struct TupletSearchContext
+      {
+      int maxNodes = 0;             // 0 - no limit
+      int maxTimeMs = 0;            // 0 - no time limit
+
+      qint64 nodes = 0;
+      qint64 maxBarNodes = 0;
+      int limitReachedBars = 0;
+      int timeLimitReachedBars = 0;
+      int memoHits = 0;
+                  // <bar search data, best tuplet indexes>
+      std::map<std::vector<qint64>, std::vector<int>> results;
+      };
+
 void filterTuplets(std::vector<TupletInfo> &tuplets,
-                   const ReducedFraction &basicQuant);
+                   const ReducedFraction &basicQuant,
+                   TupletSearchContext *context = nullptr);
 
 } // namespace MidiTuplet
 } // namespace Ms
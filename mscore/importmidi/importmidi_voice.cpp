@@ -5,11 +5,15 @@
 #include "importmidi_chord.h"
 #include "importmidi_meter.h"
 #include "importmidi_operations.h"
+#include "importmidi_parallel.h"
+#include "importmidi_cache.h"
 #include "libmscore/sig.h"
 #include "libmscore/mscore.h"
 #include "mscore/preferences.h"
 #include "libmscore/durationtype.h"
 
+#include <atomic>
+
 
 namespace Ms {
 namespace MidiVoice {
@@ -998,22 +1002,27 @@ void sortVoices(
 bool separateVoices(std::multimap<int, MTrack> &tracks, const TimeSigMap *sigmap)
       {
       auto &opers = preferences.midiImportOperations;
-      bool changed = false;
+      std::atomic<bool> changed(false);
+
+                  // voices of different tracks are separated concurrently,
+                  // current track index is passed through MidiImportOperations
+      MidiCache::TrackCache *cache = opers.data()->trackCache.get();
 
-      for (auto &track: tracks) {
-            MTrack &mtrack = track.second;
+      MidiParallel::forEachTrack(tracks, [&opers, &changed, cache, sigmap](MTrack &mtrack) {
             if (mtrack.mtrack->drumTrack())
-                  continue;
-            auto &chords = track.second.chords;
-            if (chords.empty())
-                  continue;
+                  return;
             const int userVoiceCount = toIntVoiceCount(
                         opers.data()->trackOpers.maxVoiceCount.value(mtrack.indexOfOperation));
-                        // pass current track index through MidiImportOperations
-                        // for further usage
-            MidiOperations::CurrentTrackSetter setCurrentTrack{opers, mtrack.indexOfOperation};
 
             if (userVoiceCount > 1 && userVoiceCount <= voiceLimit()) {
+                  const MidiCache::Key key = cache->key(MidiCache::Stage::VOICE_SEPARATION,
+                                                        mtrack, sigmap, ReducedFraction(0, 1));
+                  bool trackChanged = false;
+                  if (cache->restore(MidiCache::Stage::VOICE_SEPARATION, key, mtrack, &trackChanged)) {
+                        if (trackChanged)
+                              changed = true;
+                        return;
+                        }
 
                   Q_ASSERT_X(MidiTuplet::areAllTupletsReferenced(mtrack.chords, mtrack.tuplets),
                              "MidiVoice::separateVoices",
@@ -1023,8 +1032,10 @@ bool separateVoices(std::multimap<int, MTrack> &tracks, const TimeSigMap *sigmap
                              "MidiVoice::separateVoices", "Different voices of chord and tuplet "
                              "before voice separation");
 
-                  if (doVoiceSeparation(mtrack.chords, sigmap, mtrack.tuplets))
+                  if (doVoiceSeparation(mtrack.chords, sigmap, mtrack.tuplets)) {
+                        trackChanged = true;
                         changed = true;
+                        }
 
                   Q_ASSERT_X(MidiTuplet::areAllTupletsReferenced(mtrack.chords, mtrack.tuplets),
                              "MidiVoice::separateVoices",
@@ -1043,8 +1054,10 @@ bool separateVoices(std::multimap<int, MTrack> &tracks, const TimeSigMap *sigmap
                   Q_ASSERT_X(areVoicesSame(mtrack.chords),
                              "MidiVoice::separateVoices", "Different voices of chord and tuplet "
                              "after voice sort");
+
+                  cache->store(MidiCache::Stage::VOICE_SEPARATION, key, mtrack, trackChanged);
                   }
-            }
+            });
 
       return changed;
       }
@@ -368,7 +368,9 @@ void InspectorBase::valueChanged(int idx, bool reset)
 
       Score* score  = inspector->element()->score();
 
-      score->startCmd();
+      // one undo command for all elements of the selection
+      std::vector<PropertyChange> changes;
+      changes.reserve(inspector->el().size());
       for (Element* e : inspector->el()) {
             for (int i = 0; i < ii.parent; ++i)
                   e = e->parent();
@@ -388,11 +390,11 @@ void InspectorBase::valueChanged(int idx, bool reset)
                   QSizeF sz = val1.toSizeF();
                   if (ii.sv == 0) {
                         if (sz.width() != v)
-                              e->undoChangeProperty(id, QVariant(QSizeF(v, sz.height())), ps);
+                              changes.push_back({ e, QVariant(QSizeF(v, sz.height())), ps });
                         }
                   else {
                         if (sz.height() != v)
-                              e->undoChangeProperty(id, QVariant(QSizeF(sz.width(), v)), ps);
+                              changes.push_back({ e, QVariant(QSizeF(sz.width(), v)), ps });
                         }
                   }
             else if (pt == P_TYPE::POINT || pt == P_TYPE::POINT_MM) {
@@ -400,11 +402,11 @@ void InspectorBase::valueChanged(int idx, bool reset)
                   QPointF sz = val1.toPointF();
                   if (ii.sv == 0) {
                         if (sz.x() != v)
-                              e->undoChangeProperty(id, QVariant(QPointF(v, sz.y())), ps);
+                              changes.push_back({ e, QVariant(QPointF(v, sz.y())), ps });
                         }
                   else {
                         if (sz.y() != v)
-                              e->undoChangeProperty(id, QVariant(QPointF(sz.x(), v)), ps);
+                              changes.push_back({ e, QVariant(QPointF(sz.x(), v)), ps });
                         }
                   }
             else if (pt == P_TYPE::FRACTION) {
@@ -414,22 +416,24 @@ void InspectorBase::valueChanged(int idx, bool reset)
                         if (f.numerator() != v) {
                               QVariant va;
                               va.setValue(Fraction(v, f.denominator()));
-                              e->undoChangeProperty(id, va, ps);
+                              changes.push_back({ e, va, ps });
                               }
                         }
                   else {
                         if (f.denominator() != v) {
                               QVariant va;
                               va.setValue(Fraction(f.numerator(), v));
-                              e->undoChangeProperty(id, va, ps);
+                              changes.push_back({ e, va, ps });
                               }
                         }
                   }
             else {
                   if (val1 != val2 || (reset && ps != PropertyStyle::NOSTYLE))
-                        e->undoChangeProperty(id, val2, ps);
+                        changes.push_back({ e, val2, ps });
                   }
             }
+      score->startCmd();
+      score->undoChangeProperties(id, changes);
       inspector->setInspectorEdit(true);
       checkDifferentValues(ii);
       score->endCmd();
@@ -107,6 +107,7 @@
 #include "startcenter.h"
 #include "help.h"
 #include "awl/aslider.h"
+#include "libmscore/trace.h"
 
 #ifdef AEOLUS
 extern Ms::Synthesizer* createAeolus();
@@ -2496,16 +2497,16 @@ static bool doConvert(Score* cs, QString fn)
                   if (cs->excerpts().size() == 0) {
                         auto excerpts = Excerpt::createAllExcerpt(cs->masterScore());
 
+                        cs->startCmd();
                         for (Excerpt* e : excerpts) {
                               Score* nscore = new Score(e->oscore());
                               e->setPartScore(nscore);
                               nscore->masterScore()->setName(e->title()); // needed before AddExcerpt
                               nscore->style()->set(StyleIdx::createMultiMeasureRests, true);
-                              cs->startCmd();
                               cs->undo(new AddExcerpt(nscore));
-                              createExcerpt(e);
-                              cs->endCmd();
                               }
+                        createExcerpts(excerpts);
+                        cs->endCmd();
                         }
                   QList<Score*> scores;
                   scores.append(cs);
@@ -2521,16 +2522,16 @@ static bool doConvert(Score* cs, QString fn)
                   if (cs->excerpts().size() == 0) {
                         auto excerpts = Excerpt::createAllExcerpt(cs->masterScore());
 
+                        cs->startCmd();
                         for (Excerpt* e: excerpts) {
                               Score* nscore = new Score(e->oscore());
                               e->setPartScore(nscore);
                               nscore->setName(e->title()); // needed before AddExcerpt
                               nscore->style()->set(StyleIdx::createMultiMeasureRests, true);
-                              cs->startCmd();
                               cs->undo(new AddExcerpt(nscore));
-                              createExcerpt(e);
-                              cs->endCmd();
                               }
+                        createExcerpts(excerpts);
+                        cs->endCmd();
                         }
                   if (!mscore->savePng(cs, fn))
                         return false;
@@ -2760,6 +2761,7 @@ MasterSynthesizer* synthesizerFactory()
       MasterSynthesizer* ms = new MasterSynthesizer();
 
       FluidS::Fluid* fluid = new FluidS::Fluid();
+      fluid->setRenderThreads(qBound(0, preferences.synthRenderThreads, QThread::idealThreadCount() - 1));
       ms->registerSynthesizer(fluid);
 
 #ifdef AEOLUS
@@ -5300,6 +5302,7 @@ int main(int argc, char* av[])
       parser.addOption(QCommandLineOption({"w", "no-webview"}, "No web view in start center"));
       parser.addOption(QCommandLineOption({"P", "export-score-parts"}, "Used with -o <file>.pdf, export score + parts"));
       parser.addOption(QCommandLineOption({"f", "force"}, "Used with -o, ignore warnings reg. score being corrupted or from wrong version"));
+      parser.addOption(QCommandLineOption(      "trace", "Write a trace of layout, playback and file operations to 'file' (Chrome trace format)", "file"));
 
       parser.addPositionalArgument("scorefiles", "The files to open", "[scorefile...]");
 
@@ -5410,6 +5413,8 @@ int main(int argc, char* av[])
       if (exportScoreParts && !converterMode)
             parser.showHelp(EXIT_FAILURE);
       ignoreWarnings = parser.isSet("f");
+      if (parser.isSet("trace") && !Trace::start(parser.value("trace")))
+            parser.showHelp(EXIT_FAILURE);
 
       QStringList argv = parser.positionalArguments();
 
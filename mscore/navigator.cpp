@@ -367,8 +367,19 @@ void Navigator::paintEvent(QPaintEvent* ev)
             p.fillRect(pr, Qt::white);
             p.translate(pos);
             for (System* s  : page->systems()) {
-                  for (MeasureBase* m : s->measures())
-                        m->scanElements(&p, paintElement, false);
+                  // only the visible measures and one on either side for
+                  // elements extending beyond their measure; the system of
+                  // the continuous view is as long as the score
+                  const std::vector<MeasureBase*>& ml = s->measures();
+                  qreal x = pos.x() + s->x();
+                  size_t i = s->measureIndex(fr.left() - x);
+                  if (i > 0)
+                        --i;
+                  for (; i < ml.size(); ++i) {
+                        ml[i]->scanElements(&p, paintElement, false);
+                        if (ml[i]->x() + x > fr.right())
+                              break;
+                        }
                   }
             page->scanElements(&p, paintElement, false);
             if (page->score()->layoutMode() == LayoutMode::PAGE) {
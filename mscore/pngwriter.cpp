@@ -0,0 +1,209 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2016 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include "pngwriter.h"
+#include "libmscore/mscore.h"
+
+namespace Ms {
+
+static const int OUT_BUFFER_SIZE = 64 * 1024;
+
+//---------------------------------------------------------
+//   putUInt32
+//    big endian
+//---------------------------------------------------------
+
+static void putUInt32(QByteArray& ba, quint32 val)
+      {
+      ba.append(char(val >> 24));
+      ba.append(char(val >> 16));
+      ba.append(char(val >> 8));
+      ba.append(char(val));
+      }
+
+//---------------------------------------------------------
+//   PngWriter
+//    dpi is stored in the pHYs chunk
+//---------------------------------------------------------
+
+PngWriter::PngWriter(QIODevice* device, int width, int height, double dpi, bool alpha)
+   : _device(device), _width(width), _height(height), _alpha(alpha)
+      {
+      _bpp = alpha ? 4 : 3;
+      _prev.fill(0, _width * _bpp);
+      _filtered.resize(_width * _bpp + 1);
+      _candidate.resize(_width * _bpp + 1);
+      _out.resize(OUT_BUFFER_SIZE);
+
+      memset(&_z, 0, sizeof(_z));
+      if (deflateInit(&_z, Z_DEFAULT_COMPRESSION) != Z_OK) {
+            _ok = false;
+            return;
+            }
+      _z.next_out  = reinterpret_cast<Bytef*>(_out.data());
+      _z.avail_out = OUT_BUFFER_SIZE;
+
+      static const char signature[] = { char(0x89), 'P', 'N', 'G', '\r', '\n', 0x1a, '\n' };
+      _ok = _device->write(signature, sizeof(signature)) == sizeof(signature);
+
+      QByteArray ihdr;
+      putUInt32(ihdr, _width);
+      putUInt32(ihdr, _height);
+      ihdr.append(char(8));                     // bit depth
+      ihdr.append(char(alpha ? 6 : 2));         // color type RGBA or RGB
+      ihdr.append(char(0));                     // compression
+      ihdr.append(char(0));                     // filter
+      ihdr.append(char(0));                     // no interlace
+      writeChunk("IHDR", ihdr);
+
+      QByteArray phys;
+      quint32 dpm = lrint(dpi * 1000.0 / INCH);
+      putUInt32(phys, dpm);
+      putUInt32(phys, dpm);
+      phys.append(char(1));                     // unit is meter
+      writeChunk("pHYs", phys);
+      }
+
+PngWriter::~PngWriter()
+      {
+      deflateEnd(&_z);
+      }
+
+//---------------------------------------------------------
+//   writeChunk
+//---------------------------------------------------------
+
+void PngWriter::writeChunk(const char* type, const QByteArray& data)
+      {
+      QByteArray chunk;
+      putUInt32(chunk, data.size());
+      chunk.append(type, 4);
+      chunk.append(data);
+      uLong crc = crc32(0, reinterpret_cast<const Bytef*>(chunk.constData() + 4), data.size() + 4);
+      putUInt32(chunk, crc);
+      if (_device->write(chunk) != chunk.size())
+            _ok = false;
+      }
+
+//---------------------------------------------------------
+//   filterRow
+//    choose the png filter with the smallest sum of
+//    absolute differences, the heuristic of libpng
+//---------------------------------------------------------
+
+void PngWriter::filterRow(const uchar* row)
+      {
+      const int n     = _width * _bpp;
+      const uchar* up = reinterpret_cast<const uchar*>(_prev.constData());
+      quint64 bestSum = ~quint64(0);
+      for (int filter = 0; filter < 5; ++filter) {
+            uchar* c = reinterpret_cast<uchar*>(_candidate.data());
+            c[0] = uchar(filter);
+            quint64 sum = 0;
+            for (int i = 0; i < n; ++i) {
+                  int a  = i >= _bpp ? row[i - _bpp] : 0;
+                  int b  = up[i];
+                  int cc = i >= _bpp ? up[i - _bpp] : 0;
+                  int pred;
+                  switch (filter) {
+                        case 0:  pred = 0; break;
+                        case 1:  pred = a; break;
+                        case 2:  pred = b; break;
+                        case 3:  pred = (a + b) / 2; break;
+                        default: {
+                              int p  = a + b - cc;
+                              int pa = qAbs(p - a);
+                              int pb = qAbs(p - b);
+                              int pc = qAbs(p - cc);
+                              pred = (pa <= pb && pa <= pc) ? a : (pb <= pc ? b : cc);
+                              }
+                              break;
+                        }
+                  uchar v  = uchar(row[i] - pred);
+                  c[i + 1] = v;
+                  sum     += v < 128 ? v : 256 - v;
+                  }
+            if (sum < bestSum) {
+                  bestSum = sum;
+                  _filtered.swap(_candidate);
+                  }
+            }
+      memcpy(_prev.data(), row, n);
+      }
+
+//---------------------------------------------------------
+//   deflateRow
+//---------------------------------------------------------
+
+void PngWriter::deflateRow(const uchar* row, int flush)
+      {
+      if (row) {
+            filterRow(row);
+            _z.next_in  = reinterpret_cast<Bytef*>(_filtered.data());
+            _z.avail_in = _filtered.size();
+            }
+      else {
+            _z.next_in  = 0;
+            _z.avail_in = 0;
+            }
+      for (;;) {
+            int rv = deflate(&_z, flush);
+            if (rv == Z_STREAM_ERROR) {
+                  _ok = false;
+                  return;
+                  }
+            if (_z.avail_out == 0 || (rv == Z_STREAM_END && _z.avail_out < uInt(OUT_BUFFER_SIZE))) {
+                  writeChunk("IDAT", _out.left(OUT_BUFFER_SIZE - _z.avail_out));
+                  _z.next_out  = reinterpret_cast<Bytef*>(_out.data());
+                  _z.avail_out = OUT_BUFFER_SIZE;
+                  }
+            if (rv == Z_STREAM_END)
+                  return;
+            if (flush == Z_NO_FLUSH && _z.avail_in == 0)
+                  return;
+            }
+      }
+
+//---------------------------------------------------------
+//   writeRows
+//    append the rows of band, which must be as wide
+//    as the image
+//---------------------------------------------------------
+
+bool PngWriter::writeRows(const QImage& band)
+      {
+      if (!_ok || band.width() != _width || _rows + band.height() > _height)
+            return false;
+      QImage img = band.convertToFormat(_alpha ? QImage::Format_RGBA8888 : QImage::Format_RGB888);
+      for (int y = 0; y < img.height() && _ok; ++y)
+            deflateRow(img.constScanLine(y), Z_NO_FLUSH);
+      _rows += img.height();
+      return _ok;
+      }
+
+//---------------------------------------------------------
+//   finish
+//    return false if the image is incomplete or
+//    writing failed
+//---------------------------------------------------------
+
+bool PngWriter::finish()
+      {
+      if (!_ok || _rows != _height)
+            return false;
+      deflateRow(0, Z_FINISH);
+      writeChunk("IEND", QByteArray());
+      return _ok;
+      }
+
+}     // namespace Ms
+
@@ -0,0 +1,55 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2016 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#ifndef __PNGWRITER_H__
+#define __PNGWRITER_H__
+
+#include <zlib.h>
+
+namespace Ms {
+
+//---------------------------------------------------------
+//   PngWriter
+//    writes a png image band by band, so an image does
+//    not need to exist in memory as a whole; compressed
+//    data is written to the device as soon as it is
+//    available
+//---------------------------------------------------------
+
+class PngWriter {
+      QIODevice* _device;
+      int _width;
+      int _height;
+      bool _alpha;
+      int _rows       { 0 };
+      int _bpp;                     // bytes per pixel
+      bool _ok        { true };
+      z_stream _z;
+      QByteArray _prev;             // previous row, unfiltered
+      QByteArray _filtered;         // filter type and filtered row
+      QByteArray _candidate;
+      QByteArray _out;
+
+      void writeChunk(const char* type, const QByteArray& data);
+      void deflateRow(const uchar* row, int flush);
+      void filterRow(const uchar* row);
+
+   public:
+      PngWriter(QIODevice* device, int width, int height, double dpi, bool alpha);
+      ~PngWriter();
+      bool writeRows(const QImage& band);
+      bool finish();
+      };
+
+}     // namespace Ms
+#endif
+
@@ -122,6 +122,7 @@ void Preferences::init()
       alsaFragments      = 3;
       portaudioDevice    = -1;
       portMidiInput      = "";
+      synthRenderThreads = 0;
 
       antialiasedDrawing       = true;
       sessionStart             = SessionStart::SCORE;
@@ -151,6 +152,8 @@ void Preferences::init()
       autoSaveTime             = 2;       // minutes
       pngResolution            = 300.0;
       pngTransparent           = true;
+      svgUseSymbols            = false;
+      svgOneFilePerPage        = false;
       language                 = "system";
 
       mag                     = 1.0;
@@ -260,6 +263,8 @@ void Preferences::write()
       s.setValue("alsaFragments",      alsaFragments);
       s.setValue("portaudioDevice",    portaudioDevice);
       s.setValue("portMidiInput",   portMidiInput);
+      s.setValue("synthRenderThreads", synthRenderThreads);
+      s.setValue("parallelLayout",     MScore::parallelLayout);
 
       s.setValue("layoutBreakColor",   MScore::layoutBreakColor);
       s.setValue("frameMarginColor",   MScore::frameMarginColor);
@@ -295,6 +300,8 @@ void Preferences::write()
       s.setValue("autoSaveTime",       autoSaveTime);
       s.setValue("pngResolution",      pngResolution);
       s.setValue("pngTransparent",     pngTransparent);
+      s.setValue("svgUseSymbols",      svgUseSymbols);
+      s.setValue("svgOneFilePerPage",  svgOneFilePerPage);
       s.setValue("language",           language);
 
       s.setValue("paperWidth",  MScore::defaultStyle()->pageFormat()->width());
@@ -411,6 +418,8 @@ void Preferences::read()
       alsaFragments      = s.value("alsaFragments", alsaFragments).toInt();
       portaudioDevice    = s.value("portaudioDevice", portaudioDevice).toInt();
       portMidiInput      = s.value("portMidiInput", portMidiInput).toString();
+      synthRenderThreads = s.value("synthRenderThreads", synthRenderThreads).toInt();
+      MScore::parallelLayout = s.value("parallelLayout", MScore::parallelLayout).toBool();
       MScore::layoutBreakColor   = s.value("layoutBreakColor", MScore::layoutBreakColor).value<QColor>();
       MScore::frameMarginColor   = s.value("frameMarginColor", MScore::frameMarginColor).value<QColor>();
       antialiasedDrawing      = s.value("antialiasedDrawing", antialiasedDrawing).toBool();
@@ -428,6 +437,8 @@ void Preferences::read()
       autoSaveTime             = s.value("autoSaveTime", autoSaveTime).toInt();
       pngResolution            = s.value("pngResolution", pngResolution).toDouble();
       pngTransparent           = s.value("pngTransparent", pngTransparent).toBool();
+      svgUseSymbols            = s.value("svgUseSymbols", svgUseSymbols).toBool();
+      svgOneFilePerPage        = s.value("svgOneFilePerPage", svgOneFilePerPage).toBool();
       language                 = s.value("language", language).toString();
 
       musicxmlImportLayout     = s.value("musicxmlImportLayout", musicxmlImportLayout).toBool();
@@ -841,6 +852,8 @@ void PreferenceDialog::updateValues()
       autoSaveTime->setValue(prefs.autoSaveTime);
       pngResolution->setValue(prefs.pngResolution);
       pngTransparent->setChecked(prefs.pngTransparent);
+      svgUseSymbols->setChecked(prefs.svgUseSymbols);
+      svgOneFilePerPage->setChecked(prefs.svgOneFilePerPage);
       language->blockSignals(true);
       for (int i = 0; i < language->count(); ++i) {
             if (language->itemText(i).startsWith(prefs.language)) {
@@ -1398,6 +1411,8 @@ void PreferenceDialog::apply()
       prefs.autoSaveTime       = autoSaveTime->value();
       prefs.pngResolution      = pngResolution->value();
       prefs.pngTransparent     = pngTransparent->isChecked();
+      prefs.svgUseSymbols      = svgUseSymbols->isChecked();
+      prefs.svgOneFilePerPage  = svgOneFilePerPage->isChecked();
       converterDpi             = prefs.pngResolution;
       prefs.exportPdfDpi       = exportPdfDpi->value();
       if (MScore::verticalOrientation() != pageVertical->isChecked()) {
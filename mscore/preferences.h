@@ -115,6 +115,7 @@ struct Preferences {
       int alsaFragments;
       int portaudioDevice;
       QString portMidiInput;
+      int synthRenderThreads;       // worker threads rendering Fluid voices, 0: audio thread only
 
       bool antialiasedDrawing;
       SessionStart sessionStart;
@@ -143,6 +144,8 @@ struct Preferences {
       int autoSaveTime;
       double pngResolution;
       bool pngTransparent;
+      bool svgUseSymbols;     // write each glyph once and reference it with <use>
+      bool svgOneFilePerPage;
       QString language;
 
       double mag;
@@ -40,6 +40,7 @@
 #include "libmscore/utils.h"
 #include "libmscore/repeatlist.h"
 #include "libmscore/audio.h"
+#include "libmscore/trace.h"
 #include "synthcontrol.h"
 #include "pianoroll.h"
 #include "pianotools.h"
@@ -226,6 +227,9 @@ void Seq::setScoreView(ScoreView* v)
 
 bool Seq::init(bool hotPlug)
       {
+      // the trace buffer of the audio thread must not be
+      // allocated in the realtime callback
+      Trace::reserveThread("audio");
       if (!_driver || !_driver->start(hotPlug)) {
             qDebug("Cannot start I/O");
             running = false;
@@ -658,6 +662,8 @@ void Seq::addCountInClicks()
 
 void Seq::process(unsigned n, float* buffer)
       {
+      Trace::setThreadName("audio");
+      TRACE_SPAN_ARG("Seq::process", "audio", "frames", n);
       unsigned frames = n;
       Transport driverState = _driver->getState();
       // Checking for the reposition from JACK Transport
@@ -161,6 +161,7 @@ public:
         viewBox = QRectF();
         outputDevice = 0;
         resolution = Ms::DPI;
+        useSymbols = false;
 
         attributes.title = QLatin1String("MuseScore SVG Document");
         attributes.description = QString("Generated by MuseScore %1").arg(VERSION);
@@ -179,9 +180,12 @@ public:
     QTextStream *stream;
     int resolution;
 
-    QString header;
-//    QString defs; // NEEDED FOR GRADIENTS
-    QString body;
+    QString defs;
+
+    // Glyph symbols: text items are written once into <defs> as <symbol>
+    // and referenced by <use>. Key is font key + text, value is the id.
+    bool useSymbols;
+    QHash<QString, QString> symbols;
 
     QBrush brush;
     QPen pen;
@@ -285,6 +289,13 @@ protected:
 #define SVG_IMAGE       "<image"
 #define SVG_PATH        "<path"
 #define SVG_POLYLINE    "<polyline"
+#define SVG_USE         "<use"
+#define SVG_SYMBOL_BEGIN "<symbol id=\""
+#define SVG_SYMBOL_END  "</symbol>"
+#define SVG_DEFS_BEGIN  "<defs>"
+#define SVG_DEFS_END    "</defs>"
+#define SVG_HREF        " xlink:href=\"#"
+#define SVG_OVERFLOW_VISIBLE " overflow=\"visible\""
 
 #define SVG_PRESERVE_ASPECT " preserveAspectRatio=\""
 
@@ -324,6 +335,7 @@ public:
     void popGroup();
 
     void drawPath(const QPainterPath &path);
+    void drawTextItem(const QPointF &p, const QTextItem &textItem);
     void drawPixmap(const QRectF &r, const QPixmap &pm, const QRectF &sr);
     void drawPolygon(const QPointF *points, int pointCount, PolygonDrawMode mode);
     void drawImage(const QRectF &r, const QImage &pm, const QRectF &sr,
@@ -365,6 +377,14 @@ public:
         d_func()->resolution = resolution;
     }
 
+    bool useSymbols() const { return d_func()->useSymbols; }
+    void setUseSymbols(bool val) {
+        Q_ASSERT(!isActive());
+        d_func()->useSymbols = val;
+    }
+
+    void writePathData(QTextStream &str, const QPainterPath &p, qreal dx, qreal dy);
+
 ///////////////////////////////////////////////////////////////////////////////
 // UNUSED GRADIENT CODE:
 //    void saveLinearGradientBrush(const QGradient *g)
@@ -941,6 +961,28 @@ void SvgGenerator::setResolution(int dpi)
     d->engine->setResolution(dpi);
 }
 
+/*!
+    \property SvgGenerator::useSymbols
+    \brief whether text items are shared as symbols
+
+    If set, the outline of every distinct text item (in MuseScore mostly
+    a single SMuFL glyph) is written once into <defs> as a <symbol> and
+    drawn with <use>. This renders identically to the default output,
+    where every glyph is a <path> with its full outline, but makes scores
+    much smaller. Must be set before painting starts.
+*/
+bool SvgGenerator::useSymbols() const
+{
+    Q_D(const SvgGenerator);
+    return d->engine->useSymbols();
+}
+
+void SvgGenerator::setUseSymbols(bool val)
+{
+    Q_D(SvgGenerator);
+    d->engine->setUseSymbols(val);
+}
+
 /*!
     Returns the paint engine used to render graphics to be converted to SVG
     format information.
@@ -1022,8 +1064,15 @@ bool SvgPaintEngine::begin(QPaintDevice *)
         return false;
     }
 
+    // Everything is streamed to the device as it is painted: no copy of
+    // the document is kept in memory. Only the glyph symbols are
+    // collected and written at the end, <use> may reference them forward.
+    d->stream = new QTextStream(d->outputDevice);
+#ifndef QT_NO_TEXTCODEC
+    d->stream->setCodec(QTextCodec::codecForName("UTF-8"));
+#endif
+
     // Stream the headers
-    d->stream = new QTextStream(&d->header);
     stream() << "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"no\"?>" << endl << SVG_BEGIN;
     if (d->viewBox.isValid()) {
         // viewBox has floating point values, size width/height is integer
@@ -1045,12 +1094,8 @@ bool SvgPaintEngine::begin(QPaintDevice *)
         stream() << SVG_DESC_BEGIN  << d->attributes.description << SVG_DESC_END << endl;
     }
 
-// <defs> is currently empty. It's necessary for gradients.
-//    d->stream->setString(&d->defs);
-//    *d->stream << "<defs>\n";
-
-    // Point the stream at the body string, for other functions to populate
-    d->stream->setString(&d->body);
+    d->defs.clear();
+    d->symbols.clear();
     return true;
 }
 
@@ -1058,24 +1103,12 @@ bool SvgPaintEngine::end()
 {
     Q_D(SvgPaintEngine);
 
-// <defs> is currently empty
-//    d->stream->setString(&d->defs);
-//    stream() << "</defs>\n";
-
-    // Point the stream at the real output device (the .svg file)
-    d->stream->setDevice(d->outputDevice);
-
-#ifndef QT_NO_TEXTCODEC
-    d->stream->setCodec(QTextCodec::codecForName("UTF-8"));
-#endif
-
-    // Stream our strings out to the device, in order
-    stream() << d->header;
-//    stream() << d->defs;
-    stream() << d->body;
+    if (!d->defs.isEmpty())
+        stream() << SVG_DEFS_BEGIN << '\n' << d->defs << SVG_DEFS_END << '\n';
     stream() << SVG_END << endl;
 
     delete d->stream;
+    d->stream = 0;
     return true;
 }
 
@@ -1106,7 +1139,7 @@ void SvgPaintEngine::drawImage(const QRectF  &r, const QImage &image,
     buffer.close();
 
     stream() << " xlink:href=\"data:image/png;base64,"
-             << data.toBase64() << SVG_QUOTE << SVG_ELEMENT_END << endl;
+             << data.toBase64() << SVG_QUOTE << SVG_ELEMENT_END << '\n';
 }
 
 void SvgPaintEngine::updateState(const QPaintEngineState &state)
@@ -1162,36 +1195,28 @@ void SvgPaintEngine::updateState(const QPaintEngineState &state)
 
 }
 
-void SvgPaintEngine::drawPath(const QPainterPath &p)
+void SvgPaintEngine::writePathData(QTextStream &str, const QPainterPath &p, qreal dx, qreal dy)
 {
-    stream() << SVG_PATH << stateString;
-
-    // fill-rule is here because UpdateState() doesn't have a QPainterPath arg
-    // Majority of <path>s use the default value: fill-rule="nonzero"
-    if (p.fillRule() == Qt::OddEvenFill)
-        stream() << SVG_FILL_RULE;
-
-    // Path data
-    stream() << SVG_D;
+    str << SVG_D;
     for (int i = 0; i < p.elementCount(); ++i) {
         const QPainterPath::Element &e = p.elementAt(i);
-                               qreal x = e.x + _dx;
-                               qreal y = e.y + _dy;
+                               qreal x = e.x + dx;
+                               qreal y = e.y + dy;
         switch (e.type) {
         case QPainterPath::MoveToElement:
-            stream() << SVG_MOVE  << x << SVG_COMMA << y;
+            str << SVG_MOVE  << x << SVG_COMMA << y;
             break;
         case QPainterPath::LineToElement:
-            stream() << SVG_LINE  << x << SVG_COMMA << y;
+            str << SVG_LINE  << x << SVG_COMMA << y;
             break;
         case QPainterPath::CurveToElement:
-            stream() << SVG_CURVE << x << SVG_COMMA << y;
+            str << SVG_CURVE << x << SVG_COMMA << y;
             ++i;
             while (i < p.elementCount()) {
                 const QPainterPath::Element &e = p.elementAt(i);
                 if (e.type == QPainterPath::CurveToDataElement) {
-                    stream() << SVG_SPACE << e.x + _dx
-                             << SVG_COMMA << e.y + _dy;
+                    str << SVG_SPACE << e.x + dx
+                        << SVG_COMMA << e.y + dy;
                     ++i;
                 }
                 else {
@@ -1204,9 +1229,77 @@ void SvgPaintEngine::drawPath(const QPainterPath &p)
             break;
         }
         if (i <= p.elementCount() - 1)
-            stream() << SVG_SPACE;
+            str << SVG_SPACE;
+    }
+    str << SVG_QUOTE;
+}
+
+void SvgPaintEngine::drawPath(const QPainterPath &p)
+{
+    stream() << SVG_PATH << stateString;
+
+    // fill-rule is here because UpdateState() doesn't have a QPainterPath arg
+    // Majority of <path>s use the default value: fill-rule="nonzero"
+    if (p.fillRule() == Qt::OddEvenFill)
+        stream() << SVG_FILL_RULE;
+
+    // Path data
+    writePathData(stream(), p, _dx, _dy);
+    stream() << SVG_ELEMENT_END << '\n';
+}
+
+// Without useSymbols this is QPaintEngine::drawTextItem(), which fills the
+// text outline with the pen color through drawPath().
+// With useSymbols the outline is written once per font and text into <defs>
+// and the text item becomes a <use> with the same fill and transformation.
+void SvgPaintEngine::drawTextItem(const QPointF &p, const QTextItem &textItem)
+{
+    Q_D(SvgPaintEngine);
+    if (!d->useSymbols) {
+        QPaintEngine::drawTextItem(p, textItem);
+        return;
+    }
+    const QFont font = textItem.font();
+    const QString key = font.key() + QLatin1Char('|') + textItem.text();
+    QString id = d->symbols.value(key);
+    if (id.isEmpty()) {
+        QPainterPath path;
+        path.setFillRule(Qt::WindingFill);
+        path.addText(QPointF(), font, textItem.text());
+        if (path.isEmpty())
+            return;
+        id = QString("s%1").arg(d->symbols.size());
+        d->symbols.insert(key, id);
+        QTextStream str(&d->defs, QIODevice::Append);
+        str << SVG_SYMBOL_BEGIN << id << SVG_QUOTE << SVG_OVERFLOW_VISIBLE << SVG_GT
+            << SVG_PATH;
+        writePathData(str, path, 0.0, 0.0);
+        str << SVG_ELEMENT_END << SVG_SYMBOL_END << '\n';
+    }
+
+    stream() << SVG_USE << SVG_HREF << id << SVG_QUOTE
+             << SVG_CLASS << getClass(_element) << SVG_QUOTE
+             << qbrushToSvg(state->pen().brush());
+    if (!qFuzzyIsNull(state->opacity() - 1))
+        stream() << SVG_OPACITY << state->opacity() << SVG_QUOTE;
+
+    // same transformation handling as in updateState()
+    const QTransform t = QTransform::fromTranslate(p.x(), p.y()) * state->transform();
+    const qreal m11 = qRound(t.m11() * 1000) / 1000.0;
+    const qreal m22 = qRound(t.m22() * 1000) / 1000.0;
+    if (m11 == 1 && m22 == 1 && t.m12() == t.m21()) {
+        stream() << SVG_X << SVG_QUOTE << t.m31() << SVG_QUOTE
+                 << SVG_Y << SVG_QUOTE << t.m32() << SVG_QUOTE;
+    }
+    else {
+        stream() << SVG_MATRIX << t.m11() << SVG_COMMA
+                               << t.m12() << SVG_COMMA
+                               << t.m21() << SVG_COMMA
+                               << t.m22() << SVG_COMMA
+                               << t.m31() << SVG_COMMA
+                               << t.m32() << SVG_RPAREN_QUOTE;
     }
-    stream() << SVG_QUOTE << SVG_ELEMENT_END << endl;
+    stream() << SVG_ELEMENT_END << '\n';
 }
 
 void SvgPaintEngine::drawPolygon(const QPointF *points, int pointCount,
@@ -1227,7 +1320,7 @@ void SvgPaintEngine::drawPolygon(const QPointF *points, int pointCount,
             if (i != pointCount - 1)
                 stream() << SVG_SPACE;
         }
-        stream() << SVG_QUOTE << SVG_ELEMENT_END <<endl;
+        stream() << SVG_QUOTE << SVG_ELEMENT_END << '\n';
     }
     else {
         path.closeSubpath();
@@ -62,6 +62,7 @@ class SvgGeneratorPrivate;
 //   @P fileName      QString
 //   @P outputDevice  QIODevice
 //   @P resolution    int
+//   @P useSymbols    bool
 //---------------------------------------------------------
 
 class SvgGenerator : public QPaintDevice
@@ -75,6 +76,7 @@ class SvgGenerator : public QPaintDevice
     Q_PROPERTY(QString fileName READ fileName WRITE setFileName)
     Q_PROPERTY(QIODevice* outputDevice READ outputDevice WRITE setOutputDevice)
     Q_PROPERTY(int resolution READ resolution WRITE setResolution)
+    Q_PROPERTY(bool useSymbols READ useSymbols WRITE setUseSymbols)
 public:
     SvgGenerator();
     ~SvgGenerator();
@@ -102,6 +104,9 @@ public:
     void setResolution(int dpi);
     int resolution() const;
 
+    void setUseSymbols(bool val);
+    bool useSymbols() const;
+
     void setElement(const Ms::Element* e);
 
 protected:
@@ -0,0 +1,89 @@
+#!/usr/bin/env python
+#=============================================================================
+#  MuseScore
+#  Music Composition & Notation
+#
+#  Copyright (C) 2016 Werner Schweer
+#
+#  This program is free software; you can redistribute it and/or modify
+#  it under the terms of the GNU General Public License version 2
+#  as published by the Free Software Foundation and appearing in
+#  the file LICENCE.GPL
+#=============================================================================
+
+# Compare two result files of tst_benchmarksuite.
+#
+#   compare.py baseline.json current.json [--threshold 10] [--min-ms 1]
+#
+# Prints the median times of both files per score and operation and
+# exits with 1 if an operation got slower than the threshold (percent).
+# Operations faster than --min-ms in the baseline are reported but
+# never counted as regression: they are dominated by noise. The memory
+# entry compares the heap bytes per note instead. Operations missing
+# from one file, or without a value, are listed with '-'; a zero
+# baseline has no change.
+
+import argparse
+import json
+import sys
+
+
+def load(path):
+    with open(path) as f:
+        data = json.load(f)
+    if data.get('version') != 1:
+        sys.exit('%s: unsupported result version %s' % (path, data.get('version')))
+    return data['results']
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Compare benchmark suite results.')
+    parser.add_argument('baseline')
+    parser.add_argument('current')
+    parser.add_argument('--threshold', type=float, default=10.0,
+                        help='regression threshold in percent (default 10)')
+    parser.add_argument('--min-ms', type=float, default=1.0,
+                        help='ignore operations faster than this in the baseline (default 1)')
+    args = parser.parse_args()
+
+    baseline = load(args.baseline)
+    current = load(args.current)
+
+    regressions = 0
+    print('%-12s %-16s %12s %12s %9s' % ('score', 'operation', 'baseline ms', 'current ms', 'change'))
+    for score in sorted(set(baseline) | set(current)):
+        ops = set(baseline.get(score, {})) | set(current.get(score, {}))
+        for op in sorted(ops):
+            b = baseline.get(score, {}).get(op) or {}
+            c = current.get(score, {}).get(op) or {}
+            # memory: bytes per note instead of a time
+            key = 'bytesPerNote' if 'bytesPerNote' in b or 'bytesPerNote' in c else 'median'
+            unit = '' if key == 'median' else '  bytes/note'
+            bv = b.get(key)
+            cv = c.get(key)
+            if bv is None or cv is None:
+                print('%-12s %-16s %12s %12s %9s%s' % (score, op,
+                      '%.2f' % bv if bv is not None else '-',
+                      '%.2f' % cv if cv is not None else '-', '', unit))
+                continue
+            if bv <= 0:
+                # nothing to compare a change with
+                print('%-12s %-16s %12.2f %12.2f %9s%s' % (score, op, bv, cv, 'n/a', unit))
+                continue
+            change = (cv - bv) * 100.0 / bv
+            mark = ''
+            if change > args.threshold and (key != 'median' or bv >= args.min_ms):
+                mark = '  REGRESSION'
+                regressions += 1
+            if 'bytes' in b and 'bytes' in c and key == 'median':
+                mark += '  size %d -> %d bytes' % (b['bytes'], c['bytes'])
+            print('%-12s %-16s %12.2f %12.2f %+8.1f%%%s%s' % (score, op, bv, cv, change, unit, mark))
+
+    if regressions:
+        print('%d regression(s) above %.1f%%' % (regressions, args.threshold))
+        return 1
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
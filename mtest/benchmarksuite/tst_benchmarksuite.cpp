@@ -0,0 +1,678 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2016 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include <QtTest/QtTest>
+#include "mtest/testutils.h"
+#include "libmscore/score.h"
+#include "libmscore/mcursor.h"
+#include "libmscore/durationtype.h"
+#include "libmscore/measure.h"
+#include "libmscore/segment.h"
+#include "libmscore/chord.h"
+#include "libmscore/note.h"
+#include "libmscore/lyrics.h"
+#include "libmscore/page.h"
+#include "libmscore/part.h"
+#include "libmscore/excerpt.h"
+#include "libmscore/undo.h"
+#include "synthesizer/event.h"
+#include "mscore/exportmidi.h"
+#include "mscore/preferences.h"
+#include "mscore/exportimage.h"
+
+#ifdef Q_OS_LINUX
+#include <malloc.h>
+#endif
+
+namespace Ms {
+extern Score::FileError importMidi(MasterScore*, const QString&);
+extern Score::FileError importMusicXml(MasterScore*, const QString&);
+extern bool saveXml(Score*, const QString&);
+}
+
+using namespace Ms;
+
+//---------------------------------------------------------
+//   TestBenchmarkSuite
+//    times the main operations on a corpus of real and
+//    synthetic scores and writes the results as json;
+//    compare.py compares two result files
+//
+//    MSCORE_BENCHMARK_RUNS     runs per operation (3)
+//    MSCORE_BENCHMARK_OUTPUT   result file (benchmark.json)
+//---------------------------------------------------------
+
+class TestBenchmarkSuite : public QObject, public MTest
+      {
+      Q_OBJECT
+
+      int runs;
+      QMap<QString, QString> corpus;            // name, path
+      QMap<QString, MasterScore*> scores;
+      QJsonObject results;
+
+      MasterScore* createSynthetic(const QString& name, const QStringList& instruments,
+         int measures, int notesPerBeat, int chordSize, bool lyrics);
+      void createLinkedParts(MasterScore*);
+      Chord* firstChord(Score*) const;
+      void corpusData();
+      template<typename F> void measure(const QString& operation, F f);
+      template<typename F> void measure(const QString& operation, F f, std::function<void()> prepare);
+      void record(const QString& operation, const QString& key, double value);
+      void saveSvg(const QString& operation, bool useSymbols);
+
+   private slots:
+      void initTestCase();
+      void cleanupTestCase();
+
+      void load_data()              { corpusData(); }
+      void load();
+      void save_data()              { corpusData(); }
+      void save();
+      void memory_data()            { corpusData(); }
+      void memory();
+      void layoutFull_data()        { corpusData(); }
+      void layoutFull();
+      void layoutParallel_data()    { corpusData(); }
+      void layoutParallel();
+      void layoutRange_data()       { corpusData(); }
+      void layoutRange();
+      void layoutRangeLine_data()   { corpusData(); }
+      void layoutRangeLine();
+      void createParts_data()       { corpusData(); }
+      void createParts();
+      void noteEdit_data()          { corpusData(); }
+      void noteEdit();
+      void renderMidi_data()        { corpusData(); }
+      void renderMidi();
+      void exportMusicXml_data()    { corpusData(); }
+      void exportMusicXml();
+      void importMusicXml_data()    { corpusData(); }
+      void importMusicXml();
+      void exportMidi_data()        { corpusData(); }
+      void exportMidi();
+      void importMidi_data()        { corpusData(); }
+      void importMidi();
+      void exportPdf_data()         { corpusData(); }
+      void exportPdf();
+      void exportPng_data()         { corpusData(); }
+      void exportPng();
+      void exportSvg_data()         { corpusData(); }
+      void exportSvg()              { saveSvg("exportSvg", false); }
+      void exportSvgSymbols_data()  { corpusData(); }
+      void exportSvgSymbols()       { saveSvg("exportSvgSymbols", true); }
+      };
+
+//---------------------------------------------------------
+//   initTestCase
+//---------------------------------------------------------
+
+void TestBenchmarkSuite::initTestCase()
+      {
+      initMTest();
+      runs = qMax(1, qgetenv("MSCORE_BENCHMARK_RUNS").toInt());
+      if (qgetenv("MSCORE_BENCHMARK_RUNS").isEmpty())
+            runs = 3;
+
+      corpus["goldberg"] = root + "/../demos/goldberg.mscz";
+      corpus["reunion"]  = root + "/../demos/Reunion.mscz";
+      corpus["adeste"]   = root + "/../demos/adeste.mscx";
+      corpus["guitartab"] = root + "/guitarpro/timer.gpx";
+
+      QStringList orchestra = {
+            "piccolo", "flute", "oboe", "english-horn", "clarinet", "bass-clarinet",
+            "bassoon", "contrabassoon", "horn", "horn", "trumpet", "trumpet",
+            "trombone", "bass-trombone", "tuba", "timpani", "harp", "celesta",
+            "violin", "violin", "viola", "violoncello", "contrabass", "piano"
+            };
+      QStringList choir = { "soprano", "alto", "tenor", "bass" };
+      QStringList band;
+      for (int i = 0; i < 30; ++i)
+            band.append(i % 2 ? "violin" : "flute");
+
+      QList<MasterScore*> synthetic;
+      synthetic.append(createSynthetic("orchestral", orchestra, 200, 1, 1, false));
+      synthetic.append(createSynthetic("choral", choir, 200, 2, 1, true));
+      synthetic.append(createSynthetic("piano", { "piano" }, 200, 4, 4, false));
+      MasterScore* parts = createSynthetic("parts30", band, 64, 2, 1, false);
+      createLinkedParts(parts);
+      synthetic.append(parts);
+
+      for (MasterScore* score : synthetic) {
+            QString path = QDir::current().absoluteFilePath(QString("bench-%1.mscx").arg(score->name()));
+            QVERIFY(saveScore(score, path));
+            corpus[score->name()] = path;
+            delete score;
+            }
+      for (const QString& name : corpus.keys()) {
+            MasterScore* score = readCreatedScore(corpus[name]);
+            QVERIFY2(score, qPrintable(corpus[name]));
+            scores[name] = score;
+            }
+      }
+
+//---------------------------------------------------------
+//   cleanupTestCase
+//    write results
+//---------------------------------------------------------
+
+void TestBenchmarkSuite::cleanupTestCase()
+      {
+      QJsonObject o;
+      o["version"] = 1;
+      o["runs"]    = runs;
+      o["date"]    = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+      o["results"] = results;
+
+      QString path = QString::fromLocal8Bit(qgetenv("MSCORE_BENCHMARK_OUTPUT"));
+      if (path.isEmpty())
+            path = "benchmark.json";
+      QFile f(path);
+      QVERIFY(f.open(QIODevice::WriteOnly));
+      f.write(QJsonDocument(o).toJson());
+      f.close();
+
+      qDeleteAll(scores);
+      scores.clear();
+      }
+
+//---------------------------------------------------------
+//   createSynthetic
+//    one staff per instrument, notesPerBeat chords per
+//    quarter with chordSize notes each
+//---------------------------------------------------------
+
+MasterScore* TestBenchmarkSuite::createSynthetic(const QString& name, const QStringList& instruments,
+   int measures, int notesPerBeat, int chordSize, bool lyrics)
+      {
+      MCursor c;
+      c.setTimeSig(Fraction(4,4));
+      c.createScore(name);
+      for (const QString& instrument : instruments)
+            c.addPart(instrument);
+      c.move(0, 0);
+      c.addKeySig(Key(0));
+      c.addTimeSig(Fraction(4,4));
+
+      TDuration d(TDuration::DurationType::V_QUARTER);
+      if (notesPerBeat == 2)
+            d = TDuration(TDuration::DurationType::V_EIGHTH);
+      else if (notesPerBeat == 4)
+            d = TDuration(TDuration::DurationType::V_16TH);
+      int notes  = measures * 4 * notesPerBeat;
+      int ticks  = d.ticks();
+      MasterScore* score = c.score();
+
+      for (int staffIdx = 0; staffIdx < instruments.size(); ++staffIdx) {
+            int track = staffIdx * VOICES;
+            for (int i = 0; i < notes; ++i) {
+                  int pitch = 60 + (i * 5 + staffIdx * 3) % 12;
+                  Chord* chord = 0;
+                  for (int k = 0; k < chordSize; ++k) {
+                        c.move(track, i * ticks);
+                        chord = c.addChord(pitch + k * 4, d);
+                        }
+                  if (lyrics) {
+                        Lyrics* l = new Lyrics(score);
+                        l->setTrack(track);
+                        l->setXmlText(i % 2 ? "la" : "lu");
+                        chord->add(l);
+                        }
+                  }
+            }
+      score->doLayout();
+      score->rebuildMidiMapping();
+      return score;
+      }
+
+//---------------------------------------------------------
+//   createLinkedParts
+//    one linked part per instrument
+//---------------------------------------------------------
+
+void TestBenchmarkSuite::createLinkedParts(MasterScore* score)
+      {
+      for (Part* part : score->parts()) {
+            Score* nscore = new Score(score);
+            Excerpt ex(score);
+            ex.setPartScore(nscore);
+            ex.setTitle(part->longName());
+            ex.setParts(QList<Part*>() << part);
+            ::createExcerpt(&ex);
+            nscore->setName(part->partName());
+            score->undo(new AddExcerpt(nscore));
+            }
+      }
+
+//---------------------------------------------------------
+//   firstChord
+//---------------------------------------------------------
+
+Chord* TestBenchmarkSuite::firstChord(Score* score) const
+      {
+      for (Segment* s = score->firstSegment(Segment::Type::ChordRest); s; s = s->next1(Segment::Type::ChordRest)) {
+            for (int track = 0; track < score->ntracks(); ++track) {
+                  Element* e = s->element(track);
+                  if (e && e->isChord())
+                        return toChord(e);
+                  }
+            }
+      return 0;
+      }
+
+//---------------------------------------------------------
+//   corpusData
+//---------------------------------------------------------
+
+void TestBenchmarkSuite::corpusData()
+      {
+      QTest::addColumn<QString>("name");
+      for (const QString& name : corpus.keys())
+            QTest::newRow(qPrintable(name)) << name;
+      }
+
+//---------------------------------------------------------
+//   measure
+//    run f runs times and record minimum and median
+//    time in ms for the current score; prepare is
+//    called before each run and not timed
+//---------------------------------------------------------
+
+template<typename F>
+void TestBenchmarkSuite::measure(const QString& operation, F f, std::function<void()> prepare)
+      {
+      QFETCH(QString, name);
+      QVector<double> times;
+      QElapsedTimer timer;
+      for (int i = 0; i < runs; ++i) {
+            if (prepare)
+                  prepare();
+            timer.start();
+            f();
+            times.append(timer.nsecsElapsed() / 1000000.0);
+            }
+      std::sort(times.begin(), times.end());
+
+      QJsonObject r;
+      r["min"]    = times.front();
+      r["median"] = times[times.size() / 2];
+      QJsonObject s = results[name].toObject();
+      s[operation] = r;
+      results[name] = s;
+      qDebug("%s %s: %.2f ms", qPrintable(name), qPrintable(operation), times[times.size() / 2]);
+      }
+
+//---------------------------------------------------------
+//   record
+//    add a value other than time to the results of
+//    operation for the current score
+//---------------------------------------------------------
+
+void TestBenchmarkSuite::record(const QString& operation, const QString& key, double value)
+      {
+      QFETCH(QString, name);
+      QJsonObject s = results[name].toObject();
+      QJsonObject r = s[operation].toObject();
+      r[key] = value;
+      s[operation] = r;
+      results[name] = s;
+      }
+
+template<typename F>
+void TestBenchmarkSuite::measure(const QString& operation, F f)
+      {
+      measure(operation, f, std::function<void()>());
+      }
+
+//---------------------------------------------------------
+//   load save
+//---------------------------------------------------------
+
+void TestBenchmarkSuite::load()
+      {
+      QFETCH(QString, name);
+      QString path = corpus[name];
+      measure("load", [this, path] {
+            MasterScore* score = readCreatedScore(path);
+            QVERIFY(score);
+            delete score;
+            });
+      }
+
+//---------------------------------------------------------
+//   heapSize
+//    bytes allocated with malloc, 0 if not known
+//---------------------------------------------------------
+
+static qint64 heapSize()
+      {
+#if defined(__GLIBC__)
+#if __GLIBC_PREREQ(2, 33)
+      struct mallinfo2 mi = mallinfo2();
+      return qint64(mi.uordblks + mi.hblkhd);
+#else
+      struct mallinfo mi = mallinfo();
+      return qint64(quint32(mi.uordblks)) + quint32(mi.hblkhd);
+#endif
+#else
+      return 0;
+#endif
+      }
+
+//---------------------------------------------------------
+//   poolTotals
+//    allocations from and chunk bytes of all element pools
+//---------------------------------------------------------
+
+static QPair<qint64, qint64> poolTotals()
+      {
+      QPair<qint64, qint64> totals(0, 0);
+      for (const ElementPool::Stats& s : ElementPool::allStats()) {
+            totals.first  += s.allocations;
+            totals.second += qint64(s.chunkBytes);
+            }
+      return totals;
+      }
+
+//---------------------------------------------------------
+//   memory
+//    heap used by a loaded and laid out score, including
+//    its parts, per note of the score
+//---------------------------------------------------------
+
+void TestBenchmarkSuite::memory()
+      {
+      QFETCH(QString, name);
+      qint64 before = heapSize();
+      if (before == 0)
+            QSKIP("heap size not available");
+      QPair<qint64, qint64> poolsBefore = poolTotals();
+      MasterScore* score = readCreatedScore(corpus[name]);
+      QVERIFY(score);
+      qint64 bytes = heapSize() - before;
+      QPair<qint64, qint64> pools = poolTotals();
+
+      int notes = 0;
+      for (Segment* s = score->firstSegment(Segment::Type::ChordRest); s; s = s->next1(Segment::Type::ChordRest)) {
+            for (Element* e : s->elist()) {
+                  if (e && e->isChord())
+                        notes += int(toChord(e)->notes().size());
+                  }
+            }
+      delete score;
+      QVERIFY(notes > 0);
+      record("memory", "bytes", bytes);
+      record("memory", "bytesPerNote", double(bytes) / notes);
+      record("memory", "sizeofElement", sizeof(Element));
+      record("memory", "sizeofNote", sizeof(Note));
+      record("memory", "pooledAllocations", pools.first - poolsBefore.first);
+      record("memory", "pooledChunkBytes", pools.second - poolsBefore.second);
+      }
+
+void TestBenchmarkSuite::save()
+      {
+      QFETCH(QString, name);
+      MasterScore* score = scores[name];
+      QString path = QString("bench-%1-save.mscz").arg(name);
+      measure("save", [this, score, path] {
+            QVERIFY(saveScore(score, path));
+            });
+      }
+
+//---------------------------------------------------------
+//   layout
+//---------------------------------------------------------
+
+void TestBenchmarkSuite::layoutFull()
+      {
+      QFETCH(QString, name);
+      MasterScore* score = scores[name];
+      measure("layoutFull", [score] {
+            for (Score* s : score->scoreList())
+                  s->doLayout();
+            });
+      }
+
+void TestBenchmarkSuite::layoutParallel()
+      {
+      QFETCH(QString, name);
+      MasterScore* score = scores[name];
+      MScore::parallelLayout = true;
+      measure("layoutParallel", [score] {
+            for (Score* s : score->scoreList())
+                  s->doLayout();
+            });
+      MScore::parallelLayout = false;
+      }
+
+void TestBenchmarkSuite::layoutRange()
+      {
+      QFETCH(QString, name);
+      MasterScore* score = scores[name];
+      Measure* m = score->tick2measure(score->lastMeasure()->tick() / 2);
+      QVERIFY(m);
+      int stick = m->tick();
+      int etick = m->endTick();
+      measure("layoutRange", [score, stick, etick] {
+            score->doLayoutRange(stick, etick);
+            });
+      }
+
+//---------------------------------------------------------
+//   layoutRangeLine
+//    range layout in continuous view; the measures must
+//    end up where a complete layout puts them
+//---------------------------------------------------------
+
+void TestBenchmarkSuite::layoutRangeLine()
+      {
+      QFETCH(QString, name);
+      MasterScore* score = scores[name];
+      Measure* m = score->tick2measure(score->lastMeasure()->tick() / 2);
+      QVERIFY(m);
+      int stick = m->tick();
+      int etick = m->endTick();
+      score->setLayoutMode(LayoutMode::LINE);
+      score->doLayout();
+      measure("layoutRangeLine", [score, stick, etick] {
+            score->doLayoutRange(stick, etick);
+            });
+
+      QList<QRectF> range;
+      for (Measure* mm = score->firstMeasure(); mm; mm = mm->nextMeasure())
+            range.append(QRectF(mm->pos(), QSizeF(mm->width(), 0.0)));
+      score->doLayout();
+      int i = 0;
+      for (Measure* mm = score->firstMeasure(); mm; mm = mm->nextMeasure(), ++i) {
+            QRectF full(mm->pos(), QSizeF(mm->width(), 0.0));
+            QVERIFY2(qAbs(full.x() - range[i].x()) < 0.01 && qAbs(full.width() - range[i].width()) < 0.01,
+               qPrintable(QString("measure %1").arg(mm->no() + 1)));
+            }
+      score->setLayoutMode(LayoutMode::PAGE);
+      score->doLayout();
+      }
+
+//---------------------------------------------------------
+//   createParts
+//    one linked part per instrument of a freshly loaded
+//    score, created with createExcerpts()
+//---------------------------------------------------------
+
+void TestBenchmarkSuite::createParts()
+      {
+      QFETCH(QString, name);
+      QString path       = corpus[name];
+      MasterScore* score = 0;
+      measure("createParts", [&score] {
+            QList<Excerpt*> excerpts = Excerpt::createAllExcerpt(score);
+            for (Excerpt* e : excerpts)
+                  e->setPartScore(new Score(score));
+            createExcerpts(excerpts);
+            for (Excerpt* e : excerpts) {
+                  e->partScore()->setName(e->title());
+                  score->undo(new AddExcerpt(e->partScore()));
+                  }
+            qDeleteAll(excerpts);
+            }, [this, &score, path] {
+            delete score;
+            score = readCreatedScore(path);
+            });
+      delete score;
+      }
+
+//---------------------------------------------------------
+//   noteEdit
+//    latency of a single undoable note change including
+//    the layout done by endCmd()
+//---------------------------------------------------------
+
+void TestBenchmarkSuite::noteEdit()
+      {
+      QFETCH(QString, name);
+      MasterScore* score = scores[name];
+      Chord* chord = firstChord(score);
+      QVERIFY(chord);
+      Note* note = chord->upNote();
+      int n = 0;
+      measure("noteEdit", [score, note, &n] {
+            int offset = (n++ % 2) ? -12 : 12;
+            score->startCmd();
+            score->undoChangePitch(note, note->pitch() + offset, note->tpc1(), note->tpc2());
+            score->endCmd();
+            });
+      }
+
+//---------------------------------------------------------
+//   renderMidi
+//---------------------------------------------------------
+
+void TestBenchmarkSuite::renderMidi()
+      {
+      QFETCH(QString, name);
+      MasterScore* score = scores[name];
+      measure("renderMidi", [score] {
+            EventMap events;
+            score->renderMidi(&events);
+            });
+      }
+
+//---------------------------------------------------------
+//   MusicXML
+//---------------------------------------------------------
+
+void TestBenchmarkSuite::exportMusicXml()
+      {
+      QFETCH(QString, name);
+      MasterScore* score = scores[name];
+      QString path = QString("bench-%1.xml").arg(name);
+      measure("exportMusicXml", [score, path] {
+            QVERIFY(saveXml(score, path));
+            });
+      }
+
+void TestBenchmarkSuite::importMusicXml()
+      {
+      QFETCH(QString, name);
+      QString path = QString("bench-%1-import.xml").arg(name);
+      QVERIFY(saveXml(scores[name], path));
+      measure("importMusicXml", [this, path] {
+            MasterScore* score = new MasterScore(mscore->baseStyle());
+            QCOMPARE(Ms::importMusicXml(score, path), Score::FileError::FILE_NO_ERROR);
+            score->doLayout();
+            delete score;
+            });
+      }
+
+//---------------------------------------------------------
+//   MIDI
+//---------------------------------------------------------
+
+void TestBenchmarkSuite::exportMidi()
+      {
+      QFETCH(QString, name);
+      MasterScore* score = scores[name];
+      QString path = QString("bench-%1.mid").arg(name);
+      measure("exportMidi", [score, path] {
+            ExportMidi em(score);
+            QVERIFY(em.write(path, true));
+            });
+      }
+
+void TestBenchmarkSuite::importMidi()
+      {
+      QFETCH(QString, name);
+      QString path = QDir::current().absoluteFilePath(QString("bench-%1-import.mid").arg(name));
+      ExportMidi em(scores[name]);
+      QVERIFY(em.write(path, true));
+      measure("importMidi", [this, path] {
+            MasterScore* score = new MasterScore(mscore->baseStyle());
+            QCOMPARE(Ms::importMidi(score, path), Score::FileError::FILE_NO_ERROR);
+            score->doLayout();
+            delete score;
+            }, [path] {
+            // don't reuse the results of the previous import
+            preferences.midiImportOperations.excludeMidiFile(path);
+            });
+      }
+
+//---------------------------------------------------------
+//   graphic export
+//---------------------------------------------------------
+
+void TestBenchmarkSuite::exportPdf()
+      {
+      QFETCH(QString, name);
+      MasterScore* score = scores[name];
+      QString path = QString("bench-%1.pdf").arg(name);
+      measure("exportPdf", [this, score, path] {
+            QVERIFY(savePdf(score, path));
+            });
+      }
+
+void TestBenchmarkSuite::exportPng()
+      {
+      QFETCH(QString, name);
+      MasterScore* score = scores[name];
+      measure("exportPng", [score, name] {
+            // the page loop of MuseScore::savePng() without its dialogs
+            score->setPrinting(true);
+            for (int i = 0; i < score->pages().size(); ++i) {
+                  QString path = QString("bench-%1-%2.png").arg(name).arg(i + 1);
+                  QVERIFY(savePngPage(score->pages().at(i), path, false, 300.0, -1, QImage::Format_ARGB32_Premultiplied));
+                  }
+            score->setPrinting(false);
+            });
+      }
+
+//---------------------------------------------------------
+//   saveSvg
+//    one file per page with the SVG export of MuseScore
+//    (preference svgOneFilePerPage); records the total
+//    file size
+//---------------------------------------------------------
+
+void TestBenchmarkSuite::saveSvg(const QString& operation, bool useSymbols)
+      {
+      QFETCH(QString, name);
+      MasterScore* score = scores[name];
+      const QString baseName = QString("bench-%1-%2").arg(name).arg(operation);
+      measure(operation, [score, baseName, useSymbols] {
+            QVERIFY(saveSvgPages(score, baseName, useSymbols));
+            });
+      qint64 bytes = 0;
+      for (const QFileInfo& fi : QDir::current().entryInfoList(QStringList(baseName + "-*.svg"), QDir::Files))
+            bytes += fi.size();
+      record(operation, "bytes", bytes);
+      }
+
+QTEST_MAIN(TestBenchmarkSuite)
+#include "tst_benchmarksuite.moc"
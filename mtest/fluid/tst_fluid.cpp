@@ -0,0 +1,310 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2016 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include <QtTest/QtTest>
+#include "mtest/testutils.h"
+#include "fluid/fluid.h"
+#include "fluid/renderpool.h"
+#include "fluid/dspkernels.h"
+#include "synthesizer/event.h"
+
+using namespace Ms;
+
+static const int SAMPLE_RATE = 44100;
+
+//---------------------------------------------------------
+//   TestFluid
+//---------------------------------------------------------
+
+class TestFluid : public QObject, public MTest
+      {
+      Q_OBJECT
+
+      QString soundFont;
+
+      FluidS::Fluid* createFluid(int threads);
+      void startVoices(FluidS::Fluid* fluid, int voices);
+      QVector<float> render(FluidS::Fluid* fluid, int blocks, unsigned frames);
+      bool realtime(FluidS::Fluid* fluid, int voices, unsigned frames);
+
+   private slots:
+      void initTestCase();
+      void dspKernels_data();
+      void dspKernels();
+      void parallelRender();
+      void polyphony_data();
+      void polyphony();
+      };
+
+//---------------------------------------------------------
+//   initTestCase
+//    the soundfont is not part of the source tree;
+//    MSCORE_SOUNDFONT overrides the default location
+//---------------------------------------------------------
+
+void TestFluid::initTestCase()
+      {
+      initMTest();
+      soundFont = QString::fromLocal8Bit(qgetenv("MSCORE_SOUNDFONT"));
+      if (soundFont.isEmpty())
+            soundFont = root + "/share/sound/FluidR3Mono_GM.sf3";
+      }
+
+//---------------------------------------------------------
+//   dspKernels
+//    the vector kernels against the scalar reference on
+//    random data; interpolation may differ by rounding of
+//    the gain, mixing must be exact
+//---------------------------------------------------------
+
+void TestFluid::dspKernels_data()
+      {
+      QTest::addColumn<int>("isa");
+      QTest::newRow("sse2") << int(FluidS::DspIsa::SSE2);
+      QTest::newRow("avx2") << int(FluidS::DspIsa::AVX2);
+      }
+
+void TestFluid::dspKernels()
+      {
+      QFETCH(int, isa);
+      const FluidS::DspKernels* kernels = FluidS::DspKernels::get(FluidS::DspIsa(isa));
+      if (!kernels)
+            QSKIP("not supported by this cpu");
+      const FluidS::DspKernels* scalar = FluidS::DspKernels::get(FluidS::DspIsa::SCALAR);
+
+      qsrand(42);
+      static float coeffs4[256][4];
+      static float coeffs7[256][7];
+      for (int i = 0; i < 256; ++i) {
+            for (int k = 0; k < 4; ++k)
+                  coeffs4[i][k] = float(qrand() % 2001 - 1000) / 1000.0f;
+            for (int k = 0; k < 7; ++k)
+                  coeffs7[i][k] = float(qrand() % 2001 - 1000) / 1000.0f;
+            }
+      QVector<short> data(20000);
+      for (short& v : data)
+            v = short(qrand() % 65536 - 32768);
+
+      const int MAX = 300;
+      float ref[MAX], buf[MAX];
+      for (int run = 0; run < 2000; ++run) {
+            unsigned count = qrand() % MAX + 1;
+            qint64 incr    = (qint64(qrand() % 4) << 32) + (qint64(qrand()) << 16) % (qint64(1) << 32);
+            qint64 phase   = (qint64(8 + qrand() % 1000) << 32) + quint32(qrand()) * 7919u;
+            double amp     = (qrand() % 1000) / 1000.0;
+            double ampIncr = (qrand() % 2001 - 1000) / 1e6;
+            for (int order : { 4, 7 }) {
+                  if (order == 4) {
+                        scalar->interpolate4(ref, count, data.constData(), phase, incr, amp, ampIncr, coeffs4);
+                        kernels->interpolate4(buf, count, data.constData(), phase, incr, amp, ampIncr, coeffs4);
+                        }
+                  else {
+                        scalar->interpolate7(ref, count, data.constData(), phase, incr, amp, ampIncr, coeffs7);
+                        kernels->interpolate7(buf, count, data.constData(), phase, incr, amp, ampIncr, coeffs7);
+                        }
+                  for (unsigned i = 0; i < count; ++i) {
+                        if (qAbs(buf[i] - ref[i]) > qAbs(ref[i]) * 1e-6f + 1e-6f)
+                              QFAIL(qPrintable(QString("order %1 run %2 sample %3: %4 != %5")
+                                 .arg(order).arg(run).arg(i).arg(buf[i]).arg(ref[i])));
+                        }
+                  }
+
+            float out[2][2 * MAX], reverb[2][2 * MAX], chorus[2][2 * MAX];
+            for (int i = 0; i < 2 * MAX; ++i) {
+                  out[0][i]    = out[1][i]    = float(qrand() % 1000);
+                  reverb[0][i] = reverb[1][i] = float(qrand() % 1000);
+                  chorus[0][i] = chorus[1][i] = float(qrand() % 1000);
+                  }
+            scalar->mix(ref, count, out[0], reverb[0], chorus[0], 0.3f, 0.7f, 0.2f, 0.1f);
+            kernels->mix(ref, count, out[1], reverb[1], chorus[1], 0.3f, 0.7f, 0.2f, 0.1f);
+            QVERIFY(memcmp(out[0], out[1], sizeof(out[0])) == 0);
+            QVERIFY(memcmp(reverb[0], reverb[1], sizeof(reverb[0])) == 0);
+            QVERIFY(memcmp(chorus[0], chorus[1], sizeof(chorus[0])) == 0);
+            }
+      }
+
+//---------------------------------------------------------
+//   createFluid
+//    strings on all melodic channels
+//---------------------------------------------------------
+
+FluidS::Fluid* TestFluid::createFluid(int threads)
+      {
+      FluidS::Fluid* fluid = new FluidS::Fluid();
+      fluid->init(SAMPLE_RATE);
+      if (!fluid->addSoundFont(soundFont)) {
+            delete fluid;
+            return 0;
+            }
+      fluid->setRenderThreads(threads);
+      for (int ch = 0; ch < 16; ++ch) {
+            if (ch != 9)
+                  fluid->play(PlayEvent(ME_CONTROLLER, ch, CTRL_PROGRAM, 48));
+            }
+      return fluid;
+      }
+
+//---------------------------------------------------------
+//   startVoices
+//    start sustained notes until the synthesizer plays
+//    at least the given number of voices
+//---------------------------------------------------------
+
+void TestFluid::startVoices(FluidS::Fluid* fluid, int voices)
+      {
+      for (int key = 36; key < 97; ++key) {
+            for (int ch = 0; ch < 16; ++ch) {
+                  if (fluid->activeVoiceCount() >= voices)
+                        return;
+                  if (ch != 9)
+                        fluid->play(PlayEvent(ME_NOTEON, ch, key, 40 + (key * 7 + ch * 13) % 80));
+                  }
+            }
+      }
+
+//---------------------------------------------------------
+//   render
+//    dry, reverb and chorus output of blocks, one after
+//    the other
+//---------------------------------------------------------
+
+QVector<float> TestFluid::render(FluidS::Fluid* fluid, int blocks, unsigned frames)
+      {
+      QVector<float> result;
+      std::vector<float> out(2 * frames), reverb(2 * frames), chorus(2 * frames);
+      for (int i = 0; i < blocks; ++i) {
+            std::fill(out.begin(), out.end(), 0.0f);
+            std::fill(reverb.begin(), reverb.end(), 0.0f);
+            std::fill(chorus.begin(), chorus.end(), 0.0f);
+            fluid->process(frames, out.data(), reverb.data(), chorus.data());
+            for (float v : out)
+                  result.append(v);
+            for (float v : reverb)
+                  result.append(v);
+            for (float v : chorus)
+                  result.append(v);
+            }
+      return result;
+      }
+
+//---------------------------------------------------------
+//   parallelRender
+//    the output does not depend on the number of render
+//    threads and matches the serial render up to the
+//    summation order
+//---------------------------------------------------------
+
+void TestFluid::parallelRender()
+      {
+      if (!QFileInfo(soundFont).exists())
+            QSKIP("no soundfont");
+
+      QVector<float> serial;
+      QVector<float> parallel;
+      for (int threads : { 0, 1, 3, 3 }) {
+            FluidS::Fluid* fluid = createFluid(threads);
+            QVERIFY(fluid);
+            startVoices(fluid, 300);
+            QVERIFY(fluid->activeVoiceCount() >= FluidS::RenderPool::MIN_VOICES);
+            QVector<float> r = render(fluid, 200, 256);
+            fluid->allNotesOff(-1);
+            r += render(fluid, 200, 256);
+            delete fluid;
+
+            if (threads == 0)
+                  serial = r;
+            else if (parallel.isEmpty())
+                  parallel = r;
+            else
+                  QVERIFY2(r == parallel, qPrintable(QString("%1 threads").arg(threads)));
+            }
+      QCOMPARE(parallel.size(), serial.size());
+      float peak = 0.0f;
+      float diff = 0.0f;
+      for (int i = 0; i < serial.size(); ++i) {
+            peak = qMax(peak, qAbs(serial[i]));
+            diff = qMax(diff, qAbs(serial[i] - parallel[i]));
+            }
+      QVERIFY(peak > 0.0f);
+      QVERIFY2(diff <= peak * 1e-5f, qPrintable(QString("difference %1, peak %2").arg(diff).arg(peak)));
+      }
+
+//---------------------------------------------------------
+//   realtime
+//    true if no block of one second of audio takes
+//    longer than 80% of the buffer period
+//---------------------------------------------------------
+
+bool TestFluid::realtime(FluidS::Fluid* fluid, int voices, unsigned frames)
+      {
+      fluid->allSoundsOff(-1);
+      startVoices(fluid, voices);
+      if (fluid->activeVoiceCount() < voices)
+            return false;
+
+      std::vector<float> out(2 * frames), reverb(2 * frames), chorus(2 * frames);
+      qint64 budget = qint64(frames) * 800000000LL / SAMPLE_RATE;    // ns
+      int blocks    = SAMPLE_RATE / frames;
+      QElapsedTimer timer;
+      for (int i = 0; i < blocks + 10; ++i) {
+            timer.start();
+            fluid->process(frames, out.data(), reverb.data(), chorus.data());
+            if (i >= 10 && timer.nsecsElapsed() > budget)         // first blocks warm up
+                  return false;
+            }
+      return true;
+      }
+
+//---------------------------------------------------------
+//   polyphony
+//    highest number of voices rendered without xrun per
+//    buffer size, on the audio thread only and with all
+//    cores
+//---------------------------------------------------------
+
+void TestFluid::polyphony_data()
+      {
+      QTest::addColumn<unsigned>("frames");
+      for (unsigned frames : { 64, 128, 256, 512, 1024 })
+            QTest::newRow(qPrintable(QString::number(frames))) << frames;
+      }
+
+void TestFluid::polyphony()
+      {
+      if (!QFileInfo(soundFont).exists())
+            QSKIP("no soundfont");
+      QFETCH(unsigned, frames);
+
+      QList<int> threadCounts = { 0 };
+      if (QThread::idealThreadCount() > 1)
+            threadCounts.append(QThread::idealThreadCount() - 1);
+      QString result;
+      for (int threads : threadCounts) {
+            FluidS::Fluid* fluid = createFluid(threads);
+            QVERIFY(fluid);
+            int lo = 0;             // highest passing multiple of 16
+            int hi = 512 / 16 + 1;  // lowest failing
+            while (hi - lo > 1) {
+                  int mid = (lo + hi) / 2;
+                  if (realtime(fluid, mid * 16, frames))
+                        lo = mid;
+                  else
+                        hi = mid;
+                  }
+            delete fluid;
+            result += QString(" %1 threads: %2 voices").arg(threads + 1).arg(lo * 16);
+            }
+      qDebug("%u frames:%s", frames, qPrintable(result));
+      }
+
+QTEST_MAIN(TestFluid)
+#include "tst_fluid.moc"
@@ -34,6 +34,7 @@
 #include "mscore/importmidi/importmidi_operations.h"
 #include "mscore/importmidi/importmidi_model.h"
 #include "mscore/importmidi/importmidi_lyrics.h"
+#include "mscore/importmidi/importmidi_cache.h"
 #include "mscore/preferences.h"
 
 
@@ -176,6 +177,7 @@ class TestImportMidi : public QObject, public MTest
       void findTupletApproximation();
       void separateTupletVoices();
       void findLongestUncommonGroup();
+      void fixedTicks();
 
       // metric bar analysis
       void metricDivisionsOfTuplet();
@@ -404,6 +406,10 @@ class TestImportMidi : public QObject, public MTest
 
       // gui - tracks model
       void testGuiTracksModel();
+      void reimportCache();
+      void tupletSearchLimit();
+      void tupletSearchNoDefaultLimit();
+      void tupletBenchmark();
       };
 
 //---------------------------------------------------------
@@ -814,6 +820,36 @@ void TestImportMidi::findLongestUncommonGroup()
       QVERIFY(result.size() == 1);
       }
 
+void TestImportMidi::fixedTicks()
+      {
+      const qint64 whole = FixedTicks::wholeNote();
+                  // regular and tuplet times are exact
+      QCOMPARE(FixedTicks(ReducedFraction(1, 4)).value(), whole / 4);
+      QCOMPARE(FixedTicks(ReducedFraction(1, 12)).value(), whole / 12);
+      QCOMPARE(FixedTicks(ReducedFraction(3, 7 * 128)).value(), whole * 3 / (7 * 128));
+      QCOMPARE(FixedTicks(ReducedFraction(5, 9 * 128)).value(), whole * 5 / (9 * 128));
+      QCOMPARE(FixedTicks(ReducedFraction::fromTicks(1)).value(), whole / (4 * MScore::division));
+      QVERIFY(FixedTicks::isOnGrid(ReducedFraction(1, 5 * 64)));
+      QVERIFY(!FixedTicks::isOnGrid(ReducedFraction(1, 11)));
+                  // round trip
+      const ReducedFraction f(-17, 3 * 32);
+      QVERIFY(FixedTicks(f).fraction().isIdenticalTo(f));
+      QVERIFY(FixedTicks().fraction().isIdenticalTo(ReducedFraction(0, 1)));
+                  // arithmetic and comparison match fractions
+      const ReducedFraction a(2, 3);
+      const ReducedFraction b(5, 7);
+      QVERIFY((FixedTicks(a) + FixedTicks(b)).fraction() == a + b);
+      QVERIFY((FixedTicks(a) - FixedTicks(b)).fraction() == a - b);
+      QVERIFY((FixedTicks(a) - FixedTicks(b)).absValue() == FixedTicks((b - a).reduced()));
+      QVERIFY(FixedTicks(a) < FixedTicks(b));
+      QCOMPARE(FixedTicks(a).toDouble(), a.toDouble());
+                  // far beyond the int range of fraction numerators on that grid
+      FixedTicks sum;
+      for (int i = 0; i != 10000; ++i)
+            sum += FixedTicks(ReducedFraction(1, 1));
+      QCOMPARE(sum.value(), whole * 10000);
+      }
+
 //--------------------------------------------------------------------------
       // tuplet voice separation
 
@@ -1199,8 +1235,169 @@ void TestImportMidi::testGuiTracksModel()
       QCOMPARE(model.flags(model.index(0, channelCol)), notEditableFlags);
       }
 
+//---------------------------------------------------------
+//   reimportCache
+//    repeated import with the same operations reuses
+//    stored per-track results and gives the same score,
+//    changed operations don't
+//---------------------------------------------------------
+
+void TestImportMidi::reimportCache()
+      {
+      const QString midiFile("m3");
+      const QString midiFileFullPath = midiFilePath(midiFile);
+      auto &opers = preferences.midiImportOperations;
+      opers.addNewMidiFile(midiFileFullPath);
+      MidiOperations::CurrentMidiFileSetter setCurrentMidiFile(opers, midiFileFullPath);
+      MidiCache::TrackCache *cache = opers.data()->trackCache.get();
+      QVERIFY(cache);
+
+      MasterScore score1(mscore->baseStyle());
+      score1.setName(midiFile);
+      QCOMPARE(importMidi(&score1, midiFileFullPath), Score::FileError::FILE_NO_ERROR);
+      const int hits = cache->hits();
+      const int misses = cache->misses();
+
+      MasterScore score2(mscore->baseStyle());
+      score2.setName(midiFile);
+      QCOMPARE(importMidi(&score2, midiFileFullPath), Score::FileError::FILE_NO_ERROR);
+      QVERIFY(cache->hits() > hits);
+      QCOMPARE(cache->misses(), misses);
+
+      QVERIFY(saveScore(&score1, "m3-reimport1.mscx"));
+      QVERIFY(saveScore(&score2, "m3-reimport2.mscx"));
+      QFile file1("m3-reimport1.mscx");
+      QFile file2("m3-reimport2.mscx");
+      QVERIFY(file1.open(QIODevice::ReadOnly));
+      QVERIFY(file2.open(QIODevice::ReadOnly));
+      QVERIFY(file1.readAll() == file2.readAll());
+
+      auto &quantValue = opers.data()->trackOpers.quantValue;
+      const auto oldQuantValue = quantValue.value(0);
+      quantValue.setValue(0, MidiOperations::QuantValue::Q_64);
+
+      MasterScore score3(mscore->baseStyle());
+      score3.setName(midiFile);
+      QCOMPARE(importMidi(&score3, midiFileFullPath), Score::FileError::FILE_NO_ERROR);
+      QVERIFY(cache->misses() > misses);
+
+      quantValue.setValue(0, oldQuantValue);
+      }
+
+//---------------------------------------------------------
+//   tupletSearchLimit
+//    tuplet search that exceeds its node limit
+//    still gives a valid result
+//---------------------------------------------------------
+
+void TestImportMidi::tupletSearchLimit()
+      {
+      const QString midiFile("tuplet_3_5_7_tuplets");
+      const QString midiFileFullPath = midiFilePath(midiFile);
+      auto &opers = preferences.midiImportOperations;
+      if (!opers.hasMidiFile(midiFileFullPath))
+            opers.addNewMidiFile(midiFileFullPath);
+      MidiOperations::CurrentMidiFileSetter setCurrentMidiFile(opers, midiFileFullPath);
+      auto &data = *opers.data();
+      const MidiOperations::TupletSearchLimits oldLimits = data.tupletSearchLimits;
+
+      data.trackCache->clear();
+      MasterScore score1(mscore->baseStyle());
+      score1.setName(midiFile);
+      QCOMPARE(importMidi(&score1, midiFileFullPath), Score::FileError::FILE_NO_ERROR);
+      const qint64 nodes = data.diagnostics->tupletSearchNodes;
+      QVERIFY(nodes > 0);
+      QCOMPARE(int(data.diagnostics->tupletSearchLimitReached), 0);
+
+      data.tupletSearchLimits.maxNodes = 1;
+      MasterScore score2(mscore->baseStyle());
+      score2.setName(midiFile);
+      QCOMPARE(importMidi(&score2, midiFileFullPath), Score::FileError::FILE_NO_ERROR);
+      QVERIFY(data.diagnostics->tupletSearchLimitReached > 0);
+      QVERIFY(data.diagnostics->tupletSearchNodes < nodes);
+
+      data.tupletSearchLimits = oldLimits;
+      }
+
+//---------------------------------------------------------
+//   tupletSearchNoDefaultLimit
+//    a file whose search would be cut by a node limit
+//    is imported unchanged with the default limits
+//---------------------------------------------------------
+
+void TestImportMidi::tupletSearchNoDefaultLimit()
+      {
+      const QString midiFile("tuplet_3_5_7_tuplets");
+      const QString midiFileFullPath = midiFilePath(midiFile);
+      auto &opers = preferences.midiImportOperations;
+      if (!opers.hasMidiFile(midiFileFullPath))
+            opers.addNewMidiFile(midiFileFullPath);
+      MidiOperations::CurrentMidiFileSetter setCurrentMidiFile(opers, midiFileFullPath);
+      auto &data = *opers.data();
+      const MidiOperations::TupletSearchLimits oldLimits = data.tupletSearchLimits;
+
+      data.trackOpers.changeClef.setDefaultValue(false, false);
+      data.trackOpers.doStaffSplit.setDefaultValue(false, false);
+      data.trackOpers.simplifyDurations.setDefaultValue(false, false);
+      data.trackOpers.showTempoText.setDefaultValue(false);
+
+      data.tupletSearchLimits = MidiOperations::TupletSearchLimits();
+      QCOMPARE(data.tupletSearchLimits.maxNodes, 0);
+      QCOMPARE(data.tupletSearchLimits.maxTimeMs, 0);
+      data.trackCache->clear();
+      mf(midiFile.toStdString().c_str());
+      QCOMPARE(int(data.diagnostics->tupletSearchLimitReached), 0);
+      const qint64 maxBarNodes = data.diagnostics->tupletSearchMaxBarNodes;
+      QVERIFY(maxBarNodes > 1);
+
+                  // the file hits a cap just below its largest bar search
+      data.tupletSearchLimits.maxNodes = int(maxBarNodes - 1);
+      MasterScore score(mscore->baseStyle());
+      score.setName(midiFile);
+      QCOMPARE(importMidi(&score, midiFileFullPath), Score::FileError::FILE_NO_ERROR);
+      QVERIFY(data.diagnostics->tupletSearchLimitReached > 0);
+
+                  // without the cap the output is the exact search result again
+      data.tupletSearchLimits = oldLimits;
+      mf(midiFile.toStdString().c_str());
+      QCOMPARE(int(data.diagnostics->tupletSearchLimitReached), 0);
+      }
+
+//---------------------------------------------------------
+//   tupletBenchmark
+//    import of the tuplet test files,
+//    stored per-track results are not used
+//---------------------------------------------------------
+
+void TestImportMidi::tupletBenchmark()
+      {
+      const char *files[] = {
+            "tuplet_2_voices_3_5_tuplets",
+            "tuplet_3_5_7_tuplets",
+            "tuplet_5_5_tuplets_rests",
+            "tuplet_mars",
+            "tuplet_nonuplet_4-4",
+            "tuplet_tied_3_5_tuplets",
+            "tuplet_triplets_mixed",
+            "voice_tuplet"
+            };
+      auto &opers = preferences.midiImportOperations;
+
+      QBENCHMARK {
+            for (const char *file: files) {
+                  const QString path = midiFilePath(file);
+                  if (!opers.hasMidiFile(path))
+                        opers.addNewMidiFile(path);
+                  MidiOperations::CurrentMidiFileSetter setCurrentMidiFile(opers, path);
+                  opers.data()->trackCache->clear();
+
+                  MasterScore score(mscore->baseStyle());
+                  score.setName(file);
+                  QCOMPARE(importMidi(&score, path), Score::FileError::FILE_NO_ERROR);
+                  }
+            }
+      }
 
 QTEST_MAIN(TestImportMidi)
 
 #include "tst_importmidi.moc"
-
@@ -14,6 +14,10 @@
 #include <QtTest/QtTest>
 #include "mtest/testutils.h"
 #include "libmscore/score.h"
+#include "libmscore/beam.h"
+#include "libmscore/chordrest.h"
+#include "libmscore/segment.h"
+#include "libmscore/undo.h"
 
 #define DIR QString("libmscore/beam/")
 
@@ -42,6 +46,7 @@ class TestBeam : public QObject, public MTest
       void beam23()  { beam("Beam-23.mscx"); }
       void beamS0()  { beam("Beam-S0.mscx"); }
       void beamDir() { beam("Beam-dir.mscx"); }
+      void beamDragUndo();
       };
 
 //---------------------------------------------------------
@@ -66,6 +71,50 @@ void TestBeam::beam(const char* path)
       delete score;
       }
 
+//---------------------------------------------------------
+//   beamDragUndo
+//    dragging a beam lays out the ties of its chords but
+//    records only the beam properties for undo
+//---------------------------------------------------------
+
+void TestBeam::beamDragUndo()
+      {
+      MasterScore* score = readScore(DIR + "Beam-A.mscx");
+      QVERIFY(score);
+      score->doLayout();
+
+      Beam* beam = 0;
+      for (Segment* s = score->firstSegment(Segment::Type::ChordRest); s && !beam; s = s->next1(Segment::Type::ChordRest)) {
+            ChordRest* cr = s->cr(0);
+            if (cr && cr->beam())
+                  beam = cr->beam();
+            }
+      QVERIFY(beam);
+
+      score->startCmd();
+      beam->startEdit(0, beam->pagePos());
+      int commands = score->undoStack()->current()->childCount();
+
+      EditData ed;
+      ed.view    = 0;
+      ed.curGrip = Grip::END;
+      ed.delta   = QPointF(0.0, score->spatium() * .25);
+      ed.hRaster = false;
+      ed.vRaster = false;
+      for (int i = 0; i < 10; ++i) {
+            beam->editDrag(ed);
+            score->layoutSpanner(beam);
+            }
+      QCOMPARE(score->undoStack()->current()->childCount(), commands);
+
+      beam->endEdit();
+      score->endCmd();
+      score->undoStack()->undo();
+      score->doLayout();
+      QVERIFY(saveCompareScore(score, "Beam-drag-undo.mscx", DIR + "Beam-A.mscx"));
+      delete score;
+      }
+
 QTEST_MAIN(TestBeam)
 #include "tst_beam.moc"
 
@@ -39,6 +39,8 @@ class TestLinks : public QObject, public MTest
       void test3LinkedParts_99796();
       void test4LinkedParts_94911();
       void test5LinkedParts_94911();
+      void uniqueElements();
+      void batchedPropertyChange();
       };
 
 //---------------------------------------------------------
@@ -449,6 +451,123 @@ void TestLinks::test5LinkedParts_94911()
       }
 
 
+//---------------------------------------------------------
+//   uniqueElements
+///  Create a 1 staff score, add 2 linked staves, select all
+///  Only one of every group of linked elements is unique
+//---------------------------------------------------------
+
+void TestLinks::uniqueElements()
+      {
+      MCursor c;
+      c.setTimeSig(Fraction(4,4));
+      c.createScore("test");
+      c.addPart("voice");
+      c.move(0, 0);     // move to track 0 tick 0
+
+      c.addKeySig(Key(1));
+      c.addTimeSig(Fraction(4,4));
+      c.addChord(60, TDuration(TDuration::DurationType::V_QUARTER));
+      c.addChord(62, TDuration(TDuration::DurationType::V_QUARTER));
+      c.addChord(64, TDuration(TDuration::DurationType::V_HALF));
+
+      Score* score = c.score();
+      score->startCmd();
+      Staff* oStaff = score->staff(0);
+      for (int i = 1; i < 3; ++i) {
+            Staff* staff = new Staff(score);
+            staff->setPart(oStaff->part());
+            score->undoInsertStaff(staff, i);
+            cloneStaff(oStaff, staff);
+            }
+      score->endCmd();
+      score->doLayout();
+
+      score->cmdSelectAll();
+      const QList<Element*>& el = score->selection().elements();
+      QList<Element*> unique    = score->selection().uniqueElements();
+      QVERIFY(!unique.isEmpty());
+      QVERIFY(unique.size() < el.size());
+
+      QSet<Element*> seen;
+      for (Element* e : unique) {
+            QVERIFY(!seen.contains(e));
+            seen.insert(e);
+            if (e->links()) {
+                  for (ScoreElement* se : *e->links()) {
+                        if (se != e)
+                              QVERIFY(!unique.contains(static_cast<Element*>(se)));
+                        }
+                  }
+            }
+      // every selected element is unique or linked to a unique one
+      for (Element* e : el) {
+            bool found = unique.contains(e);
+            if (!found && e->links()) {
+                  for (ScoreElement* se : *e->links())
+                        found = found || unique.contains(static_cast<Element*>(se));
+                  }
+            QVERIFY(found);
+            }
+      QCOMPARE(score->selection().uniqueNotes().size(), 3);
+      }
+
+//---------------------------------------------------------
+//   batchedPropertyChange
+///  Create a 1 staff score with 2 linked staves, change the
+///  color of the notes of all staves in one undo command
+//---------------------------------------------------------
+
+void TestLinks::batchedPropertyChange()
+      {
+      MCursor c;
+      c.setTimeSig(Fraction(4,4));
+      c.createScore("test");
+      c.addPart("voice");
+      c.move(0, 0);     // move to track 0 tick 0
+
+      c.addKeySig(Key(1));
+      c.addTimeSig(Fraction(4,4));
+      for (int pitch : { 60, 62, 64, 65 })
+            c.addChord(pitch, TDuration(TDuration::DurationType::V_QUARTER));
+
+      Score* score = c.score();
+      score->startCmd();
+      Staff* oStaff = score->staff(0);
+      for (int i = 1; i < 3; ++i) {
+            Staff* staff = new Staff(score);
+            staff->setPart(oStaff->part());
+            score->undoInsertStaff(staff, i);
+            cloneStaff(oStaff, staff);
+            }
+      score->endCmd();
+      score->doLayout();
+
+      score->cmdSelectAll();
+      QList<Element*> notes;
+      for (Element* e : score->selection().elements()) {
+            if (e->isNote())
+                  notes.append(e);
+            }
+      QCOMPARE(notes.size(), 12);
+
+      // the linked copies are in the list too and changed once
+      score->startCmd();
+      int commands = score->undoStack()->current()->childCount();
+      score->undoChangeProperty(notes, P_ID::COLOR, QColor(Qt::red));
+      QCOMPARE(score->undoStack()->current()->childCount(), commands + 1);
+      score->endCmd();
+      for (Element* e : notes)
+            QCOMPARE(e->color(), QColor(Qt::red));
+
+      score->undo()->undo();
+      for (Element* e : notes)
+            QCOMPARE(e->color(), MScore::defaultColor);
+      score->undo()->redo();
+      for (Element* e : notes)
+            QCOMPARE(e->color(), QColor(Qt::red));
+      }
+
 QTEST_MAIN(TestLinks)
 #include "tst_links.moc"
 
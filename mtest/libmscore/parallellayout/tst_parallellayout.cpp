@@ -0,0 +1,114 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2016 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include <QtTest/QtTest>
+#include "mtest/testutils.h"
+#include "libmscore/score.h"
+#include "libmscore/element.h"
+
+using namespace Ms;
+
+//---------------------------------------------------------
+//   LayoutItem
+//---------------------------------------------------------
+
+struct LayoutItem {
+      const char* name;
+      QRectF rect;            // bbox in page coordinates
+      };
+
+//---------------------------------------------------------
+//   TestParallelLayout
+//---------------------------------------------------------
+
+class TestParallelLayout : public QObject, public MTest
+      {
+      Q_OBJECT
+
+      QVector<LayoutItem> layout(const QString& path, bool parallel);
+
+   private slots:
+      void initTestCase();
+      void cleanup()          { MScore::parallelLayout = false; }
+      void vtest_data();
+      void vtest();
+      };
+
+//---------------------------------------------------------
+//   initTestCase
+//---------------------------------------------------------
+
+void TestParallelLayout::initTestCase()
+      {
+      initMTest();
+      }
+
+//---------------------------------------------------------
+//   collectItem
+//---------------------------------------------------------
+
+static void collectItem(void* data, Element* e)
+      {
+      static_cast<QVector<LayoutItem>*>(data)->append({ e->name(), e->bbox().translated(e->pagePos()) });
+      }
+
+//---------------------------------------------------------
+//   layout
+//    load a score in serial or parallel layout mode and
+//    return the position of all elements
+//---------------------------------------------------------
+
+QVector<LayoutItem> TestParallelLayout::layout(const QString& path, bool parallel)
+      {
+      QVector<LayoutItem> items;
+      MScore::parallelLayout = parallel;
+      MasterScore* score = readCreatedScore(path);
+      if (!score)
+            return items;
+      score->scanElements(&items, collectItem);
+      delete score;
+      return items;
+      }
+
+//---------------------------------------------------------
+//   vtest
+//    the parallel layout of the visual test scores
+//    matches the serial layout
+//---------------------------------------------------------
+
+void TestParallelLayout::vtest_data()
+      {
+      QTest::addColumn<QString>("path");
+      QDir dir(root + "/../vtest");
+      for (const QFileInfo& fi : dir.entryInfoList({ "*.mscz" }, QDir::Files, QDir::Name))
+            QTest::newRow(qPrintable(fi.completeBaseName())) << fi.absoluteFilePath();
+      }
+
+void TestParallelLayout::vtest()
+      {
+      QFETCH(QString, path);
+      QVector<LayoutItem> serial   = layout(path, false);
+      QVector<LayoutItem> parallel = layout(path, true);
+      QVERIFY(!serial.isEmpty());
+      QCOMPARE(parallel.size(), serial.size());
+      for (int i = 0; i < serial.size(); ++i) {
+            if (parallel[i].rect != serial[i].rect)
+                  QFAIL(qPrintable(QString("%1 %2: (%3 %4 %5 %6) != (%7 %8 %9 %10)").arg(serial[i].name).arg(i)
+                     .arg(parallel[i].rect.x()).arg(parallel[i].rect.y())
+                     .arg(parallel[i].rect.width()).arg(parallel[i].rect.height())
+                     .arg(serial[i].rect.x()).arg(serial[i].rect.y())
+                     .arg(serial[i].rect.width()).arg(serial[i].rect.height())));
+            }
+      }
+
+QTEST_MAIN(TestParallelLayout)
+#include "tst_parallellayout.moc"
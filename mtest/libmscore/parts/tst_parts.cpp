@@ -61,6 +61,8 @@ class TestParts : public QObject, public MTest
 
       void createPart1();
       void createPart2();
+      void createAllParts();
+      void createAllPartsRegistered();
 
       void createPartBreath();
       void addBreath();
@@ -299,6 +301,83 @@ void TestParts::createPart2()
       testPartCreation("part-all");
       }
 
+//---------------------------------------------------------
+//   createAllParts
+//    createExcerpts() gives the same parts as createExcerpt()
+//    for one part after the other
+//---------------------------------------------------------
+
+void TestParts::createAllParts()
+      {
+      MasterScore* score = readScore(DIR + "part-all.mscx");
+      QVERIFY(score);
+
+      QList<Excerpt*> excerpts;
+      for (int i = 0; i < 2; ++i) {
+            Part* part  = score->parts().at(i);
+            Excerpt* ex = new Excerpt(score);
+            ex->setPartScore(new Score(score));
+            ex->setTitle(part->longName());
+            ex->setParts(QList<Part*>() << part);
+            excerpts.append(ex);
+            }
+      createExcerpts(excerpts);
+      for (Excerpt* ex : excerpts) {
+            ex->partScore()->setName(ex->parts().front()->partName());
+            score->undo(new AddExcerpt(ex->partScore()));
+            }
+      qDeleteAll(excerpts);
+
+      QVERIFY(saveCompareScore(score, "part-all-allparts.mscx", DIR + "part-all-parts.mscx"));
+      delete score;
+      }
+
+//---------------------------------------------------------
+//   createAllPartsRegistered
+//    the part scores are added to the score before
+//    createExcerpts() inserts the title frame, as in
+//    MuseScore::newFile(); every part gets one title frame,
+//    linked to the one of the score
+//---------------------------------------------------------
+
+void TestParts::createAllPartsRegistered()
+      {
+      MasterScore* score = readScore(DIR + "part-all.mscx");
+      QVERIFY(score);
+      MeasureBase* title = score->first();
+      QVERIFY(title && title->type() == Element::Type::VBOX);
+      score->measures()->remove(title);
+      delete title;
+
+      QList<Excerpt*> excerpts;
+      for (int i = 0; i < 2; ++i) {
+            Part* part  = score->parts().at(i);
+            Excerpt* ex = new Excerpt(score);
+            ex->setPartScore(new Score(score));
+            ex->setTitle(part->longName());
+            ex->setParts(QList<Part*>() << part);
+            score->excerpts().append(ex);
+            excerpts.append(ex);
+            }
+      createExcerpts(excerpts);
+
+      title = score->first();
+      QVERIFY(title && title->type() == Element::Type::VBOX);
+      for (Excerpt* ex : excerpts) {
+            Score* ps = ex->partScore();
+            int frames = 0;
+            for (MeasureBase* mb = ps->first(); mb; mb = mb->next()) {
+                  if (mb->type() == Element::Type::VBOX)
+                        ++frames;
+                  }
+            QCOMPARE(frames, 1);
+            QCOMPARE(ps->measures()->size(), score->measures()->size());
+            QVERIFY(ps->first()->type() == Element::Type::VBOX);
+            QVERIFY(ps->first()->links() && ps->first()->links()->contains(title));
+            }
+      delete score;
+      }
+
 void TestParts::createPartBreath()
       {
       testPartCreation("part-breath");
@@ -14,6 +14,7 @@
 #include <QtTest/QtTest>
 
 #include "libmscore/text.h"
+#include "libmscore/textlayoutcache.h"
 #include "libmscore/score.h"
 #include "libmscore/sym.h"
 #include "libmscore/xml.h"
@@ -38,6 +39,7 @@ class TestText : public QObject, public MTest
       void testCompatibility();
       void testDelete();
       void testReadWrite();
+      void testLayoutCache();
       };
 
 //---------------------------------------------------------
@@ -417,6 +419,45 @@ void TestText::testReadWrite() {
       testrw(score, text);
 }
 
+//---------------------------------------------------------
+//   testLayoutCache
+//    identical texts share one cached layout
+//---------------------------------------------------------
+
+void TestText::testLayoutCache()
+      {
+      TextLayoutCache* cache = TextLayoutCache::instance();
+      cache->clear();
+      cache->resetStatistics();
+
+      Text* t1 = new Text(score);
+      t1->setTextStyle(score->textStyle(TextStyleType::DYNAMICS));
+      t1->setXmlText("<b>cresc.</b> poco <sym>dynamicForte</sym>");
+      t1->layout();
+      QCOMPARE(cache->misses(), 1);
+      QCOMPARE(cache->inserts(), 1);
+
+      Text* t2 = new Text(score);
+      t2->setTextStyle(score->textStyle(TextStyleType::DYNAMICS));
+      t2->setXmlText("<b>cresc.</b> poco <sym>dynamicForte</sym>");
+      t2->layout();
+      QCOMPARE(cache->hits(), 1);
+      QCOMPARE(t1->bbox(), t2->bbox());
+      QCOMPARE(t1->plainText(), t2->plainText());
+
+      // a different style must not hit the cache
+      Text* t3 = new Text(score);
+      t3->setTextStyle(score->textStyle(TextStyleType::TITLE));
+      t3->setXmlText("<b>cresc.</b> poco <sym>dynamicForte</sym>");
+      t3->layout();
+      QCOMPARE(cache->hits(), 1);
+      QCOMPARE(cache->misses(), 2);
+
+      delete t1;
+      delete t2;
+      delete t3;
+      }
+
 QTEST_MAIN(TestText)
 
 #include "tst_text.moc"
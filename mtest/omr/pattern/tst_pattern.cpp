@@ -0,0 +1,172 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2016 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include <QtTest/QtTest>
+#include "mtest/testutils.h"
+#include "omr/pattern.h"
+
+using namespace Ms;
+
+//---------------------------------------------------------
+//   ModelPattern
+//    pattern with a random model
+//---------------------------------------------------------
+
+class ModelPattern : public Pattern {
+   public:
+      ModelPattern(int r, int c)
+            {
+            rows  = r;
+            cols  = c;
+            model = new float*[rows];
+            for (int y = 0; y < rows; ++y) {
+                  model[y] = new float[cols];
+                  for (int x = 0; x < cols; ++x)
+                        model[y][x] = float(qrand() % 1001) / 1000.0f;
+                  }
+            }
+      ~ModelPattern()
+            {
+            for (int y = 0; y < rows; ++y)
+                  delete[] model[y];
+            delete[] model;
+            }
+
+      //---------------------------------------------------
+      //   pixelMatch
+      //    the reference per pixel scorer
+      //---------------------------------------------------
+
+      double pixelMatch(const QImage* img, int col, int row, double bg_parm) const
+            {
+            double k = 0;
+            if (bg_parm < 0.00001)
+                  bg_parm = 0.00001;
+            if (bg_parm > 0.99999)
+                  bg_parm = 0.99999;
+            double log_bg_black = log(bg_parm);
+            double log_bg_white = log(1.0-bg_parm);
+            for (int y = 0; y < rows; ++y) {
+                  for (int x = 0; x < cols; x++) {
+                        if (col+x >= img->size().width() || row+y >= img->size().height())
+                              continue;
+                        QRgb c = img->pixel(col+x, row+y);
+                        bool black = (qGray(c) < 125);
+                        double bs_scr = model[y][x];
+                        if (bs_scr < 0.00001)
+                              bs_scr = 0.00001;
+                        if (bs_scr > 0.99999)
+                              bs_scr = 0.99999;
+                        double log_black = log(bs_scr) - log_bg_black;
+                        double log_white = log(1.0 - bs_scr) - log_bg_white;
+                        k += black?log_black:log_white;
+                        }
+                  }
+            return k;
+            }
+      };
+
+//---------------------------------------------------------
+//   TestPattern
+//---------------------------------------------------------
+
+class TestPattern : public QObject, public MTest
+      {
+      Q_OBJECT
+
+      QImage randomImage(int w, int h, int percentBlack);
+
+   private slots:
+      void initTestCase();
+      void match_data();
+      void match();
+      };
+
+//---------------------------------------------------------
+//   initTestCase
+//---------------------------------------------------------
+
+void TestPattern::initTestCase()
+      {
+      initMTest();
+      qsrand(1);
+      }
+
+//---------------------------------------------------------
+//   randomImage
+//    a page image as created by Pdf::binarization()
+//---------------------------------------------------------
+
+QImage TestPattern::randomImage(int w, int h, int percentBlack)
+      {
+      QImage img(w, h, QImage::Format_MonoLSB);
+      QVector<QRgb> ct(2);
+      ct[0] = qRgb(255, 255, 255);
+      ct[1] = qRgb(0, 0, 0);
+      img.setColorTable(ct);
+      img.fill(0);
+      for (int y = 0; y < h; ++y) {
+            for (int x = 0; x < w; ++x) {
+                  if (qrand() % 100 < percentBlack)
+                        img.setPixel(x, y, 1);
+                  }
+            }
+      return img;
+      }
+
+//---------------------------------------------------------
+//   match
+//    the packed scorer gives the same score as the pixel
+//    scorer; pruned candidates stay below the threshold
+//---------------------------------------------------------
+
+void TestPattern::match_data()
+      {
+      QTest::addColumn<int>("rows");
+      QTest::addColumn<int>("cols");
+      QTest::addColumn<int>("percentBlack");
+
+      QTest::newRow("notehead") << 21 << 21 << 20;
+      QTest::newRow("dense")    << 21 << 21 << 60;
+      QTest::newRow("wide")     << 9  << 64 << 30;
+      QTest::newRow("odd")      << 13 << 37 << 5;
+      }
+
+void TestPattern::match()
+      {
+      QFETCH(int, rows);
+      QFETCH(int, cols);
+      QFETCH(int, percentBlack);
+
+      ModelPattern pattern(rows, cols);
+      QImage img = randomImage(203, 101, percentBlack);
+      double bg = percentBlack / 100.0;
+      PatternLikelihood likelihood(&pattern, bg);
+      const double thresholds[] = { -HUGE_VAL, -50.0, 0.0, 50.0 };
+
+      for (int row = -2; row < img.height() + 2; row += 3) {
+            for (int col = -3; col < img.width() + 2; ++col) {
+                  double ref = pattern.pixelMatch(&img, col, row, bg);
+                  QVERIFY(pattern.match(&img, col, row, bg) == ref);
+                  for (double threshold : thresholds) {
+                        double val = likelihood.match(&img, col, row, threshold);
+                        if (ref > threshold)
+                              QVERIFY(val == ref);
+                        else
+                              QVERIFY(val <= threshold);
+                        }
+                  }
+            }
+      }
+
+QTEST_MAIN(TestPattern)
+#include "tst_pattern.moc"
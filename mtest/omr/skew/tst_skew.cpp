@@ -0,0 +1,163 @@
+//=============================================================================
+//  MuseScore
+//  Music Composition & Notation
+//
+//  Copyright (C) 2016 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2
+//  as published by the Free Software Foundation and appearing in
+//  the file LICENCE.GPL
+//=============================================================================
+
+#include <QtTest/QtTest>
+#include "mtest/testutils.h"
+#include "omr/omr.h"
+#include "omr/skew.h"
+
+using namespace Ms;
+
+//---------------------------------------------------------
+//   TestSkew
+//    compare SkewEstimator with the full radon transform
+//    on a rotated staff with note heads and noise
+//---------------------------------------------------------
+
+class TestSkew : public QObject, public MTest
+      {
+      Q_OBJECT
+
+      QImage staffImage(double angle, int width, int height);
+      void angles();
+
+   private slots:
+      void initTestCase();
+      void skew_data()        { angles(); }
+      void skew();
+      void benchRadon_data()  { angles(); }
+      void benchRadon();
+      void benchEstimator_data() { angles(); }
+      void benchEstimator();
+      };
+
+//---------------------------------------------------------
+//   initTestCase
+//---------------------------------------------------------
+
+void TestSkew::initTestCase()
+      {
+      initMTest();
+      Omr omr(score);         // initializes Omr::bitsSetTable
+      }
+
+//---------------------------------------------------------
+//   angles
+//---------------------------------------------------------
+
+void TestSkew::angles()
+      {
+      QTest::addColumn<double>("angle");
+      QTest::addColumn<int>("width");
+
+      QTest::newRow("0")      << 0.0  << 1654;
+      QTest::newRow("0.3")    << 0.3  << 1654;
+      QTest::newRow("-0.7")   << -0.7 << 1190;
+      QTest::newRow("1.5")    << 1.5  << 2048;
+      QTest::newRow("-2.8")   << -2.8 << 1654;
+      QTest::newRow("5")      << 5.0  << 1190;
+      }
+
+//---------------------------------------------------------
+//   staffImage
+//    a 1-bit image as created by Pdf::binarization()
+//---------------------------------------------------------
+
+QImage TestSkew::staffImage(double angle, int width, int height)
+      {
+      QImage img(width, height, QImage::Format_MonoLSB);
+      QVector<QRgb> ct(2);
+      ct[0] = qRgb(255, 255, 255);
+      ct[1] = qRgb(0, 0, 0);
+      img.setColorTable(ct);
+      img.fill(0);
+
+      double t = tan(angle * M_PI / 180.0);
+      auto set = [&](int x, int y) {
+            y += lrint((x - width / 2) * t);
+            if (x >= 0 && y >= 0 && x < width && y < height)
+                  img.setPixel(x, y, 1);
+            };
+      int top = height / 2 - 30;
+      for (int x = 50; x < width - 50; ++x) {
+            for (int line = 0; line < 5; ++line) {
+                  set(x, top + line * 15);
+                  set(x, top + line * 15 + 1);
+                  }
+            }
+      qsrand(1);
+      for (int i = 0; i < 60; ++i) {
+            int cx = 60 + qrand() % (width - 120);
+            int cy = top - 20 + qrand() % 100;
+            for (int dx = -6; dx <= 6; ++dx) {
+                  for (int dy = -5; dy <= 5; ++dy) {
+                        if (dx * dx * 25 + dy * dy * 36 < 900)
+                              set(cx + dx, cy + dy);
+                        }
+                  }
+            for (int dy = 0; dy < 45; ++dy)
+                  set(cx + 6, cy - dy);
+            }
+      for (int i = 0; i < 3000; ++i)
+            set(qrand() % width, qrand() % height);
+      return img;
+      }
+
+//---------------------------------------------------------
+//   skew
+//    OmrPage::deSkew() rotates by the returned angle, so
+//    it is the negated skew of the image
+//---------------------------------------------------------
+
+void TestSkew::skew()
+      {
+      QFETCH(double, angle);
+      QFETCH(int, width);
+
+      QImage img = staffImage(angle, width, 300);
+      QRect r(0, 0, width, img.height());
+      SkewEstimator estimator;
+      double radon = SkewEstimator::radonSkew(img, r);
+      double val   = estimator.skew(img, r);
+
+      QVERIFY(qAbs(radon + angle) < 0.1);
+      QVERIFY(qAbs(val + angle) < 0.1);
+      QVERIFY(qAbs(val - radon) < 0.1);
+      }
+
+void TestSkew::benchRadon()
+      {
+      QFETCH(double, angle);
+      QFETCH(int, width);
+
+      QImage img = staffImage(angle, width, 300);
+      QRect r(0, 0, width, img.height());
+      QBENCHMARK {
+            SkewEstimator::radonSkew(img, r);
+            }
+      }
+
+void TestSkew::benchEstimator()
+      {
+      QFETCH(double, angle);
+      QFETCH(int, width);
+
+      QImage img = staffImage(angle, width, 300);
+      QRect r(0, 0, width, img.height());
+      SkewEstimator estimator;
+      QBENCHMARK {
+            estimator.skew(img, r);
+            }
+      }
+
+QTEST_MAIN(TestSkew)
+#include "tst_skew.moc"
@@ -16,6 +16,7 @@
 #include "libmscore/mscore.h"
 #include "libmscore/musescoreCore.h"
 #include "libmscore/undo.h"
+#include "libmscore/note.h"
 #include "mscore/qmlplugin.h"
 
 #define DIR QString("scripting/")
@@ -42,6 +43,7 @@ class TestScripting : public QObject, public MTest
       void plugins01();
       void plugins02();
       void testTextStyle();
+      void deletedElement();
       void test1() { read1("s1", "p1"); }       // scan note rest
       void test2() { read1("s2", "p2"); }       // scan segment attributes
       };
@@ -164,6 +166,38 @@ void TestScripting::testTextStyle()
       delete item;
       }
 
+//---------------------------------------------------------
+///   deletedElement
+///   A script reference to a deleted element must not see the
+///   element which is allocated next, usually at the same
+///   address of the element pool.
+//---------------------------------------------------------
+
+void TestScripting::deletedElement()
+      {
+      MasterScore* score = readScore(DIR + "s1.mscx");
+      QVERIFY(score);
+      QQmlEngine* engine = Ms::MScore::qml();
+
+      Note* note = new Note(score);
+      note->setPitch(60);
+      QQmlEngine::setObjectOwnership(note, QQmlEngine::CppOwnership);
+      QJSValue value = engine->newQObject(note);
+      QCOMPARE(value.property("pitch").toInt(), 60);
+
+      delete note;
+      Note* note2 = new Note(score);
+      note2->setPitch(72);
+      QQmlEngine::setObjectOwnership(note2, QQmlEngine::CppOwnership);
+
+      QVERIFY(value.toQObject() == 0);
+      QVERIFY(value.property("pitch").isUndefined());
+      QVERIFY(!engine->newQObject(note2).strictlyEquals(value));
+
+      delete note2;
+      delete score;
+      }
+
 //---------------------------------------------------------
 //   read1
 //   read a score, apply script and compare script output with
@@ -29,6 +29,7 @@
 #endif
 #include "utils.h"
 #include "pattern.h"
+#include "libmscore/trace.h"
 
 namespace Ms {
 
@@ -55,7 +56,7 @@ Omr::Omr(Score* s)
 #ifdef OCR
       _ocr = 0;
 #endif
-      ActionNames = QList<QString>() << QWidget::tr("Loading PDF") << QWidget::tr("Initializing Staves") << QWidget::tr("Identifying Systems");
+      ActionNames = QList<QString>() << QWidget::tr("Loading PDF") << QWidget::tr("Initializing Staves") << QWidget::tr("Load Parameters") << QWidget::tr("Identifying Systems");
       initUtils();
       }
 
@@ -138,6 +139,15 @@ int Omr::pagesInDocument() const
 //---------------------------------------------------------
 //   readPdf
 //    return true on success
+//
+//    The pages are processed in a pipeline: poppler renders
+//    one page after the other in the calling thread while
+//    the rendered pages are binarized, deskewed and scaled
+//    in the global thread pool. After the common parameters
+//    are computed, the systems of all pages are identified
+//    in parallel again. Every page only touches its own
+//    OmrPage, so the result is the same as processing the
+//    pages in order.
 //---------------------------------------------------------
 
 bool Omr::readPdf()
@@ -145,125 +155,171 @@ bool Omr::readPdf()
       QProgressDialog *progress = new QProgressDialog(QWidget::tr("Reading PDF..."), QWidget::tr("Cancel"), 0, 100, 0, Qt::FramelessWindowHint);
       progress->setWindowModality(Qt::ApplicationModal);
       progress->show();
-      progress->setRange(0, ACTION_NUM);
 
 #ifdef OCR
       if (_ocr == 0)
             _ocr = new Ocr;
       _ocr->init();
 #endif
-      int ID = READ_PDF;
-      int page = 0;
-      bool val;
-      while (ID < ACTION_NUM) {
-            if(ID != INIT_PAGE && ID != SYSTEM_IDENTIFICATION) {
-                  page = 0;
-                  progress->setLabelText(QWidget::tr("%1 at Page %2").arg(ActionNames.at(ID+1)).arg(1));
-                  val = omrActions(ID, page);
-                  }
-            else {
-                  progress->setLabelText(QWidget::tr("%1 at Page %2").arg(ActionNames.at(ID)).arg(page+1));
-                  val = omrActions(ID, page);
-                  page++;
-                  }
-
-            if (!val || progress->wasCanceled()) {
-                  progress->close();
-                  return false;
-                  }
-            else {
-                  if (ID < ACTION_NUM)
-                        progress->setValue(ID);
-                  else
-                        progress->setValue(ACTION_NUM - 1);
-                  qApp->processEvents();
-                  }
-            }
+      bool ok = readPdf(progress);
       progress->close();
       delete progress;
-      return true;
+      return ok;
       }
 
 //---------------------------------------------------------
-//   actions
+//   waitForPages
+//    wait for the page jobs while keeping the progress
+//    dialog alive; return false if canceled
 //---------------------------------------------------------
 
-bool Omr::omrActions(int &ID, int page)
+bool Omr::waitForPages(QProgressDialog* progress, QList<QFuture<void>>& futures, ActionID id, int base)
       {
-      if(ID == READ_PDF) {
-            _doc = new Pdf();
-            if (!_doc->open(_path)) {
-                  delete _doc;
-                  _doc = 0;
-                  return false;
+      for (;;) {
+            int done = 0;
+            for (const QFuture<void>& f : futures) {
+                  if (f.isFinished())
+                        ++done;
                   }
-            int n = _doc->numPages();
-            printf("readPdf: %d pages\n", n);
-            for (int i = 0; i < n; ++i) {
-                  OmrPage* page = new OmrPage(this);
-                  QImage image = _doc->page(i);
-                  if (image.isNull())
-                        return false;
-                  page->setImage(image);
-                  _pages.append(page);
+            progress->setLabelText(QWidget::tr("%1: page %2 of %3").arg(ActionNames.at(id)).arg(done).arg(_pages.size()));
+            progress->setValue(base + done);
+            if (done == futures.size())
+                  return true;
+            if (progress->wasCanceled()) {
+                  for (QFuture<void>& f : futures)
+                        f.waitForFinished();
+                  return false;
                   }
+            qApp->processEvents(QEventLoop::AllEvents, 20);
+            QThread::msleep(20);
+            }
+      }
 
-            _spatium = 15.0; //constant spatium, image will be rescaled according to this parameter
-            ID++;
-            return true;
+bool Omr::readPdf(QProgressDialog* progress)
+      {
+      //
+      // READ_PDF, INIT_PAGE
+      //
+      progress->setLabelText(QWidget::tr("%1 at Page %2").arg(ActionNames.at(READ_PDF)).arg(1));
+      qApp->processEvents();
+      _doc = new Pdf();
+      if (!_doc->open(_path)) {
+            delete _doc;
+            _doc = 0;
+            return false;
             }
-      else if(ID == INIT_PAGE) {
-            //load one page and rescale
-            _pages[page]->read();
-
-            //do the rescaling here
-            int new_w = _pages[page]->image().width() * _spatium/_pages[page]->spatium();
-            int new_h = _pages[page]->image().height() * _spatium/_pages[page]->spatium();
-            QImage image = _pages[page]->image().scaled(new_w,new_h, Qt::KeepAspectRatio);
-            _pages[page]->setImage(image);
-            _pages[page]->read();
-
-            if(page == _pages.size()-1)
-                  ID++;
-            return true;
+      int n = _doc->numPages();
+      qDebug("readPdf: %d pages", n);
+      _spatium = 15.0; //constant spatium, image will be rescaled according to this parameter
+
+      // progress: n pages rendered, n pages initialized,
+      // parameters, n pages with identified systems
+      progress->setRange(0, 3 * n + 1);
+
+      QList<QFuture<void>> futures;
+      bool ok = true;
+      for (int i = 0; i < n; ++i) {
+            progress->setLabelText(QWidget::tr("%1 at Page %2").arg(ActionNames.at(READ_PDF)).arg(i + 1));
+            QImage image;
+            {
+            TRACE_SPAN_ARG("renderPdfPage", "omr", "page", i);
+            image = _doc->render(i);
             }
-      else if(ID == FINALIZE_PARMS) {
-            int n = _pages.size();
-            double w = 0;
-            for (int i = 0; i < n; ++i) {
-                  w  += _pages[i]->width();
+            if (image.isNull() || progress->wasCanceled()) {
+                  ok = false;
+                  break;
                   }
-            w       /= n;
-            _dpmm    = w / 210.0;            // PaperSize A4
-
-            quartheadPattern  = new Pattern(_score, "solid_note_head");
-            halfheadPattern   = new Pattern(_score, SymId::noteheadHalf,  _spatium);
-            sharpPattern      = new Pattern(_score, SymId::accidentalSharp, _spatium);
-            flatPattern       = new Pattern(_score, SymId::accidentalFlat, _spatium);
-            naturalPattern    = new Pattern(_score, SymId::accidentalNatural,_spatium);
-            trebleclefPattern = new Pattern(_score, SymId::gClef,_spatium);
-            bassclefPattern   = new Pattern(_score, SymId::fClef,_spatium);
-            timesigPattern[0] = new Pattern(_score, SymId::timeSig0, _spatium);
-            timesigPattern[1] = new Pattern(_score, SymId::timeSig1, _spatium);
-            timesigPattern[2] = new Pattern(_score, SymId::timeSig2, _spatium);
-            timesigPattern[3] = new Pattern(_score, SymId::timeSig3, _spatium);
-            timesigPattern[4] = new Pattern(_score, SymId::timeSig4, _spatium);
-            timesigPattern[5] = new Pattern(_score, SymId::timeSig5, _spatium);
-            timesigPattern[6] = new Pattern(_score, SymId::timeSig6, _spatium);
-            timesigPattern[7] = new Pattern(_score, SymId::timeSig7, _spatium);
-            timesigPattern[8] = new Pattern(_score, SymId::timeSig8, _spatium);
-            timesigPattern[9] = new Pattern(_score, SymId::timeSig9, _spatium);
-
-            ID++;
-            return true;
-
+            OmrPage* page = new OmrPage(this);
+            _pages.append(page);
+            futures.append(QtConcurrent::run([this, page, image, i]() { initPage(page, image, i); }));
+            progress->setValue(i + 1);
+            qApp->processEvents();
+            }
+      if (!ok) {
+            for (QFuture<void>& f : futures)
+                  f.waitForFinished();
+            return false;
             }
-      else if(ID == SYSTEM_IDENTIFICATION) {
-            _pages[page]->identifySystems();
-            if(page == _pages.size()-1) ID++;
-            return true;
+      if (!waitForPages(progress, futures, INIT_PAGE, n))
+            return false;
+
+      //
+      // FINALIZE_PARMS
+      //
+      progress->setLabelText(ActionNames.at(FINALIZE_PARMS));
+      finalizeParms();
+      progress->setValue(2 * n + 1);
+      qApp->processEvents();
+
+      //
+      // SYSTEM_IDENTIFICATION
+      //
+      futures.clear();
+      for (int i = 0; i < n; ++i) {
+            OmrPage* page = _pages[i];
+            futures.append(QtConcurrent::run([page, i]() {
+                  TRACE_SPAN_ARG("identifySystems", "omr", "page", i);
+                  page->identifySystems();
+                  }));
+            }
+      return waitForPages(progress, futures, SYSTEM_IDENTIFICATION, 2 * n + 1);
+      }
+
+//---------------------------------------------------------
+//   initPage
+//    binarize, deskew and rescale one rendered page;
+//    runs in a worker thread
+//---------------------------------------------------------
+
+void Omr::initPage(OmrPage* page, const QImage& image, int idx)
+      {
+      TRACE_SPAN_ARG("initPage", "omr", "page", idx);
+      page->setImage(Pdf::binarization(image));
+
+      //load one page and rescale
+      page->read();
+
+      //do the rescaling here
+      int new_w = page->image().width() * _spatium / page->spatium();
+      int new_h = page->image().height() * _spatium / page->spatium();
+      QImage scaled = page->image().scaled(new_w, new_h, Qt::KeepAspectRatio);
+      page->setImage(scaled);
+      page->read();
+      }
+
+//---------------------------------------------------------
+//   finalizeParms
+//    compute the parameters common to all pages and
+//    create the patterns
+//---------------------------------------------------------
+
+void Omr::finalizeParms()
+      {
+      int n = _pages.size();
+      double w = 0;
+      for (int i = 0; i < n; ++i) {
+            w  += _pages[i]->width();
             }
-      return false;
+      w       /= n;
+      _dpmm    = w / 210.0;            // PaperSize A4
+
+      quartheadPattern  = new Pattern(_score, "solid_note_head");
+      halfheadPattern   = new Pattern(_score, SymId::noteheadHalf,  _spatium);
+      sharpPattern      = new Pattern(_score, SymId::accidentalSharp, _spatium);
+      flatPattern       = new Pattern(_score, SymId::accidentalFlat, _spatium);
+      naturalPattern    = new Pattern(_score, SymId::accidentalNatural,_spatium);
+      trebleclefPattern = new Pattern(_score, SymId::gClef,_spatium);
+      bassclefPattern   = new Pattern(_score, SymId::fClef,_spatium);
+      timesigPattern[0] = new Pattern(_score, SymId::timeSig0, _spatium);
+      timesigPattern[1] = new Pattern(_score, SymId::timeSig1, _spatium);
+      timesigPattern[2] = new Pattern(_score, SymId::timeSig2, _spatium);
+      timesigPattern[3] = new Pattern(_score, SymId::timeSig3, _spatium);
+      timesigPattern[4] = new Pattern(_score, SymId::timeSig4, _spatium);
+      timesigPattern[5] = new Pattern(_score, SymId::timeSig5, _spatium);
+      timesigPattern[6] = new Pattern(_score, SymId::timeSig6, _spatium);
+      timesigPattern[7] = new Pattern(_score, SymId::timeSig7, _spatium);
+      timesigPattern[8] = new Pattern(_score, SymId::timeSig8, _spatium);
+      timesigPattern[9] = new Pattern(_score, SymId::timeSig9, _spatium);
       }
 
 //---------------------------------------------------------
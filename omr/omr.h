@@ -58,6 +58,11 @@ class Omr {
       enum ActionID { READ_PDF, INIT_PAGE, FINALIZE_PARMS, SYSTEM_IDENTIFICATION, ACTION_NUM};
       QList<QString>ActionNames;
 
+      bool readPdf(QProgressDialog*);
+      bool waitForPages(QProgressDialog*, QList<QFuture<void>>&, ActionID, int base);
+      void initPage(OmrPage*, const QImage&, int idx);
+      void finalizeParms();
+
 public:
       Omr(Score*);
       Omr(const QString& path, Score*);
@@ -105,7 +110,6 @@ public:
       const QString& path() const {
             return _path;
             }
-      bool omrActions(int &ID, int page = 0);
 
       static Pattern* quartheadPattern;
       static Pattern* halfheadPattern;
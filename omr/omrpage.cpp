@@ -32,6 +32,7 @@
 #include "libmscore/sym.h"
 #include "libmscore/note.h"
 #include "pattern.h"
+#include "skew.h"
 
 namespace Ms {
     //static const double noteTH = 1.0;
@@ -1270,8 +1271,9 @@ void OmrPage::deSkew()
       uint* db = new uint[wl * h];
       memset(db, 0, wl * h * sizeof(uint));
 
+      SkewEstimator estimator;
       foreach(const QRect& r, _slices) {
-            double rot = skew(r);
+            double rot = estimator.skew(_image, r);
             if (qAbs(rot) < 0.1) {
                   memcpy(db + wl * r.y(), scanLine(r.y()), wl * r.height() * sizeof(uint));
                   continue;
@@ -1578,9 +1580,10 @@ void OmrSystem::searchNotes(QList<OmrNote*>* noteList, int x1, int x2, int y, in
       double val;
       int step_size = 2;
       int note_thresh = 50;
+      PatternLikelihood likelihood(pattern, _page->ratio());
 
       for (int x = x1; x < (x2 - hw); x += step_size) {
-            val = pattern->match(&_page->image(), x, y - hh / 2, _page->ratio());
+            val = likelihood.match(&_page->image(), x, y - hh / 2, note_thresh);
             if (val > note_thresh) {
                   notePeaks.append(Peak(x, val, 0));
                   }
@@ -204,13 +204,11 @@ class OmrPage {
       void removeBorder();
       void crop();
       void slice();
-      double skew(const QRect&);
       void deSkew();
       void getStaffLines();
       void getRatio();
       double xproject2(int y);
       int xproject(const uint* p, int wl);
-      void radonTransform(ulong* projection, int w, int n, const QRect&);
       OmrTimesig* searchTimeSig(OmrSystem* system);
       OmrClef searchClef(OmrSystem* system, OmrStaff* staff);
       void searchKeySig(OmrSystem* system, OmrStaff* staff);
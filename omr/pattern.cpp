@@ -75,70 +75,210 @@ double Pattern::match(const QImage*, int , int) const
 
 double Pattern::match(const QImage* img, int col, int row, double bg_parm) const
       {
-#if 0
-      double scr = 0;
-      for (int y = 0; y < rows; ++y) {
-            for (int x = 0; x < cols; x++) {
-                  if(col+x >= img->size().width() || row+y >= img->size().height()) continue;
-                  QRgb c = img->pixel(col+x, row+y);
-                  bool black = (qGray(c) < 125);
-                  scr += black ? 1 : 0;
-                  }
-            }
-      return scr;
-#endif
-      double k = 0;
-      
-      //return k;
+      return PatternLikelihood(this, bg_parm).match(img, col, row);
+      }
+
+//---------------------------------------------------------
+//   PatternLikelihood
+//---------------------------------------------------------
+
+PatternLikelihood::PatternLikelihood(const Pattern* pattern, double bg_parm)
+      {
+      _rows = pattern->rows;
+      _cols = pattern->cols;
+
       if (bg_parm < 0.00001)
             bg_parm = 0.00001;
       if (bg_parm > 0.99999)
             bg_parm = 0.99999;
-            
       double log_bg_black = log(bg_parm);
-      double log_bg_white = log(1.0-bg_parm);
-      
-      for (int y = 0; y < rows; ++y) {
-            for (int x = 0; x < cols; x++) {
-                  if (col+x >= img->size().width() || row+y >= img->size().height())
-                        continue;
-                  QRgb c = img->pixel(col+x, row+y);
-                  bool black = (qGray(c) < 125);
+      double log_bg_white = log(1.0 - bg_parm);
+
+      _black.resize(_rows * _cols);
+      _white.resize(_rows * _cols);
+      _bound.assign(_rows + 1, 0.0);
+      _whiteSum.assign(_rows, 0.0);
+      _maxGain.assign(_rows, 0.0);
+      _gainMask.assign(_rows, 0);
+      std::vector<double> rowMax(_rows, 0.0);
 
-                  double bs_scr = model[y][x];
+      for (int y = 0; y < _rows; ++y) {
+            for (int x = 0; x < _cols; ++x) {
+                  double bs_scr = pattern->model[y][x];
                   if (bs_scr < 0.00001)
                         bs_scr = 0.00001;
                   if (bs_scr > 0.99999)
                         bs_scr = 0.99999;
-                  
-                  double log_black = log(bs_scr) - log_bg_black;
-                  double log_white = log(1.0 - bs_scr) - log_bg_white;
-                  
-                  k += black?log_black:log_white;
-                  
+                  double b = log(bs_scr) - log_bg_black;
+                  double w = log(1.0 - bs_scr) - log_bg_white;
+                  _black[y * _cols + x] = b;
+                  _white[y * _cols + x] = w;
+
+                  _whiteSum[y] += w;
+                  if (b > w) {
+                        _maxGain[y] = qMax(_maxGain[y], b - w);
+                        if (x < 64)
+                              _gainMask[y] |= quint64(1) << x;
+                        }
+                  // pixels outside of the image are skipped and score 0
+                  rowMax[y] += qMax(0.0, qMax(b, w));
                   }
             }
-      return k;
-#if 0
-      for (int x = 0; x < bytes; ++x) {
-            uchar a = *p1++;
-            uchar b1 = *p2;
-            uchar b2 = *(p2 + 1);
-            p2++;
-            uchar b  = (b1 >> shift) | (b2 << (7 - shift));
-            uchar v = a ^ b;
-            k += Omr::bitsSetTable[v];
-            }
-      uchar a = *p1++;
-      uchar b1 = *p2;
-      uchar b2 = *(p2 + 1) & (0xff << eshift);
-      uchar b  = (b1 >> shift) | (b2 << (7 - shift));
-      uchar v = a ^ b;
-      k += Omr::bitsSetTable[v];
+      for (int y = _rows - 1; y >= 0; --y)
+            _bound[y] = _bound[y + 1] + rowMax[y];
       }
+
+//---------------------------------------------------------
+//   popcount
+//---------------------------------------------------------
+
+static inline int popcount(quint64 v)
+      {
+#if defined(__GNUC__)
+      return __builtin_popcountll(v);
+#else
+      int n = 0;
+      for (; v; v >>= 8)
+            n += Omr::bitsSetTable[v & 0xff];
+      return n;
 #endif
+      }
+
+//---------------------------------------------------------
+//   lowBits
+//---------------------------------------------------------
+
+static inline quint64 lowBits(int n)
+      {
+      return n >= 64 ? ~quint64(0) : (quint64(1) << n) - 1;
+      }
 
-      
+//---------------------------------------------------------
+//   scanBits
+//    return the n <= 64 pixels x..x+n-1 of a Format_MonoLSB
+//    scanline as bits 0..n-1; x + n must not exceed the
+//    image width
+//---------------------------------------------------------
+
+static inline quint64 scanBits(const uchar* line, int x, int n)
+      {
+      if (n <= 0)
+            return 0;
+      const uchar* p = line + (x >> 3);
+      int shift      = x & 7;
+      int bytes      = (shift + n + 7) >> 3;      // at most 9
+      quint64 v      = 0;
+      for (int i = qMin(bytes, 8) - 1; i >= 0; --i)
+            v = (v << 8) | p[i];
+      v >>= shift;
+      if (bytes > 8)
+            v |= quint64(p[8]) << (64 - shift);
+      return v & lowBits(n);
+      }
+
+//---------------------------------------------------------
+//   match
+//    score the pattern at col, row of img; same result as
+//    summing the log-likelihood ratio of every pixel:
+//    pixels right of or below the image are skipped, pixels
+//    left of or above it count as black (QImage::pixel()
+//    returns a dark dummy color there).
+//
+//    Candidates which can not score above threshold are
+//    pruned: first by a bound from the popcount of the
+//    black pixels per row, then row by row while summing.
+//    For a pruned candidate some value <= threshold is
+//    returned.
+//---------------------------------------------------------
+
+static const double PRUNE_EPS = 1e-6;     // margin for rounding of the bounds
+
+double PatternLikelihood::match(const QImage* img, int col, int row, double threshold) const
+      {
+      if (_cols > 64 || (img->format() != QImage::Format_MonoLSB))
+            return matchPixels(img, col, row, threshold);
+
+      const int width  = img->width();
+      const int height = img->height();
+      bool blackIsOne  = img->colorCount() < 2 || qGray(img->color(1)) < 125;
+      bool blackIsZero = img->colorCount() >= 1 && qGray(img->color(0)) < 125;
+
+      auto rowBits = [&](int y, quint64* valid) -> quint64 {
+            int n     = qMin(_cols, width - col);     // pixels inside on the right
+            *valid    = n > 0 ? lowBits(n) : 0;
+            if (n <= 0)
+                  return 0;
+            if (y < 0)
+                  return *valid;
+            int lead  = qMin(n, qMax(0, -col));       // pixels left of the image
+            quint64 v = scanBits(img->constScanLine(y), col + lead, n - lead);
+            if (blackIsOne != blackIsZero) {
+                  if (blackIsZero)
+                        v = ~v & lowBits(n - lead);
+                  }
+            else
+                  v = blackIsOne ? lowBits(n - lead) : 0;
+            return (v << lead) | lowBits(lead);
+            };
+
+      //
+      // coarse: bound the score from the number of black
+      // pixels which can raise it
+      //
+      if (threshold > -HUGE_VAL && col >= 0 && row >= 0 && col + _cols <= width && row + _rows <= height) {
+            double bound = 0.0;
+            for (int y = 0; y < _rows; ++y) {
+                  quint64 valid;
+                  quint64 bits = rowBits(row + y, &valid);
+                  bound += _whiteSum[y] + popcount(bits & _gainMask[y]) * _maxGain[y];
+                  }
+            if (bound + PRUNE_EPS <= threshold)
+                  return bound;
+            }
+
+      //
+      // fine: sum in the order of the pixel scorer, so the
+      // result is bit identical
+      //
+      double k = 0.0;
+      for (int y = 0; y < _rows; ++y) {
+            if (row + y >= height)
+                  break;
+            quint64 valid;
+            quint64 bits   = rowBits(row + y, &valid);
+            const double* b = &_black[y * _cols];
+            const double* w = &_white[y * _cols];
+            for (int x = 0; x < _cols; ++x) {
+                  if (!((valid >> x) & 1))
+                        break;
+                  k += ((bits >> x) & 1) ? b[x] : w[x];
+                  }
+            if (k + _bound[y + 1] + PRUNE_EPS <= threshold)
+                  return k + _bound[y + 1];
+            }
+      return k;
+      }
+
+//---------------------------------------------------------
+//   matchPixels
+//    slow path for images which are not 1-bit
+//---------------------------------------------------------
+
+double PatternLikelihood::matchPixels(const QImage* img, int col, int row, double threshold) const
+      {
+      double k = 0.0;
+      for (int y = 0; y < _rows; ++y) {
+            for (int x = 0; x < _cols; x++) {
+                  if (col+x >= img->size().width() || row+y >= img->size().height())
+                        continue;
+                  QRgb c = img->pixel(col+x, row+y);
+                  bool black = (qGray(c) < 125);
+                  k += black ? _black[y * _cols + x] : _white[y * _cols + x];
+                  }
+            if (k + _bound[y + 1] + PRUNE_EPS <= threshold)
+                  return k + _bound[y + 1];
+            }
+      return k;
       }
 
 //---------------------------------------------------------
@@ -27,6 +27,31 @@ namespace Ms {
 
 enum class SymId;
 class Sym;
+class Pattern;
+
+//---------------------------------------------------------
+//   PatternLikelihood
+//    log-likelihood ratio tables of a model pattern for
+//    one background black ratio; computed once and then
+//    matched against the 1-bit scanlines of a page
+//---------------------------------------------------------
+
+class PatternLikelihood {
+      int _rows;
+      int _cols;
+      std::vector<double> _black;         // score of a black pixel, per cell
+      std::vector<double> _white;         // score of a white pixel, per cell
+      std::vector<double> _bound;         // max score of rows y..rows-1
+      std::vector<double> _whiteSum;      // score of an all white row
+      std::vector<double> _maxGain;       // max of black - white in a row
+      std::vector<quint64> _gainMask;     // cells with black > white
+
+      double matchPixels(const QImage* img, int col, int row, double threshold) const;
+
+   public:
+      PatternLikelihood(const Pattern* pattern, double bg_parm);
+      double match(const QImage* img, int col, int row, double threshold = -HUGE_VAL) const;
+      };
 
 //---------------------------------------------------------
 //   Pattern
@@ -35,6 +60,8 @@ class Sym;
 
 class Pattern {
    protected:
+      friend class PatternLikelihood;
+
       QImage _image;
       SymId _id;
       QPoint _base;
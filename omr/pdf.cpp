@@ -130,6 +130,19 @@ QImage Pdf::binarization(QImage image){
 //---------------------------------------------------------
 
 QImage Pdf::page(int i)
+      {
+      QImage image = render(i);
+      if (image.isNull())
+            return image;
+      return binarization(image);
+      }
+
+//---------------------------------------------------------
+//   render
+//    render page i with poppler, not binarized
+//---------------------------------------------------------
+
+QImage Pdf::render(int i)
       {
       QImage image;
       // Paranoid safety check
@@ -147,7 +160,7 @@ QImage Pdf::page(int i)
       // the size can be decided more intelligently
       image = pdfPage->renderToImage(scale*72.0, scale*72.0, 0, 0, scale*size.width(), scale*size.height());
       delete pdfPage;
-      return binarization(image);
+      return image;
       }
 }
 
@@ -44,7 +44,8 @@ class Pdf {
 
       int numPages() const;
       QImage page(int);
-      QImage binarization(QImage image);
+      QImage render(int);
+      static QImage binarization(QImage image);
       };
 }
 
@@ -22,6 +22,7 @@
 #include "utils.h"
 #include "omr.h"
 #include "omrpage.h"
+#include "skew.h"
 
 namespace Ms {
 
@@ -124,53 +125,45 @@ static void radonProjection(RadonInfo* src, RadonInfo* dst, int sign, ulong* pro
       }
 
 //---------------------------------------------------------
-//   radonTransform
+//   radonSkew
+//    compute image skew angle with a full radon transform;
+//    the former OmrPage::skew(), kept as reference for
+//    SkewEstimator::skew()
 //---------------------------------------------------------
 
-void OmrPage::radonTransform(ulong* projection, int w, int n, const QRect& r)
+double SkewEstimator::radonSkew(const QImage& image, const QRect& r)
       {
+      int nn    = ((image.bytesPerLine() + 3) / 4) * 4;
+      int width = 1;
+      for (; width < nn; width <<= 1)
+            ;
+      int n = 2 * width - 1;
       int h = r.height();
-      RadonInfo* src = new RadonInfo(w, h);
-      RadonInfo* dst = new RadonInfo(w, h);
+
+      ulong* projection = new ulong[n];
+      RadonInfo* src = new RadonInfo(width, h);
+      RadonInfo* dst = new RadonInfo(width, h);
 
       src->reset();
       for (int y = 0; y < h; y++) {
-            int i = n;
-            const uchar* p = (const uchar*)scanLine(r.y() + y);
-            for (int x = 0; x < n; ++x)
+            int i = nn;
+            const uchar* p = image.constScanLine(r.y() + y);
+            for (int x = 0; x < nn; ++x)
                   src->setCell(--i, y, Omr::bitsSetTable[*p++]);
             }
       radonProjection(src, dst, -1, projection);
 
       src->reset();
       for (int y = 0; y < h; y++) {
-            const uchar* p = (const uchar*)scanLine(r.y() + y);
-            for (int x = 0; x < n; ++x)
+            const uchar* p = image.constScanLine(r.y() + y);
+            for (int x = 0; x < nn; ++x)
                   src->setCell(x, y, Omr::bitsSetTable[*p++]);
             }
       radonProjection(src, dst, 1, projection);
 
       delete dst;
       delete src;
-      }
-
-//---------------------------------------------------------
-//   skew
-//    compute image skew angle
-//---------------------------------------------------------
-
-double OmrPage::skew(const QRect& r)
-      {
-//      Benchmark bench("imageSkew");
-
-      int nn    = wordsPerLine() * 4;
-      int width = 1;
-      for (; width < nn; width <<= 1)
-            ;
-      int n = 2 * width - 1;
 
-      ulong* projection = new ulong[n];
-      radonTransform(projection, width, nn, r);
       uint max_projection = 0;
       int skew            = 0;
       for (int i = 0; i < n; i++) {
@@ -182,5 +175,154 @@ double OmrPage::skew(const QRect& r)
       delete[] projection;
       return RadiansToDegrees(-atan((double) skew/width/8));
       }
-}
 
+//---------------------------------------------------------
+//   bin
+//    sum _counts over bins of bytes x rows into _binned
+//---------------------------------------------------------
+
+void SkewEstimator::bin(int bytesPerLine, int h, int bytes, int rows)
+      {
+      int n  = (bytesPerLine + bytes - 1) / bytes;
+      int bh = (h + rows - 1) / rows;
+      _binned.assign(n * bh, 0);
+      for (int x = 0; x < bytesPerLine; ++x) {
+            const quint16* s = &_counts[x * h];
+            quint16* d       = &_binned[(x / bytes) * bh];
+            if (rows == 1) {
+                  for (int y = 0; y < h; ++y)
+                        d[y] += s[y];
+                  }
+            else {
+                  for (int y = 0; y < h; y += rows) {
+                        int sum = 0;
+                        for (int i = y; i < qMin(h, y + rows); ++i)
+                              sum += s[i];
+                        *d++ += sum;
+                        }
+                  }
+            }
+      }
+
+//---------------------------------------------------------
+//   score
+//    sharpness of the row projection of n columns of
+//    h cells when column j is shifted up by
+//    shift * x / _width rows, x being the byte position
+//    of the column center; same criterion as the radon
+//    transform: sum of the squared differences of
+//    adjacent rows
+//---------------------------------------------------------
+
+quint64 SkewEstimator::score(const quint16* columns, int n, int h, int bytes, int rows, int shift)
+      {
+      _projection.assign(h, 0);
+      qint32* proj = _projection.data();
+      for (int j = 0; j < n; ++j) {
+            int off = lrint(shift * (j * bytes + (bytes - 1) * 0.5) / (_width * rows));
+            const quint16* c = columns + j * h + off;
+            int y1 = qMax(0, -off);
+            int y2 = qMin(h, h - off);
+            // contiguous, vectorized by the compiler
+            for (int y = y1; y < y2; ++y)
+                  proj[y] += c[y];
+            }
+      quint64 sum = 0;
+      for (int y = 0; y < h - 1; ++y) {
+            qint64 delta = proj[y] - proj[y + 1];
+            sum += delta * delta;
+            }
+      return sum;
+      }
+
+//---------------------------------------------------------
+//   SkewLevel
+//    one step of the coarse to fine search: the image is
+//    binned to bytes x rows, shifts are tried in steps of
+//    step rows (per _width bytes) within window of the
+//    candidates of the previous level
+//---------------------------------------------------------
+
+struct SkewLevel {
+      int bytes;
+      int rows;
+      int step;
+      int window;             // 0: all shifts
+      int candidates;         // best shifts passed to the next level
+      };
+
+static const int MAX_CANDIDATES = 2;
+static const SkewLevel skewLevels[] = {
+      { 8, 4, 4, 0, 2 },
+      { 8, 1, 1, 4, 1 },
+      { 1, 1, 1, 2, 1 },
+      };
+
+//---------------------------------------------------------
+//   skew
+//    compute image skew angle of the slice r
+//---------------------------------------------------------
+
+double SkewEstimator::skew(const QImage& image, const QRect& r)
+      {
+      int nn = ((image.bytesPerLine() + 3) / 4) * 4;
+      int h  = r.height();
+      _width = 1;
+      for (; _width < nn; _width <<= 1)
+            ;
+      if (h < 2)
+            return 0.0;
+
+      _counts.resize(nn * h);
+      for (int y = 0; y < h; ++y) {
+            const uchar* p = image.constScanLine(r.y() + y);
+            quint16* d     = &_counts[y];
+            for (int x = 0; x < nn; ++x, d += h)
+                  *d = Omr::bitsSetTable[p[x]];
+            }
+
+      int range = _width - 1;
+      int candidate[MAX_CANDIDATES];
+      int nc = 0;
+      for (const SkewLevel& level : skewLevels) {
+            const quint16* columns = _counts.data();
+            int n  = (nn + level.bytes - 1) / level.bytes;
+            int bh = (h + level.rows - 1) / level.rows;
+            if (level.bytes > 1 || level.rows > 1) {
+                  bin(nn, h, level.bytes, level.rows);
+                  columns = _binned.data();
+                  }
+            int best[MAX_CANDIDATES];
+            quint64 bestScore[MAX_CANDIDATES] = { 0, 0 };
+            for (int s = -(range / level.step) * level.step; s <= range; s += level.step) {
+                  if (nc) {
+                        bool near = false;
+                        for (int i = 0; i < nc; ++i)
+                              near = near || qAbs(s - candidate[i]) < level.window;
+                        if (!near)
+                              continue;
+                        }
+                  quint64 v = score(columns, n, bh, level.bytes, level.rows, s);
+                  for (int i = 0; i < level.candidates; ++i) {
+                        if (v > bestScore[i]) {
+                              for (int k = level.candidates - 1; k > i; --k) {
+                                    best[k]      = best[k-1];
+                                    bestScore[k] = bestScore[k-1];
+                                    }
+                              best[i]      = s;
+                              bestScore[i] = v;
+                              break;
+                              }
+                        }
+                  }
+            nc = 0;
+            for (int i = 0; i < level.candidates; ++i) {
+                  if (bestScore[i])
+                        candidate[nc++] = best[i];
+                  }
+            if (nc == 0)            // empty slice
+                  return 0.0;
+            }
+      return RadiansToDegrees(-atan((double) candidate[0]/_width/8));
+      }
+}
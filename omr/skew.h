@@ -0,0 +1,53 @@
+//=============================================================================
+//  MusE Reader
+//  Music Score Reader
+//
+//  Copyright (C) 2016 Werner Schweer
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License version 2.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+//=============================================================================
+
+#ifndef __SKEW_H__
+#define __SKEW_H__
+
+namespace Ms {
+
+//---------------------------------------------------------
+//   SkewEstimator
+//    skew angle of a slice of a 1-bit page image
+//
+//    Searches the shear which gives the sharpest row
+//    projection, coarse to fine: first on a downsampled
+//    popcount image over all angles, then at full
+//    resolution only near the best candidates. The
+//    scratch buffers are kept between calls, so use one
+//    estimator for all slices of a page.
+//---------------------------------------------------------
+
+class SkewEstimator {
+      std::vector<quint16> _counts;       // black pixels per byte, column major
+      std::vector<quint16> _binned;       // _counts summed over bins
+      std::vector<qint32> _projection;
+      int _width;                         // bytes per line, rounded up to a power of 2
+
+      void bin(int bytesPerLine, int h, int bytes, int rows);
+      quint64 score(const quint16* columns, int n, int h, int bytes, int rows, int shift);
+
+   public:
+      double skew(const QImage& image, const QRect& r);
+      static double radonSkew(const QImage& image, const QRect& r);
+      };
+
+}     // namespace Ms
+#endif
+
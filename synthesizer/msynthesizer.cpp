@@ -16,6 +16,7 @@
 #include "msynthesizer.h"
 #include "synthesizergui.h"
 #include "libmscore/xml.h"
+#include "libmscore/trace.h"
 #include "midipatch.h"
 
 namespace Ms {
@@ -270,10 +271,13 @@ void MasterSynthesizer::process(unsigned n, float* p)
       if (n > MAX_BUFFERSIZE / 2)
             return;
       for (Synthesizer* s : _synthesizer) {
-            if (s->active())
+            if (s->active()) {
+                  TRACE_SPAN_ARG(s->name(), "audio", "frames", n);
                   s->process(n, p, effect1Buffer, effect2Buffer);
+                  }
             }
 
+      TRACE_SPAN_ARG("MasterSynthesizer::effects", "audio", "frames", n);
       if (_effect[0] && _effect[1]) {
             memset(effect1Buffer, 0, n * sizeof(float) * 2);
             _effect[0]->process(n, p, effect1Buffer);